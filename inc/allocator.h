@@ -0,0 +1,115 @@
+#ifndef ALLOCATOR_H
+
+#define ALLOCATOR_H
+
+#include "error.h"
+
+// opaque type for a bump allocator whose allocations are all released at once
+struct arena_t;
+
+// opaque type for an allocator of fixed-size blocks recycled through a free list
+struct pool_t;
+
+/// <summary>
+/// allocates a block of memory from an allocator's state
+/// </summary>
+/// <param name="state">- state of the allocator</param>
+/// <param name="memory">- address of the null memory pointer</param>
+/// <param name="size">- size of the block in bytes</param>
+/// <param name="alignment">- alignment of the block in bytes, a power of two</param>
+/// <returns>ERROR_NONE on success, or the error that stopped the allocation on failure</returns>
+typedef err_t (*allocator_alloc_t)(ptr state, mem* memory, u64 size, u64 alignment);
+
+/// <summary>
+/// frees a block of memory allocated from the same allocator's state
+/// </summary>
+/// <param name="state">- state of the allocator</param>
+/// <param name="memory">- address of the memory pointer, which is nulled</param>
+/// <returns>ERROR_NONE on success, or the error that stopped the free on failure</returns>
+typedef err_t (*allocator_free_t)(ptr state, mem* memory);
+
+/// <summary>an interface that the allocating apis take to decide where their memory comes from</summary>
+typedef struct allocator_t {
+	allocator_alloc_t alloc;
+	allocator_free_t free;
+	ptr state;
+} allocator_t;
+
+/// <summary>
+/// fetches the allocator backed by memory_aligned_alloc, which the apis without an allocator use
+/// </summary>
+/// <returns>address of the system allocator</returns>
+const allocator_t* allocator_system(void);
+
+/// <summary>
+/// allocates a block of memory from an allocator
+/// </summary>
+/// <param name="allocator">- address of the allocator, or null for the system allocator</param>
+/// <param name="memory">- address of the null memory pointer</param>
+/// <param name="size">- size of the block in bytes</param>
+/// <param name="alignment">- alignment of the block in bytes, a power of two</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_NON_POWER_OF_TWO, ERROR_SIZE_MISMATCH, ERROR_MISALIGNED_BUFFER or ERROR_ALLOC_FAIL on failure</returns>
+err_t allocator_alloc(const allocator_t* allocator, mem* memory, u64 size, u64 alignment);
+
+/// <summary>
+/// frees a block of memory allocated from the same allocator
+/// </summary>
+/// <param name="allocator">- address of the allocator, or null for the system allocator</param>
+/// <param name="memory">- address of the memory pointer, which is nulled</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t allocator_free(const allocator_t* allocator, mem* memory);
+
+/// <summary>
+/// creates an arena that bumps a pointer through chunks of memory, chaining another chunk whenever one fills up
+/// </summary>
+/// <param name="arena">- address of the null arena pointer</param>
+/// <param name="capacity">- size of each chunk in bytes, at least 1</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL or ERROR_ALLOC_FAIL on failure</returns>
+err_t arena_create(struct arena_t** arena, u64 capacity);
+
+/// <summary>
+/// fetches the allocator interface of an arena. Frees through it do nothing, the memory is reclaimed by arena_reset. It must only be used by one thread at a time.
+/// </summary>
+/// <param name="arena">- address of the arena</param>
+/// <returns>address of the allocator, valid until the arena is destroyed</returns>
+const allocator_t* arena_allocator(struct arena_t* arena);
+
+/// <summary>
+/// releases every allocation of an arena at once, keeping its chunks for reuse
+/// </summary>
+/// <param name="arena">- address of the arena</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t arena_reset(struct arena_t* arena);
+
+/// <summary>
+/// frees every chunk of an arena
+/// </summary>
+/// <param name="arena">- address of the arena pointer, which is nulled</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t arena_destroy(struct arena_t** arena);
+
+/// <summary>
+/// creates a pool of fixed-size blocks carved out of slabs, adding a slab whenever the free list runs dry
+/// </summary>
+/// <param name="pool">- address of the null pool pointer</param>
+/// <param name="block_size">- largest allocation a block holds in bytes, at least 1</param>
+/// <param name="alignment">- alignment of every block in bytes, a power of two</param>
+/// <param name="blocks">- number of blocks in each slab, at least 1</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_NON_POWER_OF_TWO or ERROR_ALLOC_FAIL on failure</returns>
+err_t pool_create(struct pool_t** pool, u64 block_size, u64 alignment, u64 blocks);
+
+/// <summary>
+/// fetches the allocator interface of a pool. Allocations larger or more aligned than its blocks fail. It must only be used by one thread at a time.
+/// </summary>
+/// <param name="pool">- address of the pool</param>
+/// <returns>address of the allocator, valid until the pool is destroyed</returns>
+const allocator_t* pool_allocator(struct pool_t* pool);
+
+/// <summary>
+/// frees every slab of a pool, including blocks that were never freed
+/// </summary>
+/// <param name="pool">- address of the pool pointer, which is nulled</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t pool_destroy(struct pool_t** pool);
+
+#endif
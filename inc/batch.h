@@ -0,0 +1,65 @@
+#ifndef BATCH_H
+
+#define BATCH_H
+
+#include "error.h"
+
+// bytes of uploads a batch gathers before it flushes by itself
+#define BATCH_CAPACITY (8 * 1024 * 1024)
+
+// opaque type for uploads gathered in memory and sent to the gpu in one transfer
+struct batch_t;
+
+/// <summary>
+/// creates an empty batch
+/// </summary>
+/// <param name="batch">- address of the null batch pointer</param>
+/// <param name="capacity">- bytes gathered before the batch flushes by itself, or 0 for BATCH_CAPACITY</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL or ERROR_ALLOC_FAIL on failure</returns>
+err_t batch_create(struct batch_t** batch, u64 capacity);
+
+/// <summary>
+/// queues bytes to be written into a buffer at the next flush, copying them so the caller may free its own right away; a full batch is flushed first, and bytes larger than the whole batch are written at once
+/// </summary>
+/// <param name="batch">- address of the batch</param>
+/// <param name="buffer">- destination buffer, which must stay alive and large enough until the flush</param>
+/// <param name="offset">- offset in the destination buffer in bytes</param>
+/// <param name="data">- bytes to write</param>
+/// <param name="size">- number of bytes</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_ALLOC_FAIL on failure</returns>
+err_t batch_write(struct batch_t* batch, u32 buffer, u64 offset, cmem data, u64 size);
+
+/// <summary>
+/// creates a buffer with uninitialized storage and queues its contents, so creating many buffers costs a single transfer
+/// </summary>
+/// <param name="batch">- address of the batch</param>
+/// <param name="buffer">- address of the buffer handle</param>
+/// <param name="target">- buffer target, such as GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER</param>
+/// <param name="data">- contents of the buffer</param>
+/// <param name="size">- number of bytes</param>
+/// <param name="mode">- usage of the buffer, GL_STATIC_DRAW, GL_DYNAMIC_DRAW or GL_STREAM_DRAW</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_UNKNOWN_ENUM or ERROR_ALLOC_FAIL on failure</returns>
+err_t batch_buffer_create(struct batch_t* batch, u32* buffer, u32 target, cmem data, u64 size, u32 mode);
+
+/// <summary>
+/// fetches the number of bytes waiting for a flush
+/// </summary>
+/// <param name="batch">- address of the batch</param>
+/// <returns>number of bytes queued, or 0 for a null batch</returns>
+u64 batch_pending(struct batch_t* batch);
+
+/// <summary>
+/// sends every queued byte to a staging buffer in one transfer, then copies them to their buffers on the gpu, one copy per run of contiguous writes; meant for a load or frame boundary
+/// </summary>
+/// <param name="batch">- address of the batch</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t batch_flush(struct batch_t* batch);
+
+/// <summary>
+/// deletes the staging buffer of a batch and frees it, dropping writes not yet flushed
+/// </summary>
+/// <param name="batch">- address of the batch pointer, which is nulled</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t batch_destroy(struct batch_t** batch);
+
+#endif
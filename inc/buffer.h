@@ -3,6 +3,20 @@
 #define BUFFER_H
 
 #include "error.h"
+#include "container.h"
+#include "quantize.h"
+
+struct layout_t;
+
+int buffer_type_valid(u32 type);
+
+#define BUFFER_TYPE_VALID 1
+#define BUFFER_TYPE_INVALID 0
+
+int buffer_draw_mode_valid(u32 mode);
+
+#define DRAW_MODE_VALID 1
+#define DRAW_MODE_INVALID 0
 
 err_t index_buffer_create(u32* buffer, const u8* data, u64 count);
 err_t index_buffer_create_ex(u32* buffer, const u8* data, u64 count, u32 mode);
@@ -13,6 +27,9 @@ err_t color_buffer_create_ex(u32* buffer, const struct color_t* data, u64 count,
 err_t element_buffer_create(u32* buffer, const u32* data, u64 count);
 err_t element_buffer_create_ex(u32* buffer, const u32* data, u64 count, u32 mode);
 
+err_t element_buffer_create_narrow(u32* buffer, u32* index_type, const u32* data, u64 count);
+err_t element_buffer_create_typed(u32* buffer, u32* index_type, cmem data, u64 count, container_type_t type);
+
 err_t vec2_buffer_create(u32* buffer, const struct vec2_t* data, u64 count);
 err_t vec2_buffer_create_ex(u32* buffer, const struct vec2_t* data, u64 count, u32 mode);
 
@@ -22,4 +39,16 @@ err_t vec3_buffer_create_ex(u32* buffer, const struct vec3_t* data, u64 count, u
 err_t vec4_buffer_create(u32* buffer, const struct vec4_t* data, u64 count);
 err_t vec4_buffer_create_ex(u32* buffer, const struct vec4_t* data, u64 count, u32 mode);
 
+err_t quantized_buffer_create(u32* buffer, cmem data, u64 count, u32 components, quantize_format_t format);
+err_t quantized_buffer_create_ex(u32* buffer, cmem data, u64 count, u32 components, quantize_format_t format, u32 mode);
+
+err_t interleaved_buffer_create(u32* buffer, cmem data, u64 count, const struct layout_t* layout);
+err_t interleaved_buffer_create_ex(u32* buffer, cmem data, u64 count, const struct layout_t* layout, u32 mode);
+
+err_t array_buffer_create(u32* buffer, cmem data, u64 count, container_type_t type, u32 components);
+err_t array_buffer_create_ex(u32* buffer, cmem data, u64 count, container_type_t type, u32 components, u32 mode);
+
+err_t quantized_attribute_format(quantize_format_t format, u32* type, u8* normalized);
+err_t quantized_attribute_pointer(u32 index, u32 components, quantize_format_t format, u32 stride, u64 offset);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef COMPRESS_H
+
+#define COMPRESS_H
+
+#include "error.h"
+
+struct workers_t;
+
+// default number of bytes compressed independently of their neighbours
+#define COMPRESS_BLOCK_SIZE (64 * 1024)
+
+// largest block size, keeping every stored block size representable in the 32-bit block table
+#define COMPRESS_BLOCK_SIZE_MAX (16 * 1024 * 1024)
+
+/// <summary>
+/// fetches the largest size a block can compress to, for sizing a destination that can never overflow
+/// </summary>
+/// <param name="size">- size of the uncompressed block in bytes</param>
+/// <returns>worst-case size of the compressed block in bytes</returns>
+u64 compress_bound(u64 size);
+
+/// <summary>
+/// compresses a single block with a greedy lz77 coder in the lz4 block format
+/// </summary>
+/// <param name="dest">- destination of the compressed bytes</param>
+/// <param name="capacity">- size of the destination in bytes</param>
+/// <param name="written">- size of the compressed block, or 0 if it did not fit in the capacity</param>
+/// <param name="src">- uncompressed bytes</param>
+/// <param name="size">- number of uncompressed bytes</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t compress_block(byte* dest, u64 capacity, u64* written, const byte* src, u64 size);
+
+/// <summary>
+/// decompresses a single block, checking every length and offset against both buffers
+/// </summary>
+/// <param name="dest">- destination of the uncompressed bytes</param>
+/// <param name="size">- exact number of uncompressed bytes the block must produce</param>
+/// <param name="src">- compressed bytes</param>
+/// <param name="length">- number of compressed bytes</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_INVALID_CONTAINER on failure</returns>
+err_t decompress_block(byte* dest, u64 size, const byte* src, u64 length);
+
+/// <summary>
+/// fetches the largest size compress_blocks can produce
+/// </summary>
+/// <param name="size">- size of the uncompressed data in bytes</param>
+/// <param name="block_size">- size of each block in bytes</param>
+/// <returns>worst-case size of the block table and blocks in bytes</returns>
+u64 compress_blocks_bound(u64 size, u32 block_size);
+
+/// <summary>
+/// splits data into fixed-size blocks and compresses each on its own, storing blocks that do not shrink verbatim
+/// </summary>
+/// <param name="dest">- destination of at least compress_blocks_bound bytes, receiving a little-endian u32 size per block followed by the blocks</param>
+/// <param name="length">- number of bytes written to the destination</param>
+/// <param name="src">- uncompressed bytes</param>
+/// <param name="size">- number of uncompressed bytes</param>
+/// <param name="block_size">- size of each block in bytes, a nonzero multiple of 64 up to COMPRESS_BLOCK_SIZE_MAX</param>
+/// <param name="workers">- pool the blocks are spread across, or null to compress them on the calling thread</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_SIZE_INDIVISIBLE, ERROR_SIZE_MISMATCH or ERROR_ALLOC_FAIL on failure</returns>
+err_t compress_blocks(byte* dest, u64* length, const byte* src, u64 size, u32 block_size, struct workers_t* workers);
+
+/// <summary>
+/// decompresses the output of compress_blocks straight into its destination
+/// </summary>
+/// <param name="dest">- destination of the uncompressed bytes</param>
+/// <param name="size">- exact number of uncompressed bytes</param>
+/// <param name="src">- block table and blocks</param>
+/// <param name="length">- number of compressed bytes</param>
+/// <param name="block_size">- size of each block in bytes</param>
+/// <param name="workers">- pool the blocks are spread across, or null to decompress them on the calling thread</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_INVALID_CONTAINER or ERROR_ALLOC_FAIL on failure</returns>
+err_t decompress_blocks(byte* dest, u64 size, const byte* src, u64 length, u32 block_size, struct workers_t* workers);
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef CONTAINER_H
+
+#define CONTAINER_H
+
+#include "error.h"
+#include "memory.h"
+
+// identifies serialized data as a container
+#define CONTAINER_MAGIC "RATC"
+
+// current version of the container layout, bumped on every incompatible change; version 2 added compressed payloads
+#define CONTAINER_VERSION 2
+
+// alignment of the payload relative to the start of the container
+#define CONTAINER_ALIGNMENT MEMORY_ALIGNMENT
+
+typedef enum container_type_t {
+	CONTAINER_TYPE_U8 = 1,
+	CONTAINER_TYPE_U16 = 2,
+	CONTAINER_TYPE_U32 = 3,
+	CONTAINER_TYPE_U64 = 4,
+	CONTAINER_TYPE_F32 = 5,
+	CONTAINER_TYPE_F16 = 6,
+	CONTAINER_TYPE_I16 = 7,
+} container_type_t;
+
+typedef enum container_flag_t {
+	CONTAINER_FLAG_NONE = 0,
+	// the payload is a block table followed by independently compressed blocks, see compress_blocks
+	CONTAINER_FLAG_COMPRESSED = 1 << 0,
+	// integer components are normalized, mapping i16 to [-1, 1] and u8 to [0, 1], see quantize_floats
+	CONTAINER_FLAG_NORMALIZED = 1 << 1,
+	// the payload is delta and varint encoded indices, see indices_encode
+	CONTAINER_FLAG_DELTA = 1 << 2,
+	// each element is a vertex of u8 components whose attributes are described by a layout table after the header, see layout_write
+	CONTAINER_FLAG_INTERLEAVED = 1 << 3,
+} container_flag_t;
+
+// every container_flag_t this version understands
+#define CONTAINER_FLAGS_KNOWN (CONTAINER_FLAG_COMPRESSED | CONTAINER_FLAG_NORMALIZED | CONTAINER_FLAG_DELTA | CONTAINER_FLAG_INTERLEAVED)
+
+/// <summary>the 64-byte header preceding the payload of all serialized data</summary>
+typedef struct container_t {
+	// CONTAINER_MAGIC, without a terminator
+	byte magic[4];
+	// CONTAINER_VERSION the container was written with
+	u16 version;
+	// endian_t of every field after this one and of the payload
+	u8 endianness;
+	// container_type_t of each component
+	u8 type;
+	// number of components in an element
+	u32 components;
+	// distance between consecutive elements in bytes
+	u32 stride;
+	// number of elements
+	u64 count;
+	// size of the payload in bytes once decompressed
+	u64 length;
+	// distance from the start of the container to the payload in bytes, a multiple of CONTAINER_ALIGNMENT
+	u64 offset;
+	// bitwise or of container_flag_t
+	u32 flags;
+	// size of each compressed block in bytes, zero when the payload is not compressed
+	u32 block_size;
+	// size of the payload as stored in bytes, equal to length when the payload is not compressed
+	u64 stored;
+	// reserved for later versions, zero
+	byte reserved[8];
+} container_t;
+
+// offset at which serializers place the payload, the header rounded up to CONTAINER_ALIGNMENT
+#define CONTAINER_OFFSET ((sizeof(container_t) + CONTAINER_ALIGNMENT - 1) / CONTAINER_ALIGNMENT * CONTAINER_ALIGNMENT)
+
+/// <summary>
+/// fetches the size in bytes of one component of a container type
+/// </summary>
+/// <param name="type">- type of the component</param>
+/// <returns>size of the component, or 0 for an unknown type</returns>
+u64 container_type_size(container_type_t type);
+
+/// <summary>
+/// initializes a container header for a densely packed little-endian array
+/// </summary>
+/// <param name="header">- address of the header</param>
+/// <param name="type">- type of each component</param>
+/// <param name="components">- number of components in an element</param>
+/// <param name="count">- number of elements</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_UNKNOWN_ENUM on failure</returns>
+err_t container_init(container_t* header, container_type_t type, u32 components, u64 count);
+
+/// <summary>
+/// writes a container header to the start of a buffer in the byte order it records
+/// </summary>
+/// <param name="buffer">- serialized binary data of at least sizeof(container_t) bytes</param>
+/// <param name="header">- address of the header</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t container_write(byte* buffer, const container_t* header);
+
+/// <summary>
+/// reads and validates the container header at the start of a buffer, converting its fields to the system byte order
+/// </summary>
+/// <param name="header">- address of the header</param>
+/// <param name="buffer">- serialized binary data</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_INVALID_CONTAINER on failure</returns>
+err_t container_read(container_t* header, const byte* buffer);
+
+/// <summary>
+/// checks that the payload of a read container header lies within a buffer, so a truncated buffer is rejected before it is read past its end
+/// </summary>
+/// <param name="header">- address of the header, as read by container_read</param>
+/// <param name="length">- size of the buffer holding the container in bytes</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_INVALID_CONTAINER on failure</returns>
+err_t container_validate(const container_t* header, u64 length);
+
+/// <summary>
+/// checks that a container holds elements of the expected type and component count; interleaved containers never match
+/// </summary>
+/// <param name="header">- address of the header</param>
+/// <param name="type">- expected type of each component</param>
+/// <param name="components">- expected number of components in an element</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_INVALID_CONTAINER on failure</returns>
+err_t container_expect(const container_t* header, container_type_t type, u32 components);
+
+/// <summary>
+/// fetches the total size of serialized data as stored from its container header
+/// </summary>
+/// <param name="size">- size of the header, padding and payload in bytes</param>
+/// <param name="buffer">- serialized binary data</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_INVALID_CONTAINER on failure</returns>
+err_t container_size(u64* size, const byte* buffer);
+
+#endif
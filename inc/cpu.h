@@ -0,0 +1,28 @@
+#ifndef CPU_H
+
+#define CPU_H
+
+#include "typedef.h"
+
+typedef enum cpu_feature_t {
+	CPU_FEATURE_NONE = 0,
+	CPU_FEATURE_SSSE3 = 1 << 0,
+	CPU_FEATURE_AVX2 = 1 << 1,
+	CPU_FEATURE_SSE2 = 1 << 2,
+	CPU_FEATURE_F16C = 1 << 3,
+} cpu_feature_t;
+
+/// <summary>
+/// detects the instruction set extensions supported by the current processor and operating system
+/// </summary>
+/// <returns>bitwise or of the supported cpu_feature_t flags</returns>
+u32 cpu_features_detect();
+
+/// <summary>
+/// checks whether the current processor supports every feature in a set
+/// </summary>
+/// <param name="features">- bitwise or of cpu_feature_t flags</param>
+/// <returns>true if all of the features are supported, false otherwise</returns>
+i32 cpu_supports(u32 features);
+
+#endif
@@ -3,62 +3,461 @@
 #define DESERIALIZER_H
 
 #include "error.h"
+#include "container.h"
+#include "quantize.h"
 
 struct vec2_t;
 struct vec3_t;
 struct vec4_t;
 
+struct workers_t;
+struct allocator_t;
+struct layout_t;
+
+// opaque type for a deserializer that streams an array from a file in caller-sized chunks
+struct deserializer_stream_t;
+
+/// <summary>
+/// receives each chunk of elements decoded by deserializer_stream_each
+/// </summary>
+/// <param name="array">The decoded elements, in the system byte order.</param>
+/// <param name="count">The number of elements in the chunk.</param>
+/// <param name="user">The user pointer passed to deserializer_stream_each.</param>
+/// <returns>ERROR_NONE to continue, or any other error to stop streaming and report it</returns>
+typedef err_t (*deserializer_chunk_t)(mem array, u64 count, ptr user);
+
+/// <summary>
+/// Sets the pool that deserializers split large payloads across, in cache-sized ranges. Set it before deserializing from several threads.
+/// </summary>
+/// <param name="workers">The address of the pool, which must outlive its use, or null to deserialize on the calling thread.</param>
+void deserializer_workers_set(struct workers_t* workers);
+
+/// <summary>
+/// Deserializes and validates the container header of a byte buffer.
+/// </summary>
+/// <param name="header">The header, converted to the system byte order.</param>
+/// <param name="buffer">The serialzed binary data.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_INVALID_CONTAINER on failure</returns>
+err_t deserialize_header(container_t* header, const byte* buffer, u64 length);
+
 /// <summary>
 /// Deserializes the size of a byte buffer.
 /// </summary>
 /// <param name="size">The size of the array.</param>
 /// <param name="buffer">The serialzed binary data.</param>
-/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
-err_t deserialize_size(u64* size, const byte* buffer);
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_INVALID_CONTAINER on failure</returns>
+err_t deserialize_size(u64* size, const byte* buffer, u64 length);
+
+/// <summary>
+/// Deserializes the size and data of an array of any container type. Compressed payloads are decompressed and delta encoded indices are decoded.
+/// </summary>
+/// <param name="array">The densely packed array of elements. It must be freed with memory_aligned_free if successful.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <param name="type">The expected type of each component.</param>
+/// <param name="components">The expected number of components in an element.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER or ERROR_ALLOC_FAIL on failure</returns>
+err_t deserialize_array(mem* array, u64* size, const byte* buffer, u64 length, container_type_t type, u32 components);
+
+/// <summary>
+/// Deserializes the size and data of an array of any container type into memory from an allocator, such as an arena for a load phase.
+/// </summary>
+/// <param name="array">The densely packed array of elements. It must be freed with allocator_free on the same allocator if successful.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <param name="type">The expected type of each component.</param>
+/// <param name="components">The expected number of components in an element.</param>
+/// <param name="allocator">The allocator the array comes from, or null for the system allocator.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER or ERROR_ALLOC_FAIL on failure</returns>
+err_t deserialize_array_ex(mem* array, u64* size, const byte* buffer, u64 length, container_type_t type, u32 components, const struct allocator_t* allocator);
+
+/// <summary>
+/// Views the data of a serialized array of any container type in place without allocating or copying. Compressed and delta encoded payloads cannot be viewed.
+/// </summary>
+/// <param name="array">The densely packed array of elements. It points into the buffer and must not be freed.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data. It must outlive the view.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <param name="type">The expected type of each component.</param>
+/// <param name="components">The expected number of components in an element.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER, ERROR_ENDIAN_MISMATCH or ERROR_MISALIGNED_BUFFER on failure</returns>
+err_t deserialize_array_view(cmem* array, u64* size, const byte* buffer, u64 length, container_type_t type, u32 components);
+
+/// <summary>
+/// Converts the data of a serialized array of any container type to the system byte order inside the buffer and returns a pointer to it, without allocating or copying. The header is rewritten to match, so converting again only validates it. Compressed and delta encoded payloads cannot be converted in place.
+/// </summary>
+/// <param name="array">The densely packed array of elements. It points into the buffer and must not be freed.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data, owned by the caller. It must outlive the array.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <param name="type">The expected type of each component.</param>
+/// <param name="components">The expected number of components in an element.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER or ERROR_MISALIGNED_BUFFER on failure</returns>
+err_t deserialize_array_inplace(mem* array, u64* size, byte* buffer, u64 length, container_type_t type, u32 components);
+
+/// <summary>
+/// Deserializes an array of indices at the type it was serialized with, decoding delta encoded indices.
+/// </summary>
+/// <param name="array">The array of indices of the type. It must be freed with memory_aligned_free if successful.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="type">The type of each index, CONTAINER_TYPE_U8, CONTAINER_TYPE_U16 or CONTAINER_TYPE_U32.</param>
+/// <param name="buffer">The serialzed binary data.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER or ERROR_ALLOC_FAIL on failure</returns>
+err_t deserialize_indices(mem* array, u64* size, container_type_t* type, const byte* buffer, u64 length);
+
+/// <summary>
+/// Deserializes an array of indices at the type it was serialized with into memory from an allocator.
+/// </summary>
+/// <param name="array">The array of indices of the type. It must be freed with allocator_free on the same allocator if successful.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="type">The type of each index, CONTAINER_TYPE_U8, CONTAINER_TYPE_U16 or CONTAINER_TYPE_U32.</param>
+/// <param name="buffer">The serialzed binary data.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <param name="allocator">The allocator the array comes from, or null for the system allocator.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER or ERROR_ALLOC_FAIL on failure</returns>
+err_t deserialize_indices_ex(mem* array, u64* size, container_type_t* type, const byte* buffer, u64 length, const struct allocator_t* allocator);
+
+/// <summary>
+/// Deserializes the size and quantized components of an array without expanding them, ready for upload as a normalized or half-float attribute.
+/// </summary>
+/// <param name="array">The densely packed array of quantized components. It must be freed with memory_aligned_free if successful.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <param name="format">The expected quantized format of each component.</param>
+/// <param name="components">The expected number of components in an element.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_UNKNOWN_ENUM, ERROR_INVALID_CONTAINER or ERROR_ALLOC_FAIL on failure</returns>
+err_t deserialize_quantized(mem* array, u64* size, const byte* buffer, u64 length, quantize_format_t format, u32 components);
+
+/// <summary>
+/// Deserializes the size and quantized components of an array without expanding them into memory from an allocator.
+/// </summary>
+/// <param name="array">The densely packed array of quantized components. It must be freed with allocator_free on the same allocator if successful.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <param name="format">The expected quantized format of each component.</param>
+/// <param name="components">The expected number of components in an element.</param>
+/// <param name="allocator">The allocator the array comes from, or null for the system allocator.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_UNKNOWN_ENUM, ERROR_INVALID_CONTAINER or ERROR_ALLOC_FAIL on failure</returns>
+err_t deserialize_quantized_ex(mem* array, u64* size, const byte* buffer, u64 length, quantize_format_t format, u32 components, const struct allocator_t* allocator);
+
+/// <summary>
+/// Converts the quantized components of a serialized array to the system byte order inside the buffer and returns a pointer to them.
+/// </summary>
+/// <param name="array">The densely packed array of quantized components. It points into the buffer and must not be freed.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data, owned by the caller. It must outlive the array.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <param name="format">The expected quantized format of each component.</param>
+/// <param name="components">The expected number of components in an element.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_UNKNOWN_ENUM, ERROR_INVALID_CONTAINER or ERROR_MISALIGNED_BUFFER on failure</returns>
+err_t deserialize_quantized_inplace(mem* array, u64* size, byte* buffer, u64 length, quantize_format_t format, u32 components);
+
+/// <summary>
+/// Views the quantized components of a serialized array in place without allocating or copying.
+/// </summary>
+/// <param name="array">The densely packed array of quantized components. It points into the buffer and must not be freed.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data. It must outlive the view.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <param name="format">The expected quantized format of each component.</param>
+/// <param name="components">The expected number of components in an element.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_UNKNOWN_ENUM, ERROR_INVALID_CONTAINER, ERROR_ENDIAN_MISMATCH or ERROR_MISALIGNED_BUFFER on failure</returns>
+err_t deserialize_quantized_view(cmem* array, u64* size, const byte* buffer, u64 length, quantize_format_t format, u32 components);
 
 /// <summary>
 /// Deserializes the size and data of a float array.
 /// </summary>
-/// <param name="array">The array of floats. It must be freed if successful.</param>
+/// <param name="array">The array of floats. It must be freed with memory_aligned_free if successful.</param>
 /// <param name="size">The size of the array.</param>
 /// <param name="buffer">The serialzed binary data.</param>
-/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_PARAM_NOTNULL on failure</returns>
-err_t deserialize_floats(f32** array, u64* size, const byte* buffer);
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER or ERROR_ALLOC_FAIL on failure</returns>
+err_t deserialize_floats(f32** array, u64* size, const byte* buffer, u64 length);
 
 /// <summary>
 /// Deserializes the size and data of an unsigned 32-bit integer array.
 /// </summary>
-/// <param name="array">The array of unsigned 32-bit integers. It must be freed if successful.</param>
+/// <param name="array">The array of unsigned 32-bit integers. It must be freed with memory_aligned_free if successful.</param>
 /// <param name="size">The size of the array.</param>
 /// <param name="buffer">The serialzed binary data.</param>
-/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_PARAM_NOTNULL on failure</returns>
-err_t deserialize_u32s(u32** array, u64* size, const byte* buffer);
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER or ERROR_ALLOC_FAIL on failure</returns>
+err_t deserialize_u32s(u32** array, u64* size, const byte* buffer, u64 length);
 
 /// <summary>
 /// Deserializes the size and data of a vec2 array.
 /// </summary>
-/// <param name="array">The array of vec2s. It must be freed if successful.</param>
+/// <param name="array">The array of vec2s. It must be freed with memory_aligned_free if successful.</param>
 /// <param name="size">The size of the array.</param>
 /// <param name="buffer">The serialzed binary data.</param>
-/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_PARAM_NOTNULL on failure</returns>
-err_t deserialize_vec2s(struct vec2_t** array, u64* size, const byte* buffer);
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER or ERROR_ALLOC_FAIL on failure</returns>
+err_t deserialize_vec2s(struct vec2_t** array, u64* size, const byte* buffer, u64 length);
 
 /// <summary>
 /// Deserializes the size and data of a vec3 array.
 /// </summary>
-/// <param name="array">The array of vec3s. It must be freed if successful.</param>
+/// <param name="array">The array of vec3s. It must be freed with memory_aligned_free if successful.</param>
 /// <param name="size">The size of the array.</param>
 /// <param name="buffer">The serialzed binary data.</param>
-/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_PARAM_NOTNULL on failure</returns>
-err_t deserialize_vec3s(struct vec3_t** array, u64* size, const byte* buffer);
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER or ERROR_ALLOC_FAIL on failure</returns>
+err_t deserialize_vec3s(struct vec3_t** array, u64* size, const byte* buffer, u64 length);
 
 /// <summary>
 /// Deserializes the size and data of a vec4 array.
 /// </summary>
-/// <param name="array">The array of vec4s. It must be freed if successful.</param>
+/// <param name="array">The array of vec4s. It must be freed with memory_aligned_free if successful.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER or ERROR_ALLOC_FAIL on failure</returns>
+err_t deserialize_vec4s(struct vec4_t** array, u64* size, const byte* buffer, u64 length);
+
+/// <summary>
+/// Deserializes the size and data of a float array into memory from an allocator.
+/// </summary>
+/// <param name="array">The array of floats. It must be freed with allocator_free on the same allocator if successful.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <param name="allocator">The allocator the array comes from, or null for the system allocator.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER or ERROR_ALLOC_FAIL on failure</returns>
+err_t deserialize_floats_ex(f32** array, u64* size, const byte* buffer, u64 length, const struct allocator_t* allocator);
+
+/// <summary>
+/// Deserializes the size and data of an unsigned 32-bit integer array into memory from an allocator.
+/// </summary>
+/// <param name="array">The array of unsigned 32-bit integers. It must be freed with allocator_free on the same allocator if successful.</param>
 /// <param name="size">The size of the array.</param>
 /// <param name="buffer">The serialzed binary data.</param>
-/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_PARAM_NOTNULL on failure</returns>
-err_t deserialize_vec4s(struct vec4_t** array, u64* size, const byte* buffer);
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <param name="allocator">The allocator the array comes from, or null for the system allocator.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER or ERROR_ALLOC_FAIL on failure</returns>
+err_t deserialize_u32s_ex(u32** array, u64* size, const byte* buffer, u64 length, const struct allocator_t* allocator);
+
+/// <summary>
+/// Deserializes the size and data of a vec2 array into memory from an allocator.
+/// </summary>
+/// <param name="array">The array of vec2s. It must be freed with allocator_free on the same allocator if successful.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <param name="allocator">The allocator the array comes from, or null for the system allocator.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER or ERROR_ALLOC_FAIL on failure</returns>
+err_t deserialize_vec2s_ex(struct vec2_t** array, u64* size, const byte* buffer, u64 length, const struct allocator_t* allocator);
+
+/// <summary>
+/// Deserializes the size and data of a vec3 array into memory from an allocator.
+/// </summary>
+/// <param name="array">The array of vec3s. It must be freed with allocator_free on the same allocator if successful.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <param name="allocator">The allocator the array comes from, or null for the system allocator.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER or ERROR_ALLOC_FAIL on failure</returns>
+err_t deserialize_vec3s_ex(struct vec3_t** array, u64* size, const byte* buffer, u64 length, const struct allocator_t* allocator);
+
+/// <summary>
+/// Deserializes the size and data of a vec4 array into memory from an allocator.
+/// </summary>
+/// <param name="array">The array of vec4s. It must be freed with allocator_free on the same allocator if successful.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <param name="allocator">The allocator the array comes from, or null for the system allocator.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER or ERROR_ALLOC_FAIL on failure</returns>
+err_t deserialize_vec4s_ex(struct vec4_t** array, u64* size, const byte* buffer, u64 length, const struct allocator_t* allocator);
+
+/// <summary>
+/// Views the data of a serialized float array in place without allocating or copying.
+/// </summary>
+/// <param name="array">The array of floats. It points into the buffer and must not be freed.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data. It must outlive the view.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER, ERROR_ENDIAN_MISMATCH or ERROR_MISALIGNED_BUFFER on failure</returns>
+err_t deserialize_floats_view(const f32** array, u64* size, const byte* buffer, u64 length);
+
+/// <summary>
+/// Views the data of a serialized unsigned 32-bit integer array in place without allocating or copying.
+/// </summary>
+/// <param name="array">The array of unsigned 32-bit integers. It points into the buffer and must not be freed.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data. It must outlive the view.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER, ERROR_ENDIAN_MISMATCH or ERROR_MISALIGNED_BUFFER on failure</returns>
+err_t deserialize_u32s_view(const u32** array, u64* size, const byte* buffer, u64 length);
+
+/// <summary>
+/// Views the data of a serialized vec2 array in place without allocating or copying.
+/// </summary>
+/// <param name="array">The array of vec2s. It points into the buffer and must not be freed.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data. It must outlive the view.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER, ERROR_ENDIAN_MISMATCH or ERROR_MISALIGNED_BUFFER on failure</returns>
+err_t deserialize_vec2s_view(const struct vec2_t** array, u64* size, const byte* buffer, u64 length);
+
+/// <summary>
+/// Views the data of a serialized vec3 array in place without allocating or copying.
+/// </summary>
+/// <param name="array">The array of vec3s. It points into the buffer and must not be freed.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data. It must outlive the view.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER, ERROR_ENDIAN_MISMATCH or ERROR_MISALIGNED_BUFFER on failure</returns>
+err_t deserialize_vec3s_view(const struct vec3_t** array, u64* size, const byte* buffer, u64 length);
+
+/// <summary>
+/// Views the data of a serialized vec4 array in place without allocating or copying.
+/// </summary>
+/// <param name="array">The array of vec4s. It points into the buffer and must not be freed.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data. It must outlive the view.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER, ERROR_ENDIAN_MISMATCH or ERROR_MISALIGNED_BUFFER on failure</returns>
+err_t deserialize_vec4s_view(const struct vec4_t** array, u64* size, const byte* buffer, u64 length);
+
+/// <summary>
+/// Deserializes the layout and vertices of an interleaved array, ready to upload as one buffer and bind with layout_apply. Compressed payloads are decompressed.
+/// </summary>
+/// <param name="array">The interleaved vertices. It must be freed with memory_aligned_free if successful.</param>
+/// <param name="size">The number of vertices.</param>
+/// <param name="layout">The layout of each vertex.</param>
+/// <param name="buffer">The serialzed binary data.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER, ERROR_INVALID_LAYOUT or ERROR_ALLOC_FAIL on failure</returns>
+err_t deserialize_interleaved(mem* array, u64* size, struct layout_t* layout, const byte* buffer, u64 length);
+
+/// <summary>
+/// Deserializes the layout and vertices of an interleaved array into memory from an allocator.
+/// </summary>
+/// <param name="array">The interleaved vertices. It must be freed with allocator_free on the same allocator if successful.</param>
+/// <param name="size">The number of vertices.</param>
+/// <param name="layout">The layout of each vertex.</param>
+/// <param name="buffer">The serialzed binary data.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <param name="allocator">The allocator the array comes from, or null for the system allocator.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER, ERROR_INVALID_LAYOUT or ERROR_ALLOC_FAIL on failure</returns>
+err_t deserialize_interleaved_ex(mem* array, u64* size, struct layout_t* layout, const byte* buffer, u64 length, const struct allocator_t* allocator);
+
+/// <summary>
+/// Views the layout and vertices of an interleaved array in place without allocating or copying. Compressed payloads cannot be viewed.
+/// </summary>
+/// <param name="array">The interleaved vertices. It points into the buffer and must not be freed.</param>
+/// <param name="size">The number of vertices.</param>
+/// <param name="layout">The layout of each vertex.</param>
+/// <param name="buffer">The serialzed binary data. It must outlive the view.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER, ERROR_INVALID_LAYOUT, ERROR_ENDIAN_MISMATCH or ERROR_MISALIGNED_BUFFER on failure</returns>
+err_t deserialize_interleaved_view(cmem* array, u64* size, struct layout_t* layout, const byte* buffer, u64 length);
+
+/// <summary>
+/// Converts the layout and vertices of an interleaved array to the system byte order inside the buffer and returns a pointer to the vertices.
+/// </summary>
+/// <param name="array">The interleaved vertices. It points into the buffer and must not be freed.</param>
+/// <param name="size">The number of vertices.</param>
+/// <param name="layout">The layout of each vertex.</param>
+/// <param name="buffer">The serialzed binary data, owned by the caller. It must outlive the array.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER, ERROR_INVALID_LAYOUT or ERROR_MISALIGNED_BUFFER on failure</returns>
+err_t deserialize_interleaved_inplace(mem* array, u64* size, struct layout_t* layout, byte* buffer, u64 length);
+
+/// <summary>
+/// Converts the data of a serialized float array to the system byte order inside the buffer and returns a pointer to it.
+/// </summary>
+/// <param name="array">The array of floats. It points into the buffer and must not be freed.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data, owned by the caller. It must outlive the array.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER or ERROR_MISALIGNED_BUFFER on failure</returns>
+err_t deserialize_floats_inplace(f32** array, u64* size, byte* buffer, u64 length);
+
+/// <summary>
+/// Converts the data of a serialized unsigned 32-bit integer array to the system byte order inside the buffer and returns a pointer to it.
+/// </summary>
+/// <param name="array">The array of unsigned 32-bit integers. It points into the buffer and must not be freed.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data, owned by the caller. It must outlive the array.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER or ERROR_MISALIGNED_BUFFER on failure</returns>
+err_t deserialize_u32s_inplace(u32** array, u64* size, byte* buffer, u64 length);
+
+/// <summary>
+/// Converts the data of a serialized vec2 array to the system byte order inside the buffer and returns a pointer to it.
+/// </summary>
+/// <param name="array">The array of vec2s. It points into the buffer and must not be freed.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data, owned by the caller. It must outlive the array.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER or ERROR_MISALIGNED_BUFFER on failure</returns>
+err_t deserialize_vec2s_inplace(struct vec2_t** array, u64* size, byte* buffer, u64 length);
+
+/// <summary>
+/// Converts the data of a serialized vec3 array to the system byte order inside the buffer and returns a pointer to it.
+/// </summary>
+/// <param name="array">The array of vec3s. It points into the buffer and must not be freed.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data, owned by the caller. It must outlive the array.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER or ERROR_MISALIGNED_BUFFER on failure</returns>
+err_t deserialize_vec3s_inplace(struct vec3_t** array, u64* size, byte* buffer, u64 length);
+
+/// <summary>
+/// Converts the data of a serialized vec4 array to the system byte order inside the buffer and returns a pointer to it.
+/// </summary>
+/// <param name="array">The array of vec4s. It points into the buffer and must not be freed.</param>
+/// <param name="size">The size of the array.</param>
+/// <param name="buffer">The serialzed binary data, owned by the caller. It must outlive the array.</param>
+/// <param name="length">The size of the buffer in bytes, which must hold the whole container.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_INVALID_CONTAINER or ERROR_MISALIGNED_BUFFER on failure</returns>
+err_t deserialize_vec4s_inplace(struct vec4_t** array, u64* size, byte* buffer, u64 length);
+
+/// <summary>
+/// Opens a serialized file and validates its container header without reading the payload. Compressed and delta encoded payloads are rejected.
+/// </summary>
+/// <param name="stream">The address of the null stream pointer.</param>
+/// <param name="path">The path of the file.</param>
+/// <param name="type">The expected type of each component.</param>
+/// <param name="components">The expected number of components in an element.</param>
+/// <param name="size">The size of the whole array.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_ALLOC_FAIL, ERROR_UNOPENABLE_FILE, ERROR_SIZE_MISMATCH or ERROR_INVALID_CONTAINER on failure</returns>
+err_t deserializer_stream_open(struct deserializer_stream_t** stream, cstr path, container_type_t type, u32 components, u64* size);
+
+/// <summary>
+/// Reads and decodes the next elements of a stream into a caller-provided array.
+/// </summary>
+/// <param name="stream">The address of the stream.</param>
+/// <param name="array">The array that receives the elements in the system byte order.</param>
+/// <param name="capacity">The number of elements the array can hold.</param>
+/// <param name="count">The number of elements read, which is 0 once the stream is exhausted.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_SIZE_MISMATCH on failure</returns>
+err_t deserializer_stream_read(struct deserializer_stream_t* stream, mem array, u64 capacity, u64* count);
+
+/// <summary>
+/// Reads the rest of a stream through a caller-provided array, handing each decoded chunk to a callback.
+/// </summary>
+/// <param name="stream">The address of the stream.</param>
+/// <param name="array">The array that receives each chunk, reused between chunks.</param>
+/// <param name="capacity">The number of elements the array can hold.</param>
+/// <param name="callback">The function called with every chunk.</param>
+/// <param name="user">The user pointer passed through to the callback.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_SIZE_MISMATCH or the first error returned by the callback on failure</returns>
+err_t deserializer_stream_each(struct deserializer_stream_t* stream, mem array, u64 capacity, deserializer_chunk_t callback, ptr user);
+
+/// <summary>
+/// Closes a stream opened by deserializer_stream_open.
+/// </summary>
+/// <param name="stream">The address of the stream pointer, which is nulled.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_UNCLOSEABLE_FILE on failure</returns>
+err_t deserializer_stream_close(struct deserializer_stream_t** stream);
 
 #endif
@@ -9,12 +9,107 @@ typedef enum endian_t {
 	ENDIAN_BIGLY = 1
 } endian_t;
 
+typedef enum endian_simd_t {
+	ENDIAN_SIMD_SCALAR = 0,
+	ENDIAN_SIMD_SSSE3 = 1,
+	ENDIAN_SIMD_AVX2 = 2
+} endian_simd_t;
+
 /// <summary>
 /// detects the endianness of the current system
 /// </summary>
 /// <returns>ENDIAN_LITTLE or ENDIAN_BIGLY</returns>
 endian_t endianness_detect();
 
+/// <summary>
+/// forces endianness_detect to report an endianness, which exercises the byte-swapped paths on little-endian systems
+/// </summary>
+/// <param name="endianness">- endianness to report</param>
+void endianness_force(endian_t endianness);
+
+/// <summary>
+/// restores endianness_detect to reporting the endianness of the current system
+/// </summary>
+void endianness_unforce();
+
+/// <summary>
+/// fetches the instruction set used by the array byte-swap kernels
+/// </summary>
+/// <returns>the best supported endian_simd_t, or the forced one</returns>
+endian_simd_t endian_simd_detect();
+
+/// <summary>
+/// forces the array byte-swap kernels onto an instruction set, clamped to what the current processor supports
+/// </summary>
+/// <param name="simd">- instruction set to use</param>
+/// <returns>the instruction set that will actually be used</returns>
+endian_simd_t endian_simd_force(endian_simd_t simd);
+
 mem memcpy_inv(mem dest, cmem src, u64 len);
 
+/// <summary>
+/// reverses the byte order of each element of an array of 1, 2, 4 or 8 byte elements
+/// </summary>
+/// <param name="dest">- destination of the swapped elements, which may be the source itself</param>
+/// <param name="src">- source elements</param>
+/// <param name="width">- size of an element in bytes</param>
+/// <param name="count">- number of elements</param>
+void endian_swap_array(mem dest, cmem src, u64 width, u64 count);
+
+/// <summary>
+/// reverses the byte order of each element of an array of unsigned 16-bit integers
+/// </summary>
+/// <param name="dest">- destination of the swapped elements, which may be the source itself</param>
+/// <param name="src">- source elements</param>
+/// <param name="count">- number of elements</param>
+void endian_swap_u16s(mem dest, cmem src, u64 count);
+
+/// <summary>
+/// reverses the byte order of each element of an array of unsigned 32-bit integers
+/// </summary>
+/// <param name="dest">- destination of the swapped elements, which may be the source itself</param>
+/// <param name="src">- source elements</param>
+/// <param name="count">- number of elements</param>
+void endian_swap_u32s(mem dest, cmem src, u64 count);
+
+/// <summary>
+/// reverses the byte order of each element of an array of unsigned 64-bit integers
+/// </summary>
+/// <param name="dest">- destination of the swapped elements, which may be the source itself</param>
+/// <param name="src">- source elements</param>
+/// <param name="count">- number of elements</param>
+void endian_swap_u64s(mem dest, cmem src, u64 count);
+
+/// <summary>
+/// reverses the byte order of each element of an array of floats
+/// </summary>
+/// <param name="dest">- destination of the swapped elements, which may be the source itself</param>
+/// <param name="src">- source elements</param>
+/// <param name="count">- number of elements</param>
+void endian_swap_f32s(mem dest, cmem src, u64 count);
+
+/// <summary>
+/// reverses the byte order of each component of an array of vec2s
+/// </summary>
+/// <param name="dest">- destination of the swapped elements, which may be the source itself</param>
+/// <param name="src">- source elements</param>
+/// <param name="count">- number of vec2s</param>
+void endian_swap_vec2s(mem dest, cmem src, u64 count);
+
+/// <summary>
+/// reverses the byte order of each component of an array of vec3s
+/// </summary>
+/// <param name="dest">- destination of the swapped elements, which may be the source itself</param>
+/// <param name="src">- source elements</param>
+/// <param name="count">- number of vec3s</param>
+void endian_swap_vec3s(mem dest, cmem src, u64 count);
+
+/// <summary>
+/// reverses the byte order of each component of an array of vec4s
+/// </summary>
+/// <param name="dest">- destination of the swapped elements, which may be the source itself</param>
+/// <param name="src">- source elements</param>
+/// <param name="count">- number of vec4s</param>
+void endian_swap_vec4s(mem dest, cmem src, u64 count);
+
 #endif
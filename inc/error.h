@@ -22,6 +22,17 @@ typedef enum err_t {
 	ERROR_UNKNOWN_ENUM,
 	ERROR_SHADER_COMPIL_FAIL,
 	ERROR_SHADER_LINK_FAIL,
+	ERROR_ENDIAN_MISMATCH,
+	ERROR_MISALIGNED_BUFFER,
+	ERROR_UNMAPPABLE_FILE,
+	ERROR_INVALID_CONTAINER,
+	ERROR_MISSING_ENTRY,
+	ERROR_THREAD_FAIL,
+	ERROR_INVALID_LAYOUT,
+	ERROR_UNWRITABLE_FILE,
+	ERROR_QUEUE_FULL,
+	ERROR_INVALID_MANIFEST,
+	ERROR_UNMAPPABLE_BUFFER,
 } err_t;
 
 /// <summary>
@@ -180,4 +191,105 @@ err_t error_shader_compil_fail(str message, cstr file, i32 line);
 /// <returns>ERROR_SHADER_LINK_FAIL</returns>
 err_t error_shader_link_fail(str message, cstr file, i32 line);
 
+/// <summary>
+/// logs and returns an error when serialized data cannot be viewed because its byte order differs from the system
+/// </summary>
+/// <param name="name">name of the serialized data</param>
+/// <param name="file">file in which this error occured</param>
+/// <param name="line">line at which this error occured</param>
+/// <returns>ERROR_ENDIAN_MISMATCH</returns>
+err_t error_endian_mismatch(cstr name, cstr file, i32 line);
+
+/// <summary>
+/// logs and returns an error when a buffer is not aligned for the type it is viewed as
+/// </summary>
+/// <param name="name">name of the misaligned buffer</param>
+/// <param name="alignment">required alignment in bytes</param>
+/// <param name="file">file in which this error occured</param>
+/// <param name="line">line at which this error occured</param>
+/// <returns>ERROR_MISALIGNED_BUFFER</returns>
+err_t error_misaligned_buffer(cstr name, u64 alignment, cstr file, i32 line);
+
+/// <summary>
+/// logs and returns an error for a file that cannot be mapped into memory
+/// </summary>
+/// <param name="path">path of the file</param>
+/// <param name="file">file in which this error occured</param>
+/// <param name="line">line at which this error occured</param>
+/// <returns>ERROR_UNMAPPABLE_FILE</returns>
+err_t error_unmappable_file(cstr path, cstr file, i32 line);
+
+/// <summary>
+/// logs and returns an error when serialized data does not hold a valid container
+/// </summary>
+/// <param name="reason">reason the container was rejected</param>
+/// <param name="file">file in which this error occured</param>
+/// <param name="line">line at which this error occured</param>
+/// <returns>ERROR_INVALID_CONTAINER</returns>
+err_t error_invalid_container(cstr reason, cstr file, i32 line);
+
+/// <summary>
+/// logs and returns an error when a named entry cannot be found
+/// </summary>
+/// <param name="name">name of the missing entry</param>
+/// <param name="file">file in which this error occured</param>
+/// <param name="line">line at which this error occured</param>
+/// <returns>ERROR_MISSING_ENTRY</returns>
+err_t error_missing_entry(cstr name, cstr file, i32 line);
+
+/// <summary>
+/// logs and returns an error when a thread or synchronization object cannot be created, or a thread cannot be joined
+/// </summary>
+/// <param name="operation">description of the operation that failed</param>
+/// <param name="file">file in which this error occured</param>
+/// <param name="line">line at which this error occured</param>
+/// <returns>ERROR_THREAD_FAIL</returns>
+err_t error_thread_fail(cstr operation, cstr file, i32 line);
+
+/// <summary>
+/// logs and returns an error when a vertex layout cannot describe the attributes asked of it
+/// </summary>
+/// <param name="reason">reason the layout was rejected</param>
+/// <param name="file">file in which this error occured</param>
+/// <param name="line">line at which this error occured</param>
+/// <returns>ERROR_INVALID_LAYOUT</returns>
+err_t error_invalid_layout(cstr reason, cstr file, i32 line);
+
+/// <summary>
+/// logs and returns an error when a file cannot be written in full
+/// </summary>
+/// <param name="path">path of the file</param>
+/// <param name="file">file in which this error occured</param>
+/// <param name="line">line at which this error occured</param>
+/// <returns>ERROR_UNWRITABLE_FILE</returns>
+err_t error_unwritable_file(cstr path, cstr file, i32 line);
+
+/// <summary>
+/// logs and returns an error when a bounded queue has no room left for another entry
+/// </summary>
+/// <param name="name">name of the queue</param>
+/// <param name="file">file in which this error occured</param>
+/// <param name="line">line at which this error occured</param>
+/// <returns>ERROR_QUEUE_FULL</returns>
+err_t error_queue_full(cstr name, cstr file, i32 line);
+
+/// <summary>
+/// logs and returns an error when a line of an asset manifest cannot be understood
+/// </summary>
+/// <param name="path">path of the manifest</param>
+/// <param name="number">number of the offending line, starting at 1</param>
+/// <param name="file">file in which this error occured</param>
+/// <param name="line">line at which this error occured</param>
+/// <returns>ERROR_INVALID_MANIFEST</returns>
+err_t error_invalid_manifest(cstr path, u32 number, cstr file, i32 line);
+
+/// <summary>
+/// logs and returns an error when a buffer object cannot be mapped into memory
+/// </summary>
+/// <param name="name">name of the buffer</param>
+/// <param name="file">file in which this error occured</param>
+/// <param name="line">line at which this error occured</param>
+/// <returns>ERROR_UNMAPPABLE_BUFFER</returns>
+err_t error_unmappable_buffer(cstr name, cstr file, i32 line);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,96 @@
+#ifndef HEAP_H
+
+#define HEAP_H
+
+#include "error.h"
+
+// bytes of each buffer object a heap reserves, rounded up to a power of two
+#define HEAP_BLOCK_SIZE (16 * 1024 * 1024)
+
+// smallest range a heap hands out, so every offset is a multiple of it before any stride is applied
+#define HEAP_MIN_SIZE 256
+
+// number of power of two range sizes a block can be split into, enough for any 64 bit size
+#define HEAP_ORDERS 64
+
+/// <summary>where an allocation currently lives, valid until the next heap_defragment</summary>
+typedef struct heap_range_t {
+	u32 buffer;
+	// offset in bytes from the start of the buffer, a multiple of the stride of the allocation
+	u64 offset;
+	u64 size;
+} heap_range_t;
+
+// opaque type for buffer objects shared by many small allocations, split by a buddy allocator
+struct heap_t;
+
+/// <summary>
+/// creates an empty heap, which reserves buffer objects as its allocations need them
+/// </summary>
+/// <param name="heap">- address of the null heap pointer</param>
+/// <param name="target">- buffer target of the heap, such as GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER</param>
+/// <param name="block_size">- bytes of each buffer object, or 0 for HEAP_BLOCK_SIZE</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL or ERROR_ALLOC_FAIL on failure</returns>
+err_t heap_create(struct heap_t** heap, u32 target, u64 block_size);
+
+/// <summary>
+/// allocates a range out of the heap, reserving another buffer object if none has room
+/// </summary>
+/// <param name="heap">- address of the heap</param>
+/// <param name="size">- number of bytes</param>
+/// <param name="stride">- size of a vertex or index the offset must be a multiple of, so it divides into a base vertex or first index, or 0 for none</param>
+/// <param name="id">- address of the id of the allocation, never 0, which stays valid until heap_free</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_SIZE_MISMATCH when larger than a block or ERROR_ALLOC_FAIL on failure</returns>
+err_t heap_alloc(struct heap_t* heap, u64 size, u32 stride, u32* id);
+
+/// <summary>
+/// fetches where an allocation lives; it moves when the heap is defragmented, so it should be fetched again afterwards
+/// </summary>
+/// <param name="heap">- address of the heap</param>
+/// <param name="id">- id of the allocation</param>
+/// <param name="range">- address of the range</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_MISSING_ENTRY on failure</returns>
+err_t heap_fetch(struct heap_t* heap, u32 id, heap_range_t* range);
+
+/// <summary>
+/// writes data to the start of an allocation
+/// </summary>
+/// <param name="heap">- address of the heap</param>
+/// <param name="id">- id of the allocation</param>
+/// <param name="data">- bytes to write</param>
+/// <param name="size">- number of bytes, at most the size of the allocation</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_MISSING_ENTRY or ERROR_SIZE_MISMATCH on failure</returns>
+err_t heap_upload(struct heap_t* heap, u32 id, cmem data, u64 size);
+
+/// <summary>
+/// returns an allocation to the heap, merging it with its free buddies
+/// </summary>
+/// <param name="heap">- address of the heap</param>
+/// <param name="id">- id of the allocation</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_MISSING_ENTRY on failure</returns>
+err_t heap_free(struct heap_t* heap, u32 id);
+
+/// <summary>
+/// fetches the bytes handed out and the bytes reserved in buffer objects, to decide when to defragment
+/// </summary>
+/// <param name="heap">- address of the heap</param>
+/// <param name="used">- address of the bytes of every allocation, rounded to their buddy sizes</param>
+/// <param name="reserved">- address of the bytes of every buffer object</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t heap_usage(struct heap_t* heap, u64* used, u64* reserved);
+
+/// <summary>
+/// packs every allocation into as few buffer objects as possible, largest first, copying their contents on the gpu and deleting the old buffer objects; ids stay valid but their ranges change
+/// </summary>
+/// <param name="heap">- address of the heap</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_ALLOC_FAIL on failure, leaving the heap as it was</returns>
+err_t heap_defragment(struct heap_t* heap);
+
+/// <summary>
+/// deletes every buffer object of the heap and frees it
+/// </summary>
+/// <param name="heap">- address of the heap pointer, which is nulled</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t heap_destroy(struct heap_t** heap);
+
+#endif
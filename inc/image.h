@@ -4,6 +4,8 @@
 
 #include "error.h"
 
+struct allocator_t;
+
 /// <summary>
 /// load an opengl texture
 /// </summary>
@@ -20,6 +22,28 @@ err_t image_load(u32* handle, cstr path);
 /// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, or ERROR_IMAGE_LOAD on failure</returns>
 err_t image_reload(u32* handle, cstr path);
 
+/// <summary>
+/// decode an encoded image in memory into rgba pixels, bottom row first as opengl expects; safe to call from any thread
+/// </summary>
+/// <param name="pixels">address of the null pixels. They must be freed with allocator_free on the same allocator if successful.</param>
+/// <param name="width">address of the width in pixels</param>
+/// <param name="height">address of the height in pixels</param>
+/// <param name="data">encoded image, such as the contents of a png file</param>
+/// <param name="size">size of the encoded image in bytes</param>
+/// <param name="allocator">allocator the pixels come from, or null for the system allocator</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_IMAGE_LOAD, ERROR_SIZE_MISMATCH or ERROR_ALLOC_FAIL on failure</returns>
+err_t image_decode(byte** pixels, i32* width, i32* height, const byte* data, u64 size, const struct allocator_t* allocator);
+
+/// <summary>
+/// create an opengl texture from decoded rgba pixels
+/// </summary>
+/// <param name="handle">address of the opengl handle</param>
+/// <param name="pixels">rgba pixels, bottom row first</param>
+/// <param name="width">width in pixels</param>
+/// <param name="height">height in pixels</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_NON_POWER_OF_TWO on failure</returns>
+err_t image_create(u32* handle, const byte* pixels, i32 width, i32 height);
+
 /// <summary>
 /// free the resources of an image
 /// </summary>
@@ -0,0 +1,75 @@
+#ifndef INDICES_H
+
+#define INDICES_H
+
+#include "error.h"
+#include "container.h"
+
+// largest size of one delta-encoded index, a 32-bit varint
+#define INDICES_VARINT_MAX 5
+
+typedef enum indices_encoding_t {
+	// indices are stored at the narrowest width that holds the largest of them
+	INDICES_ENCODING_NARROW = 0,
+	// the difference from the previous index is zigzag and varint encoded, so the small steps of a triangle list take a byte each
+	INDICES_ENCODING_DELTA = 1,
+} indices_encoding_t;
+
+/// <summary>
+/// fetches the largest index of an array
+/// </summary>
+/// <param name="indices">- array of indices</param>
+/// <param name="count">- number of indices</param>
+/// <returns>largest index, or 0 for an empty array</returns>
+u32 indices_max(const u32* indices, u64 count);
+
+/// <summary>
+/// fetches the narrowest container type that can hold every index of an array
+/// </summary>
+/// <param name="indices">- array of indices</param>
+/// <param name="count">- number of indices</param>
+/// <returns>CONTAINER_TYPE_U8, CONTAINER_TYPE_U16 or CONTAINER_TYPE_U32</returns>
+container_type_t indices_narrowest(const u32* indices, u64 count);
+
+/// <summary>
+/// converts 32-bit indices to a narrower type
+/// </summary>
+/// <param name="dest">- destination of count indices of the type</param>
+/// <param name="src">- array of 32-bit indices</param>
+/// <param name="count">- number of indices</param>
+/// <param name="type">- CONTAINER_TYPE_U8, CONTAINER_TYPE_U16 or CONTAINER_TYPE_U32</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_UNKNOWN_ENUM or ERROR_SIZE_MISMATCH if an index does not fit on failure</returns>
+err_t indices_narrow(mem dest, const u32* src, u64 count, container_type_t type);
+
+/// <summary>
+/// converts indices of a narrower type back to 32 bits
+/// </summary>
+/// <param name="dest">- destination of count 32-bit indices</param>
+/// <param name="src">- array of indices of the type</param>
+/// <param name="count">- number of indices</param>
+/// <param name="type">- CONTAINER_TYPE_U8, CONTAINER_TYPE_U16 or CONTAINER_TYPE_U32</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_UNKNOWN_ENUM on failure</returns>
+err_t indices_widen(u32* dest, cmem src, u64 count, container_type_t type);
+
+/// <summary>
+/// delta and varint encodes an array of indices
+/// </summary>
+/// <param name="dest">- destination of at least count * INDICES_VARINT_MAX bytes</param>
+/// <param name="length">- number of bytes written</param>
+/// <param name="src">- array of 32-bit indices</param>
+/// <param name="count">- number of indices</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t indices_encode(byte* dest, u64* length, const u32* src, u64 count);
+
+/// <summary>
+/// decodes delta and varint encoded indices straight into the type they are drawn with
+/// </summary>
+/// <param name="dest">- destination of count indices of the type</param>
+/// <param name="count">- number of indices</param>
+/// <param name="type">- CONTAINER_TYPE_U8, CONTAINER_TYPE_U16 or CONTAINER_TYPE_U32</param>
+/// <param name="src">- encoded bytes</param>
+/// <param name="length">- number of encoded bytes, all of which must be consumed</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_UNKNOWN_ENUM or ERROR_INVALID_CONTAINER on failure</returns>
+err_t indices_decode(mem dest, u64 count, container_type_t type, const byte* src, u64 length);
+
+#endif
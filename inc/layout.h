@@ -0,0 +1,127 @@
+#ifndef LAYOUT_H
+
+#define LAYOUT_H
+
+#include "error.h"
+#include "container.h"
+#include "quantize.h"
+
+// most attributes a layout can interleave, the minimum number of vertex attributes opengl guarantees
+#define LAYOUT_ATTRIBUTES_MAX 16
+
+// alignment of every attribute offset and of the stride, which vertex fetch handles fastest
+#define LAYOUT_ALIGNMENT 4
+
+// size in bytes of a serialized layout table, a u32 count and stride followed by one 16-byte record per attribute
+#define LAYOUT_TABLE_SIZE(count) (8 + 16 * (u64)(count))
+
+/// <summary>one attribute of an interleaved vertex</summary>
+typedef struct layout_attribute_t {
+	// shader location the attribute is bound to
+	u32 index;
+	// container_type_t of each component
+	container_type_t type;
+	// number of components, 1 to 4
+	u32 components;
+	// distance from the start of the vertex to the attribute in bytes
+	u32 offset;
+	// true when integer components are mapped to [0, 1] or [-1, 1] as they are fetched
+	i32 normalized;
+} layout_attribute_t;
+
+/// <summary>the attributes of an interleaved vertex and the distance between vertices</summary>
+typedef struct layout_t {
+	layout_attribute_t attributes[LAYOUT_ATTRIBUTES_MAX];
+	u32 count;
+	u32 stride;
+} layout_t;
+
+/// <summary>
+/// initializes an empty layout
+/// </summary>
+/// <param name="layout">- address of the layout</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t layout_init(layout_t* layout);
+
+/// <summary>
+/// checks every attribute of a layout against its stride and that no two share a shader location
+/// </summary>
+/// <param name="layout">- address of the layout</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_INVALID_LAYOUT on failure</returns>
+err_t layout_validate(const layout_t* layout);
+
+/// <summary>
+/// appends an attribute to a layout at the next aligned offset, growing the stride to fit it
+/// </summary>
+/// <param name="layout">- address of the layout</param>
+/// <param name="index">- shader location of the attribute</param>
+/// <param name="type">- type of each component, any container type but CONTAINER_TYPE_U64</param>
+/// <param name="components">- number of components, 1 to 4</param>
+/// <param name="normalized">- true to map integer components to [0, 1] or [-1, 1] as they are fetched</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_INVALID_LAYOUT on failure</returns>
+err_t layout_add(layout_t* layout, u32 index, container_type_t type, u32 components, i32 normalized);
+
+/// <summary>
+/// appends an attribute holding components of a quantized format, see quantize_floats
+/// </summary>
+/// <param name="layout">- address of the layout</param>
+/// <param name="index">- shader location of the attribute</param>
+/// <param name="format">- quantized format of each component</param>
+/// <param name="components">- number of components, 1 to 4</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_UNKNOWN_ENUM or ERROR_INVALID_LAYOUT on failure</returns>
+err_t layout_add_quantized(layout_t* layout, u32 index, quantize_format_t format, u32 components);
+
+/// <summary>
+/// writes a layout table in a byte order
+/// </summary>
+/// <param name="table">- destination of LAYOUT_TABLE_SIZE(layout->count) bytes</param>
+/// <param name="layout">- address of the layout</param>
+/// <param name="endianness">- endian_t the table is written in</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t layout_write(byte* table, const layout_t* layout, u8 endianness);
+
+/// <summary>
+/// reads and validates a layout table written in a byte order
+/// </summary>
+/// <param name="layout">- address of the layout</param>
+/// <param name="table">- serialized layout table</param>
+/// <param name="length">- number of bytes the table may span</param>
+/// <param name="endianness">- endian_t the table was written in</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_INVALID_LAYOUT on failure</returns>
+err_t layout_read(layout_t* layout, const byte* table, u64 length, u8 endianness);
+
+/// <summary>
+/// interleaves one densely packed source array per attribute into vertices, zeroing the padding between attributes
+/// </summary>
+/// <param name="dest">- destination of count vertices of layout->stride bytes</param>
+/// <param name="layout">- address of the layout</param>
+/// <param name="arrays">- one array of count elements per attribute, in the order of the layout</param>
+/// <param name="count">- number of vertices</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t layout_interleave(mem dest, const layout_t* layout, const cmem* arrays, u64 count);
+
+/// <summary>
+/// reverses the byte order of every component of interleaved vertices in place
+/// </summary>
+/// <param name="vertices">- interleaved vertices</param>
+/// <param name="layout">- address of the layout</param>
+/// <param name="count">- number of vertices</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t layout_swap(mem vertices, const layout_t* layout, u64 count);
+
+/// <summary>
+/// points and enables the vertex attributes of a layout on the bound vertex array, reading from the bound array buffer
+/// </summary>
+/// <param name="layout">- address of the layout</param>
+/// <param name="offset">- offset of the first vertex in the array buffer in bytes</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_INVALID_LAYOUT on failure</returns>
+err_t layout_apply(const layout_t* layout, u64 offset);
+
+/// <summary>
+/// hashes the attributes and stride of a layout, so equal layouts hash the same wherever they are stored
+/// </summary>
+/// <param name="layout">- address of the layout</param>
+/// <returns>64-bit hash of the layout, or 0 for a null layout</returns>
+u64 layout_hash(const layout_t* layout);
+
+#endif
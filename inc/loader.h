@@ -0,0 +1,125 @@
+#ifndef LOADER_H
+
+#define LOADER_H
+
+#include "error.h"
+
+// most threads a loader starts by default, enough to keep several reads in flight without crowding out the workers
+#define LOADER_THREADS 4
+
+typedef enum loader_kind_t {
+	// the file is read like reader_binary_sized_ex
+	LOADER_KIND_BINARY = 0,
+	// the file is read like reader_string_ex
+	LOADER_KIND_STRING = 1,
+} loader_kind_t;
+
+struct allocator_t;
+
+/// <summary>the outcome of a finished read, handed to its callback</summary>
+typedef struct loader_result_t {
+	// handle returned by loader_read
+	u64 request;
+	cstr path;
+	loader_kind_t kind;
+	// contents of the file, or null on failure. The callback owns it and must free it with allocator_free on the allocator of the read.
+	mem data;
+	// number of bytes read, excluding the terminator of a string
+	u64 size;
+	// ERROR_NONE, or the error the read failed with
+	err_t err;
+} loader_result_t;
+
+/// <summary>
+/// receives a finished read on the thread draining the loader
+/// </summary>
+/// <param name="result">- address of the result, valid only during the call</param>
+/// <param name="user">- user pointer passed to loader_read</param>
+/// <returns>ERROR_NONE, or an error reported by loader_drain</returns>
+typedef err_t (*loader_callback_t)(const loader_result_t* result, ptr user);
+
+/// <summary>
+/// transforms a successful read on the loader thread that read it, such as decoding it, before it waits for loader_drain
+/// </summary>
+/// <param name="result">- address of the result, whose data and size it may replace. Replaced data must come from the allocator of the read, and the old data must then be freed.</param>
+/// <param name="allocator">- allocator of the read</param>
+/// <param name="user">- user pointer passed to loader_read_ex</param>
+/// <returns>ERROR_NONE, or an error stored in the result, whose data the loader then frees</returns>
+typedef err_t (*loader_process_t)(loader_result_t* result, const struct allocator_t* allocator, ptr user);
+
+// opaque type for a pool of threads reading files in the background
+struct loader_t;
+
+/// <summary>
+/// starts the threads of a loader
+/// </summary>
+/// <param name="loader">- address of the null loader pointer</param>
+/// <param name="threads">- number of threads, or 0 for as many hardware threads as there are, up to LOADER_THREADS</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_ALLOC_FAIL or ERROR_THREAD_FAIL on failure</returns>
+err_t loader_create(struct loader_t** loader, u32 threads);
+
+/// <summary>
+/// queues a file to be read in the background, returning without waiting on the disk. Reads run in the order they are queued, several at once.
+/// </summary>
+/// <param name="loader">- address of the loader</param>
+/// <param name="path">- path of the file, copied by the loader</param>
+/// <param name="kind">- how the file is read</param>
+/// <param name="allocator">- allocator the contents come from, or null for the system allocator</param>
+/// <param name="callback">- procedure receiving the result from loader_drain</param>
+/// <param name="user">- user pointer passed to the callback</param>
+/// <param name="request">- address of the handle of the read, or null to discard it</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_UNKNOWN_ENUM or ERROR_ALLOC_FAIL on failure</returns>
+err_t loader_read(struct loader_t* loader, cstr path, loader_kind_t kind, const struct allocator_t* allocator, loader_callback_t callback, ptr user, u64* request);
+
+/// <summary>
+/// queues a file to be read and then processed in the background, returning without waiting on the disk
+/// </summary>
+/// <param name="loader">- address of the loader</param>
+/// <param name="path">- path of the file, copied by the loader</param>
+/// <param name="kind">- how the file is read</param>
+/// <param name="allocator">- allocator the contents come from, or null for the system allocator</param>
+/// <param name="process">- procedure run on the loader thread after a successful read, or null to deliver the contents as read</param>
+/// <param name="callback">- procedure receiving the result from loader_drain</param>
+/// <param name="user">- user pointer passed to both procedures</param>
+/// <param name="request">- address of the handle of the read, or null to discard it</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_UNKNOWN_ENUM or ERROR_ALLOC_FAIL on failure</returns>
+err_t loader_read_ex(struct loader_t* loader, cstr path, loader_kind_t kind, const struct allocator_t* allocator, loader_process_t process, loader_callback_t callback, ptr user, u64* request);
+
+/// <summary>
+/// withdraws a read so its callback is never called. A read still queued never touches the disk; the contents of one already running are freed once it finishes.
+/// </summary>
+/// <param name="loader">- address of the loader</param>
+/// <param name="request">- handle of the read</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure; an unknown or delivered handle is ignored</returns>
+err_t loader_cancel(struct loader_t* loader, u64 request);
+
+/// <summary>
+/// fetches the number of reads whose callbacks have not yet been called, without waiting
+/// </summary>
+/// <param name="loader">- address of the loader</param>
+/// <returns>number of reads queued, running or awaiting loader_drain, or 0 for a null loader</returns>
+u32 loader_pending(struct loader_t* loader);
+
+/// <summary>
+/// calls the callbacks of finished reads on the calling thread, in the order the reads finished; meant to be called once a frame
+/// </summary>
+/// <param name="loader">- address of the loader</param>
+/// <param name="limit">- most callbacks to call, or 0 for every finished read</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, or the first error a callback returned on failure; every callback is still called</returns>
+err_t loader_drain(struct loader_t* loader, u32 limit);
+
+/// <summary>
+/// waits until every read queued so far has finished, leaving the callbacks to loader_drain
+/// </summary>
+/// <param name="loader">- address of the loader</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t loader_finish(struct loader_t* loader);
+
+/// <summary>
+/// stops and joins the threads of a loader, dropping every read it still holds without calling its callback
+/// </summary>
+/// <param name="loader">- address of the loader pointer, which is nulled</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_THREAD_FAIL on failure</returns>
+err_t loader_destroy(struct loader_t** loader);
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef MEMORY_H
+
+#define MEMORY_H
+
+#include "error.h"
+
+// alignment of buffers holding serialized data, wide enough for a cache line and any vector register
+#define MEMORY_ALIGNMENT 64
+
+/// <summary>
+/// allocates a block of memory aligned to a power of two
+/// </summary>
+/// <param name="memory">- address of the null memory pointer</param>
+/// <param name="size">- size of the block in bytes</param>
+/// <param name="alignment">- alignment of the block in bytes</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_NON_POWER_OF_TWO or ERROR_ALLOC_FAIL on failure</returns>
+err_t memory_aligned_alloc(mem* memory, u64 size, u64 alignment);
+
+/// <summary>
+/// frees a block of memory allocated by memory_aligned_alloc
+/// </summary>
+/// <param name="memory">- address of the memory pointer, which is nulled</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t memory_aligned_free(mem* memory);
+
+#endif
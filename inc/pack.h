@@ -0,0 +1,94 @@
+#ifndef PACK_H
+
+#define PACK_H
+
+#include "error.h"
+#include "memory.h"
+
+// identifies a file as an asset pack
+#define PACK_MAGIC "RATP"
+
+// current version of the pack layout, bumped on every incompatible change
+#define PACK_VERSION 1
+
+// alignment of every asset relative to the start of the pack
+#define PACK_ALIGNMENT MEMORY_ALIGNMENT
+
+typedef enum pack_type_t {
+	PACK_TYPE_BINARY = 0,
+	PACK_TYPE_ARRAY = 1,
+	PACK_TYPE_IMAGE = 2,
+	PACK_TYPE_SHADER = 3,
+} pack_type_t;
+
+/// <summary>an asset inside an open pack</summary>
+typedef struct pack_entry_t {
+	// bytes of the asset, aligned to PACK_ALIGNMENT and valid until the pack is closed
+	const byte* data;
+	u64 size;
+	pack_type_t type;
+} pack_entry_t;
+
+// opaque type for a pack under construction
+struct pack_builder_t;
+
+// opaque type for an open, memory-mapped pack
+struct pack_t;
+
+/// <summary>
+/// creates an empty pack builder
+/// </summary>
+/// <param name="builder">- address of the null builder pointer</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL or ERROR_ALLOC_FAIL on failure</returns>
+err_t pack_builder_create(struct pack_builder_t** builder);
+
+/// <summary>
+/// queues a file to be packed under a name; the file is not read until the pack is written
+/// </summary>
+/// <param name="builder">- address of the builder</param>
+/// <param name="name">- name the asset is looked up by, such as its path relative to data/</param>
+/// <param name="path">- path of the file to pack</param>
+/// <param name="type">- type of the asset</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_UNKNOWN_ENUM, ERROR_INVALID_CONTAINER for a duplicate name or ERROR_ALLOC_FAIL on failure</returns>
+err_t pack_builder_add(struct pack_builder_t* builder, cstr name, cstr path, pack_type_t type);
+
+/// <summary>
+/// writes every queued file into a single pack with a hashed table of contents
+/// </summary>
+/// <param name="builder">- address of the builder</param>
+/// <param name="path">- path of the pack to create</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_ALLOC_FAIL, ERROR_UNOPENABLE_FILE, ERROR_UNMAPPABLE_FILE, ERROR_SIZE_MISMATCH or ERROR_UNCLOSEABLE_FILE on failure</returns>
+err_t pack_builder_write(const struct pack_builder_t* builder, cstr path);
+
+/// <summary>
+/// destroys a pack builder
+/// </summary>
+/// <param name="builder">- address of the builder pointer, which is nulled</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t pack_builder_destroy(struct pack_builder_t** builder);
+
+/// <summary>
+/// maps a pack into memory and validates its table of contents
+/// </summary>
+/// <param name="pack">- address of the null pack pointer</param>
+/// <param name="path">- path of the pack</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_ALLOC_FAIL, ERROR_UNOPENABLE_FILE, ERROR_UNMAPPABLE_FILE or ERROR_INVALID_CONTAINER on failure</returns>
+err_t pack_open(struct pack_t** pack, cstr path);
+
+/// <summary>
+/// looks up an asset by name in constant time
+/// </summary>
+/// <param name="pack">- address of the pack</param>
+/// <param name="name">- name the asset was packed under</param>
+/// <param name="entry">- address of the entry describing the asset</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_MISSING_ENTRY or ERROR_INVALID_CONTAINER on failure</returns>
+err_t pack_find(const struct pack_t* pack, cstr name, pack_entry_t* entry);
+
+/// <summary>
+/// unmaps a pack, invalidating every entry found in it
+/// </summary>
+/// <param name="pack">- address of the pack pointer, which is nulled</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_UNMAPPABLE_FILE on failure</returns>
+err_t pack_close(struct pack_t** pack);
+
+#endif
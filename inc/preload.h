@@ -0,0 +1,117 @@
+#ifndef PRELOAD_H
+
+#define PRELOAD_H
+
+#include "error.h"
+#include "container.h"
+#include "layout.h"
+
+// manifest listing the assets read at startup, one "kind path" pair per line
+#define PRELOAD_MANIFEST "data/preload.manifest"
+
+typedef enum preload_kind_t {
+	// a png decoded to rgba pixels and uploaded as a 2d texture
+	PRELOAD_KIND_TEXTURE = 0,
+	// a serialized array uploaded as an array buffer, interleaved or not
+	PRELOAD_KIND_VERTICES = 1,
+	// serialized indices uploaded as an element buffer
+	PRELOAD_KIND_INDICES = 2,
+	// a text file kept in memory, such as a shader source
+	PRELOAD_KIND_TEXT = 3,
+} preload_kind_t;
+
+/// <summary>one asset of a manifest, filled in once it is ready</summary>
+typedef struct preload_asset_t {
+	preload_kind_t kind;
+	cstr path;
+	// true once the asset is uploaded or has failed
+	i32 ready;
+	// ERROR_NONE, or the error the asset failed with
+	err_t err;
+	// texture or buffer handle, 0 for text
+	u32 handle;
+	// width and height of a texture in pixels
+	i32 width;
+	i32 height;
+	// container type and number of components of an array, and its number of elements
+	container_type_t type;
+	u32 components;
+	u64 count;
+	// opengl type of each index
+	u32 index_type;
+	// layout of interleaved vertices, with no attributes otherwise
+	layout_t layout;
+	// null-terminated contents of a text file
+	cstr text;
+	u64 size;
+} preload_asset_t;
+
+// opaque type for the assets of a manifest, loaded on the threads of a loader
+struct preload_t;
+
+struct loader_t;
+
+/// <summary>
+/// reads a manifest and queues every asset it lists on a loader, which reads and decodes them in the background; no opengl context is needed yet
+/// </summary>
+/// <param name="preload">- address of the null preload pointer</param>
+/// <param name="loader">- loader reading the assets, which must outlive the preload</param>
+/// <param name="manifest">- path of the manifest</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_UNOPENABLE_FILE, ERROR_INVALID_MANIFEST or ERROR_ALLOC_FAIL on failure</returns>
+err_t preload_create(struct preload_t** preload, struct loader_t* loader, cstr manifest);
+
+/// <summary>
+/// fetches the number of assets not yet ready, without waiting
+/// </summary>
+/// <param name="preload">- address of the preload</param>
+/// <returns>number of assets not yet ready, or 0 for a null preload</returns>
+u32 preload_pending(struct preload_t* preload);
+
+/// <summary>
+/// waits for every asset to be decoded, then uploads them on the calling thread, which must hold the opengl context
+/// </summary>
+/// <param name="preload">- address of the preload</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, or the first error an asset failed with on failure</returns>
+err_t preload_finish(struct preload_t* preload);
+
+/// <summary>
+/// fetches an asset by the path it is listed under
+/// </summary>
+/// <param name="preload">- address of the preload</param>
+/// <param name="path">- path of the asset as written in the manifest</param>
+/// <param name="asset">- address of the asset pointer, valid until preload_destroy</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_MISSING_ENTRY on failure</returns>
+err_t preload_find(struct preload_t* preload, cstr path, const preload_asset_t** asset);
+
+/// <summary>
+/// fetches the number of assets listed in the manifest
+/// </summary>
+/// <param name="preload">- address of the preload</param>
+/// <returns>number of assets, or 0 for a null preload</returns>
+u32 preload_count(struct preload_t* preload);
+
+/// <summary>
+/// fetches an asset by its position in the manifest
+/// </summary>
+/// <param name="preload">- address of the preload</param>
+/// <param name="index">- position of the asset, below preload_count</param>
+/// <param name="asset">- address of the asset pointer, valid until preload_destroy</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_MISSING_ENTRY on failure</returns>
+err_t preload_at(struct preload_t* preload, u32 index, const preload_asset_t** asset);
+
+/// <summary>
+/// reads an asset again on the loader after its file changed. Once decoded, the draining thread uploads it to a new object and deletes the old one; if the read, decode or upload fails the asset keeps its current objects. Its handle changes, so users should fetch it from the asset each frame rather than keep it.
+/// </summary>
+/// <param name="preload">- address of the preload</param>
+/// <param name="path">- path of the asset as written in the manifest</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_MISSING_ENTRY or ERROR_ALLOC_FAIL on failure</returns>
+err_t preload_reload(struct preload_t* preload, cstr path);
+
+/// <summary>
+/// deletes the textures and buffers of every asset and frees the preload, dropping assets and reloads still loading
+/// </summary>
+/// <param name="preload">- address of the preload pointer, which is nulled</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t preload_destroy(struct preload_t** preload);
+
+#endif
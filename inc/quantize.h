@@ -0,0 +1,133 @@
+#ifndef QUANTIZE_H
+
+#define QUANTIZE_H
+
+#include "error.h"
+#include "container.h"
+
+struct vec2_t;
+struct vec3_t;
+struct vec4_t;
+
+typedef enum quantize_format_t {
+	// ieee 754 half-precision float, for positions that need range more than uniform precision
+	QUANTIZE_FORMAT_F16 = 0,
+	// signed 16-bit integer mapping [-1, 1], for normals and tangents
+	QUANTIZE_FORMAT_SNORM16 = 1,
+	// unsigned 8-bit integer mapping [0, 1], for colors and weights
+	QUANTIZE_FORMAT_UNORM8 = 2,
+} quantize_format_t;
+
+/// <summary>the error introduced by quantizing an array</summary>
+typedef struct quantize_error_t {
+	// largest absolute difference between an in-range input and its decoded value
+	f32 max;
+	// mean absolute difference over the in-range inputs
+	f32 mean;
+	// largest difference the format allows for the inputs seen: half a step for the normalized formats, half an ulp of the largest input for f16
+	f32 bound;
+	// number of inputs outside the range of the format, which were clamped to it, or became infinite for f16
+	u64 clamped;
+} quantize_error_t;
+
+/// <summary>
+/// fetches the size in bytes of one quantized component
+/// </summary>
+/// <param name="format">- quantized format</param>
+/// <returns>size of the component, or 0 for an unknown format</returns>
+u64 quantize_format_size(quantize_format_t format);
+
+/// <summary>
+/// fetches the container type that stores the components of a quantized format
+/// </summary>
+/// <param name="format">- quantized format</param>
+/// <param name="type">- container type of each component</param>
+/// <param name="normalized">- true if the container must carry CONTAINER_FLAG_NORMALIZED</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_UNKNOWN_ENUM on failure</returns>
+err_t quantize_format_type(quantize_format_t format, container_type_t* type, i32* normalized);
+
+/// <summary>
+/// quantizes an array of floats, using f16c or sse2 when the processor has them
+/// </summary>
+/// <param name="dest">- destination of count quantized components in the system byte order</param>
+/// <param name="src">- floats to quantize</param>
+/// <param name="count">- number of floats</param>
+/// <param name="format">- quantized format</param>
+/// <param name="error">- address of the error report, or null to skip measuring it</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_UNKNOWN_ENUM on failure</returns>
+err_t quantize_floats(mem dest, const f32* src, u64 count, quantize_format_t format, quantize_error_t* error);
+
+/// <summary>
+/// expands an array of quantized components back to floats, using f16c or sse2 when the processor has them
+/// </summary>
+/// <param name="dest">- destination of count floats</param>
+/// <param name="src">- quantized components in the system byte order</param>
+/// <param name="count">- number of components</param>
+/// <param name="format">- quantized format</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_UNKNOWN_ENUM on failure</returns>
+err_t dequantize_floats(f32* dest, cmem src, u64 count, quantize_format_t format);
+
+/// <summary>
+/// quantizes an array of 2D vectors component by component
+/// </summary>
+/// <param name="dest">- destination of 2 * count quantized components</param>
+/// <param name="src">- vectors to quantize</param>
+/// <param name="count">- number of vectors</param>
+/// <param name="format">- quantized format</param>
+/// <param name="error">- address of the error report, or null to skip measuring it</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_UNKNOWN_ENUM on failure</returns>
+err_t quantize_vec2s(mem dest, const struct vec2_t* src, u64 count, quantize_format_t format, quantize_error_t* error);
+
+/// <summary>
+/// quantizes an array of 3D vectors component by component
+/// </summary>
+/// <param name="dest">- destination of 3 * count quantized components</param>
+/// <param name="src">- vectors to quantize</param>
+/// <param name="count">- number of vectors</param>
+/// <param name="format">- quantized format</param>
+/// <param name="error">- address of the error report, or null to skip measuring it</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_UNKNOWN_ENUM on failure</returns>
+err_t quantize_vec3s(mem dest, const struct vec3_t* src, u64 count, quantize_format_t format, quantize_error_t* error);
+
+/// <summary>
+/// quantizes an array of 4D vectors component by component
+/// </summary>
+/// <param name="dest">- destination of 4 * count quantized components</param>
+/// <param name="src">- vectors to quantize</param>
+/// <param name="count">- number of vectors</param>
+/// <param name="format">- quantized format</param>
+/// <param name="error">- address of the error report, or null to skip measuring it</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_UNKNOWN_ENUM on failure</returns>
+err_t quantize_vec4s(mem dest, const struct vec4_t* src, u64 count, quantize_format_t format, quantize_error_t* error);
+
+/// <summary>
+/// expands an array of quantized components back to 2D vectors
+/// </summary>
+/// <param name="dest">- destination of count vectors</param>
+/// <param name="src">- 2 * count quantized components</param>
+/// <param name="count">- number of vectors</param>
+/// <param name="format">- quantized format</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_UNKNOWN_ENUM on failure</returns>
+err_t dequantize_vec2s(struct vec2_t* dest, cmem src, u64 count, quantize_format_t format);
+
+/// <summary>
+/// expands an array of quantized components back to 3D vectors
+/// </summary>
+/// <param name="dest">- destination of count vectors</param>
+/// <param name="src">- 3 * count quantized components</param>
+/// <param name="count">- number of vectors</param>
+/// <param name="format">- quantized format</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_UNKNOWN_ENUM on failure</returns>
+err_t dequantize_vec3s(struct vec3_t* dest, cmem src, u64 count, quantize_format_t format);
+
+/// <summary>
+/// expands an array of quantized components back to 4D vectors
+/// </summary>
+/// <param name="dest">- destination of count vectors</param>
+/// <param name="src">- 4 * count quantized components</param>
+/// <param name="count">- number of vectors</param>
+/// <param name="format">- quantized format</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_UNKNOWN_ENUM on failure</returns>
+err_t dequantize_vec4s(struct vec4_t* dest, cmem src, u64 count, quantize_format_t format);
+
+#endif
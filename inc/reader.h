@@ -4,8 +4,105 @@
 
 #include "error.h"
 
+typedef enum reader_advice_t {
+	READER_ADVICE_NORMAL = 0,
+	READER_ADVICE_SEQUENTIAL = 1,
+	READER_ADVICE_RANDOM = 2,
+	READER_ADVICE_WILLNEED = 3,
+} reader_advice_t;
+
+/// <summary>a read-only memory mapping of a file</summary>
+typedef struct reader_map_t {
+	const byte* data;
+	u64 size;
+} reader_map_t;
+
+/// <summary>a length-delimited run of text owned by the reader, valid until the next read on the same thread</summary>
+typedef struct reader_view_t {
+	cstr data;
+	u64 size;
+} reader_view_t;
+
+struct allocator_t;
+
+/// <summary>
+/// reads a whole text file into a null-terminated string
+/// </summary>
+/// <param name="path">- path of the file</param>
+/// <param name="content">- address of the null string. It must be freed with memory_aligned_free if successful.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_UNOPENABLE_FILE, ERROR_ALLOC_FAIL or ERROR_UNCLOSEABLE_FILE on failure</returns>
 err_t reader_string(cstr path, str* content);
 
+/// <summary>
+/// reads a whole file into a buffer aligned to MEMORY_ALIGNMENT
+/// </summary>
+/// <param name="path">- path of the file</param>
+/// <param name="buffer">- address of the null buffer. It must be freed with buffer_destroy if successful.</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_UNOPENABLE_FILE, ERROR_ALLOC_FAIL, ERROR_SIZE_MISMATCH or ERROR_UNCLOSEABLE_FILE on failure</returns>
 err_t reader_binary(cstr path, byte** buffer);
 
+/// <summary>
+/// reads a whole text file into a null-terminated string from an allocator
+/// </summary>
+/// <param name="path">- path of the file</param>
+/// <param name="content">- address of the null string. It must be freed with allocator_free on the same allocator if successful.</param>
+/// <param name="allocator">- allocator the string comes from, or null for the system allocator</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_UNOPENABLE_FILE, ERROR_ALLOC_FAIL or ERROR_UNCLOSEABLE_FILE on failure</returns>
+err_t reader_string_ex(cstr path, str* content, const struct allocator_t* allocator);
+
+/// <summary>
+/// reads a whole file into a buffer aligned to MEMORY_ALIGNMENT from an allocator
+/// </summary>
+/// <param name="path">- path of the file</param>
+/// <param name="buffer">- address of the null buffer. It must be freed with buffer_destroy_ex on the same allocator if successful.</param>
+/// <param name="allocator">- allocator the buffer comes from, or null for the system allocator</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_UNOPENABLE_FILE, ERROR_ALLOC_FAIL, ERROR_SIZE_MISMATCH or ERROR_UNCLOSEABLE_FILE on failure</returns>
+err_t reader_binary_ex(cstr path, byte** buffer, const struct allocator_t* allocator);
+
+/// <summary>
+/// reads a whole file into a buffer aligned to MEMORY_ALIGNMENT from an allocator, also fetching its length
+/// </summary>
+/// <param name="path">- path of the file</param>
+/// <param name="buffer">- address of the null buffer. It must be freed with buffer_destroy_ex on the same allocator if successful.</param>
+/// <param name="size">- address of the number of bytes read</param>
+/// <param name="allocator">- allocator the buffer comes from, or null for the system allocator</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_UNOPENABLE_FILE, ERROR_ALLOC_FAIL, ERROR_SIZE_MISMATCH or ERROR_UNCLOSEABLE_FILE on failure</returns>
+err_t reader_binary_sized_ex(cstr path, byte** buffer, u64* size, const struct allocator_t* allocator);
+
+/// <summary>
+/// reads a whole text file into a scratch buffer kept by the calling thread, which grows to fit and is reused by the next read, so steady reading makes no allocations. The bytes are read untranslated in one call and followed by a terminator.
+/// </summary>
+/// <param name="path">- path of the file</param>
+/// <param name="view">- address of the view, valid until the next call on this thread or reader_scratch_release</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_UNOPENABLE_FILE, ERROR_ALLOC_FAIL, ERROR_SIZE_MISMATCH or ERROR_UNCLOSEABLE_FILE on failure</returns>
+err_t reader_text_scratch(cstr path, reader_view_t* view);
+
+/// <summary>
+/// frees the scratch buffer of the calling thread, such as before the thread exits
+/// </summary>
+void reader_scratch_release();
+
+/// <summary>
+/// maps a file into memory read-only, leaving the copy into memory to the page cache
+/// </summary>
+/// <param name="path">- path of the file</param>
+/// <param name="map">- address of the mapping, whose data can be passed straight to the deserializers</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_UNOPENABLE_FILE or ERROR_UNMAPPABLE_FILE on failure</returns>
+err_t reader_map(cstr path, reader_map_t* map);
+
+/// <summary>
+/// hints how a mapping will be accessed so the system can read ahead or drop pages accordingly
+/// </summary>
+/// <param name="map">- address of the mapping</param>
+/// <param name="advice">- expected access pattern</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_UNKNOWN_ENUM on failure</returns>
+err_t reader_map_advise(const reader_map_t* map, reader_advice_t advice);
+
+/// <summary>
+/// unmaps a file mapped with reader_map
+/// </summary>
+/// <param name="map">- address of the mapping</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_UNMAPPABLE_FILE on failure</returns>
+err_t reader_unmap(reader_map_t* map);
+
 #endif
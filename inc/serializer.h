@@ -3,22 +3,42 @@
 #define SERIALIZER_H
 
 #include "error.h"
+#include "container.h"
+#include "indices.h"
+#include "quantize.h"
 
 struct vec2_t;
 struct vec3_t;
 struct vec4_t;
 
+struct workers_t;
+struct allocator_t;
+struct layout_t;
+
+// opaque type for a serializer that streams an array to a file in bounded chunks
+struct serializer_stream_t;
+
+// default size in bytes of the staging buffer of a serializer stream
+#define SERIALIZER_STREAM_CHUNK_SIZE (1 << 20)
+
 /// <summary>
-/// allocates the buffer and serializes the size
+/// sets the pool that serializers split large payloads across, in cache-sized ranges; set it before serializing from several threads
 /// </summary>
-/// <param name="buffer">- serialzed binary data</param>
-/// <param name="arr_size">- size of the array</param>
-/// <param name="elem_size">- size of an element</param>
-/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NONNULL, or ERROR_ALLOC_FAIL on failure</returns>
-err_t serialize_size(byte** buffer, u64 arr_size, u64 elem_size);
+/// <param name="workers">- address of the pool, which must outlive its use, or null to serialize on the calling thread</param>
+void serializer_workers_set(struct workers_t* workers);
+
+/// <summary>
+/// allocates the buffer and serializes the container header of an array
+/// </summary>
+/// <param name="buffer">- serialzed binary data, large enough for the header, padding and payload</param>
+/// <param name="type">- type of each component</param>
+/// <param name="components">- number of components in an element</param>
+/// <param name="count">- number of elements in the array</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NONNULL, ERROR_UNKNOWN_ENUM or ERROR_ALLOC_FAIL on failure</returns>
+err_t serialize_header(byte** buffer, container_type_t type, u32 components, u64 count);
 
 /// <summary>
-/// allocates a buffer of bytes
+/// allocates a buffer of bytes aligned to CONTAINER_ALIGNMENT
 /// </summary>
 /// <param name="buffer">- serialized binary data</param>
 /// <param name="mem_size">- size of the buffer in bytes</param>
@@ -32,10 +52,38 @@ err_t buffer_create(byte** buffer, u64 mem_size);
 /// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NONNULL, or ERROR_ALLOC_FAIL on failure</returns>
 err_t buffer_destroy(byte** buffer);
 
+/// <summary>
+/// allocates a buffer of bytes aligned to CONTAINER_ALIGNMENT from an allocator
+/// </summary>
+/// <param name="buffer">- serialized binary data</param>
+/// <param name="mem_size">- size of the buffer in bytes</param>
+/// <param name="allocator">- allocator the buffer comes from, or null for the system allocator</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NONNULL, or ERROR_ALLOC_FAIL on failure</returns>
+err_t buffer_create_ex(byte** buffer, u64 mem_size, const struct allocator_t* allocator);
+
+/// <summary>
+/// deallocates a buffer of bytes back to the allocator it came from
+/// </summary>
+/// <param name="buffer">- serialized binary data</param>
+/// <param name="allocator">- allocator the buffer came from, or null for the system allocator</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t buffer_destroy_ex(byte** buffer, const struct allocator_t* allocator);
+
+/// <summary>
+/// serializes the container header and data of an array of any container type
+/// </summary>
+/// <param name="buffer">- serialzed binary data. It must be destroyed if successful.</param>
+/// <param name="type">- type of each component</param>
+/// <param name="components">- number of components in an element</param>
+/// <param name="array">- densely packed array of elements</param>
+/// <param name="size">- size of the array</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NONNULL, ERROR_UNKNOWN_ENUM or ERROR_ALLOC_FAIL on failure</returns>
+err_t serialize_array(byte** buffer, container_type_t type, u32 components, cmem array, u64 size);
+
 /// <summary>
 /// serializes the size and data of a float array
 /// </summary>
-/// <param name="buffer">- serialzed binary data. It must be freed if successful.</param>
+/// <param name="buffer">- serialzed binary data. It must be destroyed if successful.</param>
 /// <param name="array">- array of floats.</param>
 /// <param name="size">- size of the array.</param>
 /// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NONNULL, or ERROR_ALLOC_FAIL on failure</returns>
@@ -77,4 +125,105 @@ err_t serialize_vec3s(byte** buffer, const struct vec3_t* array, u64 size);
 /// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NONNULL, or ERROR_ALLOC_FAIL on failure</returns>
 err_t serialize_vec4s(byte** buffer, const struct vec4_t* array, u64 size);
 
+/// <summary>
+/// serializes an array of indices at the narrowest type that holds them, optionally delta and varint encoded
+/// </summary>
+/// <param name="buffer">- serialzed binary data. It must be destroyed if successful.</param>
+/// <param name="array">- array of 32-bit indices</param>
+/// <param name="size">- size of the array</param>
+/// <param name="encoding">- how the indices are stored</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NONNULL, ERROR_UNKNOWN_ENUM or ERROR_ALLOC_FAIL on failure</returns>
+err_t serialize_indices(byte** buffer, const u32* array, u64 size, indices_encoding_t encoding);
+
+/// <summary>
+/// quantizes an array of float components and serializes it under the container type of the format
+/// </summary>
+/// <param name="buffer">- serialzed binary data. It must be destroyed if successful.</param>
+/// <param name="format">- quantized format of each component</param>
+/// <param name="components">- number of components in an element</param>
+/// <param name="array">- densely packed array of float components</param>
+/// <param name="size">- number of elements in the array</param>
+/// <param name="error">- address of the error report, or null to skip measuring it</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NONNULL, ERROR_UNKNOWN_ENUM or ERROR_ALLOC_FAIL on failure</returns>
+err_t serialize_quantized(byte** buffer, quantize_format_t format, u32 components, const f32* array, u64 size, quantize_error_t* error);
+
+/// <summary>
+/// quantizes and serializes an array of 2D vectors
+/// </summary>
+/// <param name="buffer">- serialzed binary data. It must be destroyed if successful.</param>
+/// <param name="format">- quantized format of each component</param>
+/// <param name="array">- array of 2D vectors</param>
+/// <param name="size">- size of the array</param>
+/// <param name="error">- address of the error report, or null to skip measuring it</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NONNULL, ERROR_UNKNOWN_ENUM or ERROR_ALLOC_FAIL on failure</returns>
+err_t serialize_vec2s_quantized(byte** buffer, quantize_format_t format, const struct vec2_t* array, u64 size, quantize_error_t* error);
+
+/// <summary>
+/// quantizes and serializes an array of 3D vectors
+/// </summary>
+/// <param name="buffer">- serialzed binary data. It must be destroyed if successful.</param>
+/// <param name="format">- quantized format of each component</param>
+/// <param name="array">- array of 3D vectors</param>
+/// <param name="size">- size of the array</param>
+/// <param name="error">- address of the error report, or null to skip measuring it</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NONNULL, ERROR_UNKNOWN_ENUM or ERROR_ALLOC_FAIL on failure</returns>
+err_t serialize_vec3s_quantized(byte** buffer, quantize_format_t format, const struct vec3_t* array, u64 size, quantize_error_t* error);
+
+/// <summary>
+/// quantizes and serializes an array of 4D vectors
+/// </summary>
+/// <param name="buffer">- serialzed binary data. It must be destroyed if successful.</param>
+/// <param name="format">- quantized format of each component</param>
+/// <param name="array">- array of 4D vectors</param>
+/// <param name="size">- size of the array</param>
+/// <param name="error">- address of the error report, or null to skip measuring it</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NONNULL, ERROR_UNKNOWN_ENUM or ERROR_ALLOC_FAIL on failure</returns>
+err_t serialize_vec4s_quantized(byte** buffer, quantize_format_t format, const struct vec4_t* array, u64 size, quantize_error_t* error);
+
+/// <summary>
+/// serializes one densely packed array per attribute into a single buffer of interleaved vertices, preceded by the layout that describes them
+/// </summary>
+/// <param name="buffer">- serialzed binary data. It must be destroyed if successful.</param>
+/// <param name="layout">- address of the layout of each vertex</param>
+/// <param name="arrays">- one array of size elements per attribute, in the order of the layout</param>
+/// <param name="size">- number of vertices</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NONNULL, ERROR_INVALID_LAYOUT or ERROR_ALLOC_FAIL on failure</returns>
+err_t serialize_interleaved(byte** buffer, const struct layout_t* layout, const cmem* arrays, u64 size);
+
+/// <summary>
+/// compresses the payload of serialized data into independent blocks that deserialize_array decompresses in parallel
+/// </summary>
+/// <param name="compressed">- serialized binary data with a compressed payload. It must be destroyed if successful.</param>
+/// <param name="buffer">- serialized binary data with an uncompressed payload that is not delta encoded</param>
+/// <param name="block_size">- size of each block in bytes, such as COMPRESS_BLOCK_SIZE</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NONNULL, ERROR_INVALID_CONTAINER, ERROR_SIZE_INDIVISIBLE, ERROR_SIZE_MISMATCH or ERROR_ALLOC_FAIL on failure</returns>
+err_t serialize_compress(byte** compressed, const byte* buffer, u32 block_size);
+
+/// <summary>
+/// opens a file and writes a provisional container header, ready to stream an array of unknown size into it
+/// </summary>
+/// <param name="stream">- address of the null stream pointer</param>
+/// <param name="path">- path of the file to create</param>
+/// <param name="type">- type of each component</param>
+/// <param name="components">- number of components in an element</param>
+/// <param name="chunk_size">- size in bytes of the staging buffer, or 0 for SERIALIZER_STREAM_CHUNK_SIZE</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_UNKNOWN_ENUM, ERROR_ALLOC_FAIL or ERROR_UNOPENABLE_FILE on failure</returns>
+err_t serializer_stream_open(struct serializer_stream_t** stream, cstr path, container_type_t type, u32 components, u64 chunk_size);
+
+/// <summary>
+/// appends elements to a stream, flushing the staging buffer to the file every time it fills
+/// </summary>
+/// <param name="stream">- address of the stream</param>
+/// <param name="array">- densely packed elements, which may be any piece of the whole array</param>
+/// <param name="count">- number of elements</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_SIZE_MISMATCH on failure</returns>
+err_t serializer_stream_write(struct serializer_stream_t* stream, cmem array, u64 count);
+
+/// <summary>
+/// flushes the remaining elements of a stream, patches the final count into the container header and closes the file
+/// </summary>
+/// <param name="stream">- address of the stream pointer, which is nulled even on failure</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_SIZE_MISMATCH or ERROR_UNCLOSEABLE_FILE on failure</returns>
+err_t serializer_stream_close(struct serializer_stream_t** stream);
+
 #endif
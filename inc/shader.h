@@ -4,6 +4,8 @@
 
 #include "error.h"
 
+struct allocator_t;
+
 // length of the shader file extension (.xxxx)
 #define SHADER_EXT_LENGTH 5
 
@@ -58,6 +60,34 @@ err_t path_append_ext(str* path, cstr base, cstr ext);
 /// <returns>ERROR_NONE on success; ERROR_PARAM_NULL or ERROR_PARAM_NOTNULL on failure</returns>
 err_t path_destroy(str* path);
 
+/// <summary>
+/// creates a partial path from a base path and name from an allocator
+/// </summary>
+/// <param name="path">- address of the null path</param>
+/// <param name="base">- base path</param>
+/// <param name="name">- name appended after a separator</param>
+/// <param name="allocator">- allocator the path comes from, or null for the system allocator</param>
+/// <returns>ERROR_NONE on success; ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL or ERROR_ALLOC_FAIL on failure</returns>
+err_t path_create_ex(str* path, cstr base, cstr name, const struct allocator_t* allocator);
+
+/// <summary>
+/// appends a file extension to a partial path from an allocator
+/// </summary>
+/// <param name="path">- address of the null path</param>
+/// <param name="base">- base path of file</param>
+/// <param name="ext">- extension to append</param>
+/// <param name="allocator">- allocator the path comes from, or null for the system allocator</param>
+/// <returns>ERROR_NONE on success; ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL or ERROR_ALLOC_FAIL on failure</returns>
+err_t path_append_ext_ex(str* path, cstr base, cstr ext, const struct allocator_t* allocator);
+
+/// <summary>
+/// destroys a path created from an allocator
+/// </summary>
+/// <param name="path">- address of the path</param>
+/// <param name="allocator">- allocator the path came from, or null for the system allocator</param>
+/// <returns>ERROR_NONE on success; ERROR_PARAM_NULL on failure</returns>
+err_t path_destroy_ex(str* path, const struct allocator_t* allocator);
+
 /// <summary>
 /// load a shader program by name and base path with shader types
 /// </summary>
@@ -68,6 +98,16 @@ err_t path_destroy(str* path);
 /// <returns></returns>
 err_t program_load(cstr path, cstr name, u32* program, shader_t types);
 
+/// <summary>
+/// loads a shader program again into a new handle, deleting the old program only once the new one has linked
+/// </summary>
+/// <param name="path">- base path of the shader program</param>
+/// <param name="name">- name of the shader program</param>
+/// <param name="program">- address of the shader program handle, left untouched on failure</param>
+/// <param name="types">- shader types for this shader program</param>
+/// <returns>ERROR_NONE on success; ERROR_PARAM_NULL, ERROR_SHADER_COMPIL_FAIL or ERROR_SHADER_LINK_FAIL on failure</returns>
+err_t program_reload(cstr path, cstr name, u32* program, shader_t types);
+
 /// <summary>
 /// unloads a shader program
 /// </summary>
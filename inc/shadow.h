@@ -0,0 +1,76 @@
+#ifndef SHADOW_H
+
+#define SHADOW_H
+
+#include "error.h"
+
+// dirty ranges a shadow keeps apart before merging the two closest, bounding the calls of a flush
+#define SHADOW_RANGES 64
+
+// bytes of clean data between two dirty ranges below which a flush sends both as one, as a call costs more than a few spare bytes
+#define SHADOW_GAP 256
+
+// opaque type for a buffer object with a copy in memory that tracks which elements changed
+struct shadow_t;
+
+/// <summary>
+/// creates a buffer object and its copy in memory, uploading the initial elements
+/// </summary>
+/// <param name="shadow">- address of the null shadow pointer</param>
+/// <param name="target">- buffer target, such as GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER</param>
+/// <param name="data">- initial elements, or null to start zeroed</param>
+/// <param name="count">- number of elements</param>
+/// <param name="stride">- size of each element in bytes</param>
+/// <param name="mode">- usage of the buffer, GL_STATIC_DRAW, GL_DYNAMIC_DRAW or GL_STREAM_DRAW</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_UNKNOWN_ENUM or ERROR_ALLOC_FAIL on failure</returns>
+err_t shadow_create(struct shadow_t** shadow, u32 target, cmem data, u64 count, u64 stride, u32 mode);
+
+/// <summary>
+/// fetches the copy in memory, to edit in place before calling shadow_mark
+/// </summary>
+/// <param name="shadow">- address of the shadow</param>
+/// <returns>address of the first element, or null for a null shadow</returns>
+mem shadow_data(struct shadow_t* shadow);
+
+/// <summary>
+/// marks elements edited in place as changed, to be uploaded by the next flush
+/// </summary>
+/// <param name="shadow">- address of the shadow</param>
+/// <param name="first">- index of the first changed element</param>
+/// <param name="count">- number of changed elements</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_SIZE_MISMATCH past the last element on failure</returns>
+err_t shadow_mark(struct shadow_t* shadow, u64 first, u64 count);
+
+/// <summary>
+/// copies elements into the copy in memory and marks them as changed
+/// </summary>
+/// <param name="shadow">- address of the shadow</param>
+/// <param name="first">- index of the first element to overwrite</param>
+/// <param name="data">- new elements</param>
+/// <param name="count">- number of elements</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_SIZE_MISMATCH past the last element on failure</returns>
+err_t shadow_write(struct shadow_t* shadow, u64 first, cmem data, u64 count);
+
+/// <summary>
+/// uploads every changed range with one glBufferSubData each, merging ranges closer than SHADOW_GAP; meant to be called once a frame before drawing
+/// </summary>
+/// <param name="shadow">- address of the shadow</param>
+/// <param name="uploaded">- address of the number of bytes uploaded, or null</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t shadow_flush(struct shadow_t* shadow, u64* uploaded);
+
+/// <summary>
+/// fetches the buffer object of a shadow
+/// </summary>
+/// <param name="shadow">- address of the shadow</param>
+/// <returns>opengl handle of the buffer, or 0 for a null shadow</returns>
+u32 shadow_buffer(struct shadow_t* shadow);
+
+/// <summary>
+/// deletes the buffer object of a shadow and frees it, dropping changes not yet flushed
+/// </summary>
+/// <param name="shadow">- address of the shadow pointer, which is nulled</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t shadow_destroy(struct shadow_t** shadow);
+
+#endif
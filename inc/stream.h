@@ -0,0 +1,74 @@
+#ifndef STREAM_H
+
+#define STREAM_H
+
+#include "error.h"
+
+// regions of a stream, so the cpu writes one frame while the gpu still reads the two before it
+#define STREAM_REGIONS 3
+
+// bytes of each region of the stream created by the program
+#define STREAM_SIZE (4 * 1024 * 1024)
+
+// nanoseconds waited on a fence before the wait is retried with the command queue flushed
+#define STREAM_TIMEOUT 1000000
+
+// opaque type for a buffer object split into regions written once a frame in turn
+struct stream_t;
+
+/// <summary>
+/// creates a stream of STREAM_REGIONS regions, persistently mapped where buffer storage is supported and written through a staging copy otherwise
+/// </summary>
+/// <param name="stream">- address of the null stream pointer</param>
+/// <param name="target">- buffer target the stream is bound to, such as GL_ARRAY_BUFFER</param>
+/// <param name="size">- bytes of each region, the most a single frame may allocate</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_ALLOC_FAIL or ERROR_UNMAPPABLE_BUFFER on failure</returns>
+err_t stream_create(struct stream_t** stream, u32 target, u64 size);
+
+/// <summary>
+/// starts a frame on the next region, first waiting for the gpu to finish the frame that last used it
+/// </summary>
+/// <param name="stream">- address of the stream</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t stream_begin(struct stream_t* stream);
+
+/// <summary>
+/// allocates bytes out of the region of the current frame, valid to write until stream_end
+/// </summary>
+/// <param name="stream">- address of the stream</param>
+/// <param name="size">- number of bytes</param>
+/// <param name="alignment">- alignment of the offset in bytes, such as the size of a vertex, or 0 for none</param>
+/// <param name="pointer">- address of the pointer to write the bytes through</param>
+/// <param name="offset">- address of the offset of the bytes in the buffer object, to pass to glVertexAttribPointer or a draw call</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_QUEUE_FULL when the region has no room left on failure</returns>
+err_t stream_alloc(struct stream_t* stream, u64 size, u64 alignment, mem* pointer, u64* offset);
+
+/// <summary>
+/// makes the bytes written so far visible to the gpu, which must happen before drawing from them; does nothing for a persistently mapped stream
+/// </summary>
+/// <param name="stream">- address of the stream</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t stream_flush(struct stream_t* stream);
+
+/// <summary>
+/// ends the frame once every draw reading from it is issued, fencing its region until the gpu has read it
+/// </summary>
+/// <param name="stream">- address of the stream</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t stream_end(struct stream_t* stream);
+
+/// <summary>
+/// fetches the buffer object of a stream
+/// </summary>
+/// <param name="stream">- address of the stream</param>
+/// <returns>opengl handle of the buffer, or 0 for a null stream</returns>
+u32 stream_buffer(struct stream_t* stream);
+
+/// <summary>
+/// waits for the gpu to finish with every region, then deletes the buffer object and frees the stream
+/// </summary>
+/// <param name="stream">- address of the stream pointer, which is nulled</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t stream_destroy(struct stream_t** stream);
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef THREAD_H
+
+#define THREAD_H
+
+#include "error.h"
+
+// opaque type for an operating system thread
+struct thread_t;
+
+// opaque type for a mutual exclusion lock
+struct mutex_t;
+
+// opaque type for a condition variable waited on under a mutex_t
+struct condition_t;
+
+/// <summary>
+/// entry point of a thread
+/// </summary>
+/// <param name="user">- user pointer passed to thread_create</param>
+/// <returns>result reported by thread_join</returns>
+typedef err_t (*thread_proc_t)(ptr user);
+
+/// <summary>
+/// starts a thread running a procedure
+/// </summary>
+/// <param name="thread">- address of the null thread pointer</param>
+/// <param name="proc">- procedure run by the thread</param>
+/// <param name="user">- user pointer passed to the procedure</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_ALLOC_FAIL or ERROR_THREAD_FAIL on failure</returns>
+err_t thread_create(struct thread_t** thread, thread_proc_t proc, ptr user);
+
+/// <summary>
+/// waits for a thread to finish and destroys it
+/// </summary>
+/// <param name="thread">- address of the thread pointer, which is nulled</param>
+/// <param name="result">- result of the procedure, or null to discard it</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_THREAD_FAIL on failure</returns>
+err_t thread_join(struct thread_t** thread, err_t* result);
+
+/// <summary>
+/// creates an unlocked mutex
+/// </summary>
+/// <param name="mutex">- address of the null mutex pointer</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_ALLOC_FAIL or ERROR_THREAD_FAIL on failure</returns>
+err_t mutex_create(struct mutex_t** mutex);
+
+/// <summary>
+/// destroys an unlocked mutex
+/// </summary>
+/// <param name="mutex">- address of the mutex pointer, which is nulled</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t mutex_destroy(struct mutex_t** mutex);
+
+/// <summary>
+/// blocks until the calling thread holds a mutex
+/// </summary>
+/// <param name="mutex">- address of the mutex</param>
+void mutex_lock(struct mutex_t* mutex);
+
+/// <summary>
+/// releases a mutex held by the calling thread
+/// </summary>
+/// <param name="mutex">- address of the mutex</param>
+void mutex_unlock(struct mutex_t* mutex);
+
+/// <summary>
+/// creates a condition variable
+/// </summary>
+/// <param name="condition">- address of the null condition pointer</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_ALLOC_FAIL or ERROR_THREAD_FAIL on failure</returns>
+err_t condition_create(struct condition_t** condition);
+
+/// <summary>
+/// destroys a condition variable no thread is waiting on
+/// </summary>
+/// <param name="condition">- address of the condition pointer, which is nulled</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t condition_destroy(struct condition_t** condition);
+
+/// <summary>
+/// releases a held mutex, sleeps until the condition is signalled, and reacquires the mutex; wakeups may be spurious, so callers wait in a loop
+/// </summary>
+/// <param name="condition">- address of the condition</param>
+/// <param name="mutex">- address of the mutex held by the calling thread</param>
+void condition_wait(struct condition_t* condition, struct mutex_t* mutex);
+
+/// <summary>
+/// wakes at least one thread waiting on a condition
+/// </summary>
+/// <param name="condition">- address of the condition</param>
+void condition_signal(struct condition_t* condition);
+
+/// <summary>
+/// wakes every thread waiting on a condition
+/// </summary>
+/// <param name="condition">- address of the condition</param>
+void condition_broadcast(struct condition_t* condition);
+
+/// <summary>
+/// fetches the number of hardware threads available to the process
+/// </summary>
+/// <returns>number of hardware threads, at least 1</returns>
+u32 thread_concurrency();
+
+#endif
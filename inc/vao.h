@@ -0,0 +1,66 @@
+#ifndef VAO_H
+
+#define VAO_H
+
+#include "error.h"
+
+struct layout_t;
+
+// most vertex buffers a single vertex array reads from
+#define VAO_BINDINGS_MAX 4
+
+/// <summary>one vertex buffer of a vertex array and the layout its vertices follow</summary>
+typedef struct vao_binding_t {
+	const struct layout_t* layout;
+	u32 buffer;
+	// offset of the first vertex in the buffer in bytes
+	u64 offset;
+} vao_binding_t;
+
+// opaque type for vertex arrays kept by the layouts and buffers they were built from
+struct vao_cache_t;
+
+/// <summary>
+/// creates an empty vertex array cache
+/// </summary>
+/// <param name="cache">- address of the null cache pointer</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL or ERROR_ALLOC_FAIL on failure</returns>
+err_t vao_cache_create(struct vao_cache_t** cache);
+
+/// <summary>
+/// fetches the vertex array reading a set of buffers through their layouts, building it on first use
+/// </summary>
+/// <param name="cache">- address of the cache</param>
+/// <param name="bindings">- vertex buffers and their layouts</param>
+/// <param name="count">- number of bindings, 1 to VAO_BINDINGS_MAX</param>
+/// <param name="elements">- element buffer of the vertex array, or 0 for none</param>
+/// <param name="vao">- address of the vertex array handle</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_SIZE_MISMATCH, ERROR_INVALID_LAYOUT or ERROR_ALLOC_FAIL on failure</returns>
+err_t vao_fetch(struct vao_cache_t* cache, const vao_binding_t* bindings, u32 count, u32 elements, u32* vao);
+
+/// <summary>
+/// binds the vertex array reading a set of buffers through their layouts with a single call once it is cached
+/// </summary>
+/// <param name="cache">- address of the cache</param>
+/// <param name="bindings">- vertex buffers and their layouts</param>
+/// <param name="count">- number of bindings, 1 to VAO_BINDINGS_MAX</param>
+/// <param name="elements">- element buffer of the vertex array, or 0 for none</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_SIZE_MISMATCH, ERROR_INVALID_LAYOUT or ERROR_ALLOC_FAIL on failure</returns>
+err_t vao_bind(struct vao_cache_t* cache, const vao_binding_t* bindings, u32 count, u32 elements);
+
+/// <summary>
+/// deletes every vertex array reading from a buffer, to be called before the buffer is deleted or replaced
+/// </summary>
+/// <param name="cache">- address of the cache</param>
+/// <param name="buffer">- vertex or element buffer handle</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t vao_forget(struct vao_cache_t* cache, u32 buffer);
+
+/// <summary>
+/// deletes every vertex array of the cache and frees it
+/// </summary>
+/// <param name="cache">- address of the cache pointer, which is nulled</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t vao_cache_destroy(struct vao_cache_t** cache);
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef WATCH_H
+
+#define WATCH_H
+
+#include "error.h"
+
+// milliseconds a file must stay unchanged after its last change before it is reported, so a save made of several writes reloads once
+#define WATCH_DEBOUNCE 150
+
+// milliseconds between checks of modification times where the system cannot report changes itself
+#define WATCH_INTERVAL 250
+
+/// <summary>
+/// receives a changed file on the thread polling the watch
+/// </summary>
+/// <param name="path">- path of the file as it was added</param>
+/// <param name="user">- user pointer passed to watch_add</param>
+/// <returns>ERROR_NONE, or an error reported by watch_poll</returns>
+typedef err_t (*watch_callback_t)(cstr path, ptr user);
+
+// opaque type for a set of files watched for changes
+struct watch_t;
+
+/// <summary>
+/// creates an empty watch, backed by inotify on linux and by polling modification times elsewhere
+/// </summary>
+/// <param name="watch">- address of the null watch pointer</param>
+/// <param name="debounce">- milliseconds a file must stay unchanged before it is reported, or 0 for WATCH_DEBOUNCE</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL or ERROR_ALLOC_FAIL on failure</returns>
+err_t watch_create(struct watch_t** watch, u32 debounce);
+
+/// <summary>
+/// starts watching a file, which is reported when it is written or replaced; a file may be added several times with different callbacks
+/// </summary>
+/// <param name="watch">- address of the watch</param>
+/// <param name="path">- path of the file, copied by the watch</param>
+/// <param name="callback">- procedure called by watch_poll once the file has changed</param>
+/// <param name="user">- user pointer passed to the callback</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_ALLOC_FAIL or ERROR_UNOPENABLE_FILE on failure</returns>
+err_t watch_add(struct watch_t* watch, cstr path, watch_callback_t callback, ptr user);
+
+/// <summary>
+/// collects changes without blocking and calls the callback of every file that has since stayed unchanged for the debounce time; meant to be called once a frame
+/// </summary>
+/// <param name="watch">- address of the watch</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, or the first error a callback returned on failure; every callback is still called</returns>
+err_t watch_poll(struct watch_t* watch);
+
+/// <summary>
+/// stops watching every file and frees the watch
+/// </summary>
+/// <param name="watch">- address of the watch pointer, which is nulled</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t watch_destroy(struct watch_t** watch);
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef WORKERS_H
+
+#define WORKERS_H
+
+#include "error.h"
+
+// bytes of payload handed to a worker at a time, small enough to stay in a per-core cache
+#define WORKERS_GRAIN_BYTES (256 * 1024)
+
+// payloads smaller than this are decoded on the calling thread, where waking the pool would cost more than it saves
+#define WORKERS_THRESHOLD_BYTES (4 * WORKERS_GRAIN_BYTES)
+
+// opaque type for a pool of persistent worker threads
+struct workers_t;
+
+/// <summary>
+/// processes one range of a parallel loop
+/// </summary>
+/// <param name="begin">- first index of the range</param>
+/// <param name="end">- index after the last of the range</param>
+/// <param name="user">- user pointer passed to workers_parallel_for</param>
+/// <returns>ERROR_NONE to continue, or any other error to cancel the ranges not yet started and report it</returns>
+typedef err_t (*workers_task_t)(u64 begin, u64 end, ptr user);
+
+/// <summary>
+/// starts a pool of worker threads that sleep until given a loop
+/// </summary>
+/// <param name="workers">- address of the null pool pointer</param>
+/// <param name="count">- number of threads besides the caller's, or 0 for one less than thread_concurrency</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_ALLOC_FAIL or ERROR_THREAD_FAIL on failure</returns>
+err_t workers_create(struct workers_t** workers, u32 count);
+
+/// <summary>
+/// runs a loop over [0, count) in ranges of grain indices on the pool and the calling thread, returning once every range is done; concurrent calls on one pool run one after another
+/// </summary>
+/// <param name="workers">- address of the pool, or null to run the whole loop on the calling thread</param>
+/// <param name="count">- number of indices</param>
+/// <param name="grain">- number of indices in each range, at least 1</param>
+/// <param name="task">- procedure run on each range</param>
+/// <param name="user">- user pointer passed to the task</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, or the first error returned by the task on failure</returns>
+err_t workers_parallel_for(struct workers_t* workers, u64 count, u64 grain, workers_task_t task, ptr user);
+
+/// <summary>
+/// copies an array, reversing the byte order of each element if asked, in cache-sized ranges across a pool
+/// </summary>
+/// <param name="workers">- address of the pool, or null to convert on the calling thread</param>
+/// <param name="dest">- destination of the elements, which may be the source itself</param>
+/// <param name="src">- source elements</param>
+/// <param name="width">- size of an element in bytes, 1, 2, 4 or 8</param>
+/// <param name="count">- number of elements</param>
+/// <param name="swap">- true to reverse the byte order of each element, false to copy them as they are</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL on failure</returns>
+err_t workers_convert_array(struct workers_t* workers, mem dest, cmem src, u64 width, u64 count, i32 swap);
+
+/// <summary>
+/// stops and joins the threads of a pool
+/// </summary>
+/// <param name="workers">- address of the pool pointer, which is nulled</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_THREAD_FAIL on failure</returns>
+err_t workers_destroy(struct workers_t** workers);
+
+#endif
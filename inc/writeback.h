@@ -0,0 +1,61 @@
+#ifndef WRITEBACK_H
+
+#define WRITEBACK_H
+
+#include "error.h"
+
+// number of writes a queue holds by default before writeback_submit reports it full
+#define WRITEBACK_CAPACITY 64
+
+// most writes taken off the queue at once, written back to back and then synced together
+#define WRITEBACK_BATCH 16
+
+// appended to the path of each write to name the file it is written to before replacing its target
+#define WRITEBACK_SUFFIX ".tmp"
+
+// opaque type for a queue of file writes carried out by a background thread
+struct writeback_t;
+
+struct allocator_t;
+
+/// <summary>
+/// starts the background thread of a bounded write-behind queue
+/// </summary>
+/// <param name="writeback">- address of the null queue pointer</param>
+/// <param name="capacity">- number of writes the queue holds, or 0 for WRITEBACK_CAPACITY</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_PARAM_NOTNULL, ERROR_ALLOC_FAIL or ERROR_THREAD_FAIL on failure</returns>
+err_t writeback_create(struct writeback_t** writeback, u32 capacity);
+
+/// <summary>
+/// queues a buffer to replace the contents of a file, returning without waiting on the disk. The file is written under a temporary name, synced and renamed over its target, so it is never seen half written.
+/// </summary>
+/// <param name="writeback">- address of the queue</param>
+/// <param name="path">- path of the file, copied by the queue</param>
+/// <param name="buffer">- bytes to write. The queue takes ownership on success and frees it with the allocator once written; on failure it stays the caller's.</param>
+/// <param name="length">- number of bytes to write</param>
+/// <param name="allocator">- allocator the buffer came from, or null for the system allocator that buffer_create uses</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_ALLOC_FAIL or ERROR_QUEUE_FULL on failure</returns>
+err_t writeback_submit(struct writeback_t* writeback, cstr path, mem buffer, u64 length, const struct allocator_t* allocator);
+
+/// <summary>
+/// fetches the number of writes queued or being written, without waiting
+/// </summary>
+/// <param name="writeback">- address of the queue</param>
+/// <returns>number of writes not yet finished, or 0 for a null queue</returns>
+u32 writeback_pending(struct writeback_t* writeback);
+
+/// <summary>
+/// waits until every write submitted so far is durable on the disk
+/// </summary>
+/// <param name="writeback">- address of the queue</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, or the first error a write met since the last flush on failure</returns>
+err_t writeback_flush(struct writeback_t* writeback);
+
+/// <summary>
+/// finishes every queued write, then stops and joins the background thread
+/// </summary>
+/// <param name="writeback">- address of the queue pointer, which is nulled</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_THREAD_FAIL, or the first error a write met since the last flush on failure</returns>
+err_t writeback_destroy(struct writeback_t** writeback);
+
+#endif
@@ -4,8 +4,52 @@
 
 #include "error.h"
 
+/// <summary>one contiguous run of bytes written by writer_segments, such as a header, a payload or padding</summary>
+typedef struct writer_segment_t {
+	cmem data;
+	u64 size;
+} writer_segment_t;
+
 err_t writer_string(cstr path, cstr content);
 
-err_t writer_binary(cstr path, const byte* buffer);
+/// <summary>
+/// writes exactly length bytes of a buffer to a file, replacing its contents
+/// </summary>
+/// <param name="path">- path of the file</param>
+/// <param name="buffer">- bytes to write, such as serialized data sized by container_size</param>
+/// <param name="length">- number of bytes to write</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_UNOPENABLE_FILE, ERROR_UNWRITABLE_FILE or ERROR_UNCLOSEABLE_FILE on failure</returns>
+err_t writer_binary(cstr path, const byte* buffer, u64 length);
+
+/// <summary>
+/// writes a list of segments back to back to a file, replacing its contents, without first concatenating them
+/// </summary>
+/// <param name="path">- path of the file</param>
+/// <param name="segments">- segments in the order they are written</param>
+/// <param name="count">- number of segments</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_UNOPENABLE_FILE, ERROR_UNWRITABLE_FILE or ERROR_UNCLOSEABLE_FILE on failure</returns>
+err_t writer_segments(cstr path, const writer_segment_t* segments, u64 count);
+
+/// <summary>
+/// flushes the written contents of a file from the system cache to the disk
+/// </summary>
+/// <param name="path">- path of the file</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_UNOPENABLE_FILE, ERROR_UNWRITABLE_FILE or ERROR_UNCLOSEABLE_FILE on failure</returns>
+err_t writer_sync(cstr path);
+
+/// <summary>
+/// flushes the directory entries of the directory holding a file, making renames into it durable; windows renames are written through instead
+/// </summary>
+/// <param name="path">- path of a file in the directory</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_ALLOC_FAIL, ERROR_UNOPENABLE_FILE or ERROR_UNWRITABLE_FILE on failure</returns>
+err_t writer_sync_directory(cstr path);
+
+/// <summary>
+/// atomically replaces a file with another, so readers see either the old contents or the new ones in full
+/// </summary>
+/// <param name="from">- path of the new file, which no longer exists afterwards</param>
+/// <param name="to">- path of the file to replace, which need not exist</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_UNWRITABLE_FILE on failure</returns>
+err_t writer_replace(cstr from, cstr to);
 
 #endif
@@ -0,0 +1,368 @@
+#include "allocator.h"
+
+#include "memory.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/// <summary>a chunk of arena memory, whose bytes follow the header</summary>
+typedef struct arena_chunk_t {
+	struct arena_chunk_t* next;
+	u64 capacity;
+} arena_chunk_t;
+
+typedef struct arena_t {
+	allocator_t allocator;
+	arena_chunk_t* first;
+	arena_chunk_t* current;
+	// bytes of the current chunk already handed out
+	u64 used;
+	u64 capacity;
+} arena_t;
+
+/// <summary>a free block of a pool, linked through its own bytes</summary>
+typedef struct pool_block_t {
+	struct pool_block_t* next;
+} pool_block_t;
+
+/// <summary>a slab of pool blocks, whose blocks follow the header padded to the pool alignment</summary>
+typedef struct pool_slab_t {
+	struct pool_slab_t* next;
+} pool_slab_t;
+
+typedef struct pool_t {
+	allocator_t allocator;
+	pool_slab_t* slabs;
+	pool_block_t* free;
+	u64 block_size;
+	u64 alignment;
+	u64 blocks;
+} pool_t;
+
+/// <summary>
+/// rounds a size up to a multiple of a power of two
+/// </summary>
+/// <param name="size">- size in bytes</param>
+/// <param name="alignment">- power of two</param>
+/// <returns>the rounded size</returns>
+static u64 allocator_round(u64 size, u64 alignment)
+{
+	return (size + alignment - 1) & ~(alignment - 1);
+}
+
+static err_t system_alloc(ptr state, mem* memory, u64 size, u64 alignment)
+{
+	(void)state;
+
+	return memory_aligned_alloc(memory, size, alignment);
+}
+
+static err_t system_free(ptr state, mem* memory)
+{
+	(void)state;
+
+	return memory_aligned_free(memory);
+}
+
+static const allocator_t system_allocator = { system_alloc, system_free, NULL };
+
+const allocator_t* allocator_system(void)
+{
+	return &system_allocator;
+}
+
+err_t allocator_alloc(const allocator_t* allocator, mem* memory, u64 size, u64 alignment)
+{
+	if (memory == NULL) return error_param_null("memory", __FILE__, __LINE__);
+	if (*memory != NULL) return error_param_notnull("*memory", __FILE__, __LINE__);
+
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0) return error_not_power_of_two("alignment", alignment, __FILE__, __LINE__);
+
+	if (allocator == NULL) allocator = &system_allocator;
+
+	return allocator->alloc(allocator->state, memory, size, alignment);
+}
+
+err_t allocator_free(const allocator_t* allocator, mem* memory)
+{
+	if (memory == NULL) return error_param_null("memory", __FILE__, __LINE__);
+
+	if (*memory == NULL) return ERROR_NONE;
+
+	if (allocator == NULL) allocator = &system_allocator;
+
+	return allocator->free(allocator->state, memory);
+}
+
+/// <summary>
+/// allocates a chunk able to hold at least capacity bytes
+/// </summary>
+/// <param name="chunk">- address of the null chunk pointer</param>
+/// <param name="capacity">- size of the chunk in bytes</param>
+/// <returns>ERROR_NONE on success, ERROR_ALLOC_FAIL on failure</returns>
+static err_t arena_chunk_create(arena_chunk_t** chunk, u64 capacity)
+{
+	if (capacity > UINT64_MAX - sizeof(arena_chunk_t)) return error_alloc_fail("arena_chunk_t", capacity, __FILE__, __LINE__);
+
+	err_t err = memory_aligned_alloc((mem*)chunk, sizeof(arena_chunk_t) + capacity, MEMORY_ALIGNMENT);
+
+	if (err != ERROR_NONE) return err;
+
+	(*chunk)->next = NULL;
+	(*chunk)->capacity = capacity;
+
+	return ERROR_NONE;
+}
+
+static err_t arena_alloc(ptr state, mem* memory, u64 size, u64 alignment)
+{
+	arena_t* arena = (arena_t*)state;
+
+	// zero-sized requests still take a byte so that every allocation is unique
+	u64 length = size > 0 ? size : 1;
+
+	if (length > UINT64_MAX - alignment) return error_alloc_fail("mem", size, __FILE__, __LINE__);
+
+	forever
+	{
+		arena_chunk_t* chunk = arena->current;
+
+		uptr base = (uptr)(chunk + 1);
+		uptr start = (base + arena->used + alignment - 1) & ~(uptr)(alignment - 1);
+
+		if (start - base <= chunk->capacity && length <= chunk->capacity - (start - base))
+		{
+			*memory = (mem)start;
+			arena->used = start - base + length;
+
+			return ERROR_NONE;
+		}
+
+		// chunks kept from before a reset are reused in order, and a new one is linked in when the next is too small
+		if (chunk->next == NULL || chunk->next->capacity < length + alignment)
+		{
+			arena_chunk_t* next = NULL;
+
+			err_t err = arena_chunk_create(&next, length + alignment > arena->capacity ? length + alignment : arena->capacity);
+
+			if (err != ERROR_NONE) return err;
+
+			next->next = chunk->next;
+			chunk->next = next;
+		}
+
+		arena->current = chunk->next;
+		arena->used = 0;
+	}
+}
+
+static err_t arena_free(ptr state, mem* memory)
+{
+	(void)state;
+
+	// the memory stays reserved until the arena is reset
+	*memory = NULL;
+
+	return ERROR_NONE;
+}
+
+err_t arena_create(arena_t** arena, u64 capacity)
+{
+	if (arena == NULL) return error_param_null("arena", __FILE__, __LINE__);
+	if (*arena != NULL) return error_param_notnull("*arena", __FILE__, __LINE__);
+
+	if (capacity == 0) return error_param_null("capacity", __FILE__, __LINE__);
+
+	*arena = (arena_t*)malloc(sizeof(arena_t));
+
+	if (*arena == NULL) return error_alloc_fail("arena_t", sizeof(arena_t), __FILE__, __LINE__);
+
+	(*arena)->first = NULL;
+
+	err_t err = arena_chunk_create(&(*arena)->first, capacity);
+
+	if (err != ERROR_NONE)
+	{
+		free(*arena);
+		*arena = NULL;
+
+		return err;
+	}
+
+	(*arena)->allocator.alloc = arena_alloc;
+	(*arena)->allocator.free = arena_free;
+	(*arena)->allocator.state = *arena;
+	(*arena)->current = (*arena)->first;
+	(*arena)->used = 0;
+	(*arena)->capacity = capacity;
+
+	return ERROR_NONE;
+}
+
+const allocator_t* arena_allocator(arena_t* arena)
+{
+	if (arena == NULL) return NULL;
+
+	return &arena->allocator;
+}
+
+err_t arena_reset(arena_t* arena)
+{
+	if (arena == NULL) return error_param_null("arena", __FILE__, __LINE__);
+
+	arena->current = arena->first;
+	arena->used = 0;
+
+	return ERROR_NONE;
+}
+
+err_t arena_destroy(arena_t** arena)
+{
+	if (arena == NULL) return error_param_null("arena", __FILE__, __LINE__);
+	if (*arena == NULL) return error_param_null("*arena", __FILE__, __LINE__);
+
+	arena_chunk_t* chunk = (*arena)->first;
+
+	while (chunk != NULL)
+	{
+		arena_chunk_t* next = chunk->next;
+
+		memory_aligned_free((mem*)&chunk);
+
+		chunk = next;
+	}
+
+	free(*arena);
+	*arena = NULL;
+
+	return ERROR_NONE;
+}
+
+/// <summary>
+/// allocates another slab for a pool and threads its blocks onto the free list
+/// </summary>
+/// <param name="pool">- address of the pool</param>
+/// <returns>ERROR_NONE on success, ERROR_ALLOC_FAIL on failure</returns>
+static err_t pool_grow(pool_t* pool)
+{
+	u64 header = allocator_round(sizeof(pool_slab_t), pool->alignment);
+
+	if (pool->blocks > (UINT64_MAX - header) / pool->block_size) return error_alloc_fail("pool_slab_t", pool->blocks, __FILE__, __LINE__);
+
+	pool_slab_t* slab = NULL;
+
+	err_t err = memory_aligned_alloc((mem*)&slab, header + pool->blocks * pool->block_size, pool->alignment);
+
+	if (err != ERROR_NONE) return err;
+
+	slab->next = pool->slabs;
+	pool->slabs = slab;
+
+	byte* blocks = (byte*)slab + header;
+
+	// threaded back to front so that blocks are handed out in address order
+	for (u64 i = pool->blocks; i > 0; --i)
+	{
+		pool_block_t* block = (pool_block_t*)(blocks + (i - 1) * pool->block_size);
+
+		block->next = pool->free;
+		pool->free = block;
+	}
+
+	return ERROR_NONE;
+}
+
+static err_t pool_alloc(ptr state, mem* memory, u64 size, u64 alignment)
+{
+	pool_t* pool = (pool_t*)state;
+
+	if (size > pool->block_size) return error_size_mismatch(pool->block_size, size, __FILE__, __LINE__);
+	if (alignment > pool->alignment) return error_misaligned_buffer("pool block", alignment, __FILE__, __LINE__);
+
+	if (pool->free == NULL)
+	{
+		err_t err = pool_grow(pool);
+
+		if (err != ERROR_NONE) return err;
+	}
+
+	*memory = pool->free;
+	pool->free = pool->free->next;
+
+	return ERROR_NONE;
+}
+
+static err_t pool_free(ptr state, mem* memory)
+{
+	pool_t* pool = (pool_t*)state;
+
+	pool_block_t* block = (pool_block_t*)*memory;
+
+	block->next = pool->free;
+	pool->free = block;
+
+	*memory = NULL;
+
+	return ERROR_NONE;
+}
+
+err_t pool_create(pool_t** pool, u64 block_size, u64 alignment, u64 blocks)
+{
+	if (pool == NULL) return error_param_null("pool", __FILE__, __LINE__);
+	if (*pool != NULL) return error_param_notnull("*pool", __FILE__, __LINE__);
+
+	if (block_size == 0) return error_param_null("block_size", __FILE__, __LINE__);
+	if (blocks == 0) return error_param_null("blocks", __FILE__, __LINE__);
+
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0) return error_not_power_of_two("alignment", alignment, __FILE__, __LINE__);
+
+	// every block must be able to hold the free list link and start on an aligned address
+	if (alignment < sizeof(pool_block_t)) alignment = sizeof(pool_block_t);
+	if (block_size < sizeof(pool_block_t)) block_size = sizeof(pool_block_t);
+
+	if (block_size > UINT64_MAX - alignment) return error_alloc_fail("pool block", block_size, __FILE__, __LINE__);
+
+	*pool = (pool_t*)malloc(sizeof(pool_t));
+
+	if (*pool == NULL) return error_alloc_fail("pool_t", sizeof(pool_t), __FILE__, __LINE__);
+
+	(*pool)->allocator.alloc = pool_alloc;
+	(*pool)->allocator.free = pool_free;
+	(*pool)->allocator.state = *pool;
+	(*pool)->slabs = NULL;
+	(*pool)->free = NULL;
+	(*pool)->block_size = allocator_round(block_size, alignment);
+	(*pool)->alignment = alignment;
+	(*pool)->blocks = blocks;
+
+	return ERROR_NONE;
+}
+
+const allocator_t* pool_allocator(pool_t* pool)
+{
+	if (pool == NULL) return NULL;
+
+	return &pool->allocator;
+}
+
+err_t pool_destroy(pool_t** pool)
+{
+	if (pool == NULL) return error_param_null("pool", __FILE__, __LINE__);
+	if (*pool == NULL) return error_param_null("*pool", __FILE__, __LINE__);
+
+	pool_slab_t* slab = (*pool)->slabs;
+
+	while (slab != NULL)
+	{
+		pool_slab_t* next = slab->next;
+
+		memory_aligned_free((mem*)&slab);
+
+		slab = next;
+	}
+
+	free(*pool);
+	*pool = NULL;
+
+	return ERROR_NONE;
+}
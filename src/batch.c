@@ -0,0 +1,201 @@
+#include "batch.h"
+
+#include <GL/glew.h>
+
+#include "buffer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/// <summary>bytes of the staging memory to copy into a buffer</summary>
+typedef struct batch_entry_t
+{
+	u32 buffer;
+	u64 offset;
+	// offset of the bytes in the staging memory
+	u64 source;
+	u64 size;
+} batch_entry_t;
+
+typedef struct batch_t
+{
+	u64 capacity;
+
+	// queued bytes, one after the other in the order they were written
+	byte* memory;
+	u64 used;
+	u64 reserved;
+
+	batch_entry_t* entries;
+	u32 count;
+	u32 entry_capacity;
+
+	// buffer the memory is sent to, respecified at every flush so copies still running never stall it
+	u32 staging;
+} batch_t;
+
+err_t batch_create(batch_t** batch, u64 capacity)
+{
+	if (batch == NULL) return error_param_null("batch", __FILE__, __LINE__);
+	if (*batch != NULL) return error_param_notnull("*batch", __FILE__, __LINE__);
+
+	batch_t* creating = (batch_t*)calloc(1, sizeof(batch_t));
+
+	if (creating == NULL) return error_alloc_fail("batch_t", sizeof(batch_t), __FILE__, __LINE__);
+
+	creating->capacity = capacity != 0 ? capacity : BATCH_CAPACITY;
+
+	*batch = creating;
+
+	return ERROR_NONE;
+}
+
+err_t batch_write(batch_t* batch, u32 buffer, u64 offset, cmem data, u64 size)
+{
+	if (batch == NULL) return error_param_null("batch", __FILE__, __LINE__);
+	if (data == NULL) return error_param_null("data", __FILE__, __LINE__);
+
+	if (size == 0) return ERROR_NONE;
+
+	// queued writes go first, so a later write to the same bytes still wins
+	if (batch->used + size > batch->capacity) batch_flush(batch);
+
+	if (size > batch->capacity)
+	{
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data);
+
+		return ERROR_NONE;
+	}
+
+	if (batch->used + size > batch->reserved)
+	{
+		u64 reserved = batch->reserved > 0 ? batch->reserved : 64 * 1024;
+
+		while (reserved < batch->used + size) reserved *= 2;
+
+		if (reserved > batch->capacity) reserved = batch->capacity;
+
+		byte* memory = (byte*)realloc(batch->memory, reserved);
+
+		if (memory == NULL) return error_alloc_fail("byte", reserved, __FILE__, __LINE__);
+
+		batch->memory = memory;
+		batch->reserved = reserved;
+	}
+
+	batch_entry_t* last = batch->count > 0 ? &batch->entries[batch->count - 1] : NULL;
+
+	// a write continuing the last one in the same buffer extends it, so filling a buffer piece by piece is still one copy
+	if (last != NULL && last->buffer == buffer && last->offset + last->size == offset) last->size += size;
+	else
+	{
+		if (batch->count == batch->entry_capacity)
+		{
+			u32 capacity = batch->entry_capacity > 0 ? batch->entry_capacity * 2 : 64;
+
+			batch_entry_t* entries = (batch_entry_t*)realloc(batch->entries, capacity * sizeof(batch_entry_t));
+
+			if (entries == NULL) return error_alloc_fail("batch_entry_t", capacity * sizeof(batch_entry_t), __FILE__, __LINE__);
+
+			batch->entries = entries;
+			batch->entry_capacity = capacity;
+		}
+
+		batch_entry_t* entry = &batch->entries[batch->count++];
+
+		entry->buffer = buffer;
+		entry->offset = offset;
+		entry->source = batch->used;
+		entry->size = size;
+	}
+
+	memcpy(batch->memory + batch->used, data, size);
+
+	batch->used += size;
+
+	return ERROR_NONE;
+}
+
+err_t batch_buffer_create(batch_t* batch, u32* buffer, u32 target, cmem data, u64 size, u32 mode)
+{
+	if (batch == NULL) return error_param_null("batch", __FILE__, __LINE__);
+	if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
+	if (data == NULL) return error_param_null("data", __FILE__, __LINE__);
+
+	if (buffer_draw_mode_valid(mode) != DRAW_MODE_VALID) return error_invalid_enum("mode", mode, __FILE__, __LINE__);
+
+	// only storage is reserved here, which costs no transfer; the contents arrive with the rest of the batch
+	glGenBuffers(1, buffer);
+
+	glBindBuffer(target, *buffer);
+	glBufferData(target, size, NULL, mode);
+
+	err_t err = batch_write(batch, *buffer, 0, data, size);
+
+	if (err != ERROR_NONE)
+	{
+		glDeleteBuffers(1, buffer);
+		*buffer = 0;
+	}
+
+	return err;
+}
+
+u64 batch_pending(batch_t* batch)
+{
+	if (batch == NULL) return 0;
+
+	return batch->used;
+}
+
+err_t batch_flush(batch_t* batch)
+{
+	if (batch == NULL) return error_param_null("batch", __FILE__, __LINE__);
+
+	if (batch->count == 0) return ERROR_NONE;
+
+	if (batch->staging == 0) glGenBuffers(1, &batch->staging);
+
+	glBindBuffer(GL_COPY_READ_BUFFER, batch->staging);
+	glBufferData(GL_COPY_READ_BUFFER, batch->used, batch->memory, GL_STREAM_DRAW);
+
+	u32 bound = 0;
+
+	for (u32 i = 0; i < batch->count; ++i)
+	{
+		const batch_entry_t* entry = &batch->entries[i];
+
+		if (entry->buffer != bound)
+		{
+			glBindBuffer(GL_COPY_WRITE_BUFFER, entry->buffer);
+
+			bound = entry->buffer;
+		}
+
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, entry->source, entry->offset, entry->size);
+	}
+
+	batch->used = 0;
+	batch->count = 0;
+
+	return ERROR_NONE;
+}
+
+err_t batch_destroy(batch_t** batch)
+{
+	if (batch == NULL) return error_param_null("batch", __FILE__, __LINE__);
+	if (*batch == NULL) return error_param_null("*batch", __FILE__, __LINE__);
+
+	batch_t* destroying = *batch;
+
+	if (destroying->staging != 0) glDeleteBuffers(1, &destroying->staging);
+
+	free(destroying->memory);
+	free(destroying->entries);
+	free(destroying);
+
+	*batch = NULL;
+
+	return ERROR_NONE;
+}
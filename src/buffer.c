@@ -3,20 +3,18 @@
 #include "error.h"
 
 #include "color.h"
+#include "container.h"
+#include "indices.h"
+#include "layout.h"
+#include "quantize.h"
 
 #include "vec2.h"
 #include "vec3.h"
 #include "vec4.h"
 
-int buffer_type_valid(u32 type);
+#include "buffer.h"
 
-#define BUFFER_TYPE_VALID 1
-#define BUFFER_TYPE_INVALID 0
-
-int buffer_draw_mode_valid(u32 mode);
-
-#define DRAW_MODE_VALID 1
-#define DRAW_MODE_INVALID 0
+#include <stdlib.h>
 
 err_t index_buffer_create(u32* buffer, const u8* data, u64 count)
 {
@@ -41,7 +39,7 @@ err_t index_buffer_create_ex(u32* buffer, const u8* data, u64 count, u32 mode)
 	glGenBuffers(1, buffer);
 
 	glBindBuffer(GL_ARRAY_BUFFER, *buffer);
-	glBufferData(GL_ARRAY_BUFFER, count * sizeof(u8), data, GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, count * sizeof(u8), data, mode);
 
 	return ERROR_NONE;
 }
@@ -69,7 +67,7 @@ err_t color_buffer_create_ex(u32* buffer, const struct color_t* data, u64 count,
 	glGenBuffers(1, buffer);
 
 	glBindBuffer(GL_ARRAY_BUFFER, *buffer);
-	glBufferData(GL_ARRAY_BUFFER, count * sizeof(color_t), data, GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, count * sizeof(color_t), data, mode);
 
 	return ERROR_NONE;
 }
@@ -97,11 +95,75 @@ err_t element_buffer_create_ex(u32* buffer, const u32* data, u64 count, u32 mode
 	glGenBuffers(1, buffer);
 
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *buffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(u32), data, GL_STATIC_DRAW);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(u32), data, mode);
 
 	return ERROR_NONE;
 }
 
+err_t element_buffer_create_typed(u32* buffer, u32* index_type, cmem data, u64 count, container_type_t type)
+{
+	if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
+	if (index_type == NULL) return error_param_null("index_type", __FILE__, __LINE__);
+	if (data == NULL) return error_param_null("data", __FILE__, __LINE__);
+
+	u16* widened = NULL;
+
+	switch (type)
+	{
+		case CONTAINER_TYPE_U8:
+			// byte indices are valid gl but emulated by several drivers, so they are uploaded as shorts instead
+			widened = (u16*)malloc(count > 0 ? count * sizeof(u16) : 1);
+
+			if (widened == NULL) return error_alloc_fail("u16", count * sizeof(u16), __FILE__, __LINE__);
+
+			for (u64 i = 0; i < count; ++i) widened[i] = ((const u8*)data)[i];
+
+			data = widened;
+			*index_type = GL_UNSIGNED_SHORT;
+			break;
+		case CONTAINER_TYPE_U16:
+			*index_type = GL_UNSIGNED_SHORT;
+			break;
+		case CONTAINER_TYPE_U32:
+			*index_type = GL_UNSIGNED_INT;
+			break;
+		default:
+			return error_unknown_enum("container_type_t", (i32)type, __FILE__, __LINE__);
+	}
+
+	u64 index_size = *index_type == GL_UNSIGNED_SHORT ? sizeof(u16) : sizeof(u32);
+
+	glGenBuffers(1, buffer);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *buffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * index_size, data, GL_STATIC_DRAW);
+
+	free(widened);
+
+	return ERROR_NONE;
+}
+
+err_t element_buffer_create_narrow(u32* buffer, u32* index_type, const u32* data, u64 count)
+{
+	if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
+	if (index_type == NULL) return error_param_null("index_type", __FILE__, __LINE__);
+	if (data == NULL) return error_param_null("data", __FILE__, __LINE__);
+
+	if (indices_narrowest(data, count) == CONTAINER_TYPE_U32) return element_buffer_create_typed(buffer, index_type, data, count, CONTAINER_TYPE_U32);
+
+	u16* narrowed = (u16*)malloc(count > 0 ? count * sizeof(u16) : 1);
+
+	if (narrowed == NULL) return error_alloc_fail("u16", count * sizeof(u16), __FILE__, __LINE__);
+
+	indices_narrow(narrowed, data, count, CONTAINER_TYPE_U16);
+
+	err_t err = element_buffer_create_typed(buffer, index_type, narrowed, count, CONTAINER_TYPE_U16);
+
+	free(narrowed);
+
+	return err;
+}
+
 err_t vec2_buffer_create(u32* buffer, const struct vec2_t* data, u64 count)
 {
 	if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
@@ -125,7 +187,7 @@ err_t vec2_buffer_create_ex(u32* buffer, const struct vec2_t* data, u64 count, u
 	glGenBuffers(1, buffer);
 
 	glBindBuffer(GL_ARRAY_BUFFER, *buffer);
-	glBufferData(GL_ARRAY_BUFFER, count * sizeof(vec2_t), data, GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, count * sizeof(vec2_t), data, mode);
 
 	return ERROR_NONE;
 }
@@ -153,7 +215,7 @@ err_t vec3_buffer_create_ex(u32* buffer, const struct vec3_t* data, u64 count, u
 	glGenBuffers(1, buffer);
 
 	glBindBuffer(GL_ARRAY_BUFFER, *buffer);
-	glBufferData(GL_ARRAY_BUFFER, count * sizeof(vec3_t), data, GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, count * sizeof(vec3_t), data, mode);
 
 	return ERROR_NONE;
 }
@@ -181,7 +243,118 @@ err_t vec4_buffer_create_ex(u32* buffer, const struct vec4_t* data, u64 count, u
 	glGenBuffers(1, buffer);
 
 	glBindBuffer(GL_ARRAY_BUFFER, *buffer);
-	glBufferData(GL_ARRAY_BUFFER, count * sizeof(vec4_t), data, GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, count * sizeof(vec4_t), data, mode);
+
+	return ERROR_NONE;
+}
+
+err_t quantized_buffer_create_ex(u32* buffer, cmem data, u64 count, u32 components, quantize_format_t format, u32 mode)
+{
+	if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
+	if (data == NULL) return error_param_null("data", __FILE__, __LINE__);
+
+	if (buffer_draw_mode_valid(mode) != DRAW_MODE_VALID) return error_invalid_enum("mode", mode, __FILE__, __LINE__);
+
+	u64 component_size = quantize_format_size(format);
+
+	if (component_size == 0) return error_unknown_enum("quantize_format_t", (i32)format, __FILE__, __LINE__);
+
+	glGenBuffers(1, buffer);
+
+	glBindBuffer(GL_ARRAY_BUFFER, *buffer);
+	glBufferData(GL_ARRAY_BUFFER, count * components * component_size, data, mode);
+
+	return ERROR_NONE;
+}
+
+err_t quantized_buffer_create(u32* buffer, cmem data, u64 count, u32 components, quantize_format_t format)
+{
+	return quantized_buffer_create_ex(buffer, data, count, components, format, GL_STATIC_DRAW);
+}
+
+err_t interleaved_buffer_create_ex(u32* buffer, cmem data, u64 count, const layout_t* layout, u32 mode)
+{
+	if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
+	if (data == NULL) return error_param_null("data", __FILE__, __LINE__);
+	if (layout == NULL) return error_param_null("layout", __FILE__, __LINE__);
+
+	if (buffer_draw_mode_valid(mode) != DRAW_MODE_VALID) return error_invalid_enum("mode", mode, __FILE__, __LINE__);
+
+	// every attribute of every vertex goes up in a single transfer, to be bound with layout_apply
+	glGenBuffers(1, buffer);
+
+	glBindBuffer(GL_ARRAY_BUFFER, *buffer);
+	glBufferData(GL_ARRAY_BUFFER, count * layout->stride, data, mode);
+
+	return ERROR_NONE;
+}
+
+err_t interleaved_buffer_create(u32* buffer, cmem data, u64 count, const layout_t* layout)
+{
+	return interleaved_buffer_create_ex(buffer, data, count, layout, GL_STATIC_DRAW);
+}
+
+err_t array_buffer_create_ex(u32* buffer, cmem data, u64 count, container_type_t type, u32 components, u32 mode)
+{
+	if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
+	if (data == NULL) return error_param_null("data", __FILE__, __LINE__);
+
+	if (buffer_draw_mode_valid(mode) != DRAW_MODE_VALID) return error_invalid_enum("mode", mode, __FILE__, __LINE__);
+
+	u64 type_size = container_type_size(type);
+
+	if (type_size == 0) return error_unknown_enum("container_type_t", (i32)type, __FILE__, __LINE__);
+
+	// any densely packed deserialized array goes up as is, leaving the attribute format to the caller
+	glGenBuffers(1, buffer);
+
+	glBindBuffer(GL_ARRAY_BUFFER, *buffer);
+	glBufferData(GL_ARRAY_BUFFER, count * components * type_size, data, mode);
+
+	return ERROR_NONE;
+}
+
+err_t array_buffer_create(u32* buffer, cmem data, u64 count, container_type_t type, u32 components)
+{
+	return array_buffer_create_ex(buffer, data, count, type, components, GL_STATIC_DRAW);
+}
+
+err_t quantized_attribute_format(quantize_format_t format, u32* type, u8* normalized)
+{
+	if (type == NULL) return error_param_null("type", __FILE__, __LINE__);
+	if (normalized == NULL) return error_param_null("normalized", __FILE__, __LINE__);
+
+	// the gpu expands every format to floats as it fetches the attribute, so shaders keep their vecN inputs
+	switch (format)
+	{
+		case QUANTIZE_FORMAT_F16:
+			*type = GL_HALF_FLOAT;
+			*normalized = GL_FALSE;
+			return ERROR_NONE;
+		case QUANTIZE_FORMAT_SNORM16:
+			*type = GL_SHORT;
+			*normalized = GL_TRUE;
+			return ERROR_NONE;
+		case QUANTIZE_FORMAT_UNORM8:
+			*type = GL_UNSIGNED_BYTE;
+			*normalized = GL_TRUE;
+			return ERROR_NONE;
+		default:
+			return error_unknown_enum("quantize_format_t", (i32)format, __FILE__, __LINE__);
+	}
+}
+
+err_t quantized_attribute_pointer(u32 index, u32 components, quantize_format_t format, u32 stride, u64 offset)
+{
+	u32 type;
+	u8 normalized;
+
+	err_t err = quantized_attribute_format(format, &type, &normalized);
+
+	if (err != ERROR_NONE) return err;
+
+	glVertexAttribPointer(index, components, type, normalized, stride, (const void*)(uptr)offset);
+	glEnableVertexAttribArray(index);
 
 	return ERROR_NONE;
 }
@@ -0,0 +1,430 @@
+#include "compress.h"
+
+#include "endian.h"
+#include "workers.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// shortest match worth encoding
+#define COMPRESS_MIN_MATCH 4
+
+// the final bytes of a block are always literals, so the decoder can copy them without a match check
+#define COMPRESS_LAST_LITERALS 5
+
+// no match may start within this many bytes of the end of a block
+#define COMPRESS_MATCH_LIMIT 12
+
+// farthest a match can reach back, bounded by its 16-bit offset
+#define COMPRESS_MAX_OFFSET 65535
+
+// log2 of the number of entries in the match finder's hash table
+#define COMPRESS_HASH_LOG 12
+
+// blocks handed to a worker at a time, about WORKERS_GRAIN_BYTES of output each
+#define COMPRESS_GRAIN(block_size) ((block_size) < WORKERS_GRAIN_BYTES ? WORKERS_GRAIN_BYTES / (block_size) : 1)
+
+static u32 compress_read32(const byte* src)
+{
+	u32 value;
+
+	memcpy(&value, src, sizeof(u32));
+
+	return value;
+}
+
+static u32 compress_hash(u32 sequence)
+{
+	return (sequence * 2654435761u) >> (32 - COMPRESS_HASH_LOG);
+}
+
+/// <summary>
+/// writes the remainder of a length that overflowed its 4-bit token field as a run of 255s and a final byte
+/// </summary>
+/// <returns>address after the length, or null if it would pass the end of the destination</returns>
+static byte* compress_length(byte* op, const byte* end, u64 length)
+{
+	for (; length >= 255; length -= 255)
+	{
+		if (op >= end) return NULL;
+
+		*op++ = 255;
+	}
+
+	if (op >= end) return NULL;
+
+	*op++ = (byte)length;
+
+	return op;
+}
+
+/// <summary>
+/// writes one sequence of literals optionally followed by a match
+/// </summary>
+/// <returns>address after the sequence, or null if it would pass the end of the destination</returns>
+static byte* compress_sequence(byte* op, const byte* end, const byte* literals, u64 literal_length, u64 offset, u64 match_length)
+{
+	if (op >= end) return NULL;
+
+	byte* token = op++;
+
+	*token = (byte)((literal_length < 15 ? literal_length : 15) << 4);
+
+	if (literal_length >= 15 && (op = compress_length(op, end, literal_length - 15)) == NULL) return NULL;
+
+	if ((u64)(end - op) < literal_length) return NULL;
+
+	memcpy(op, literals, literal_length);
+	op += literal_length;
+
+	// the last sequence of a block carries no match
+	if (match_length == 0) return op;
+
+	if (end - op < 2) return NULL;
+
+	*op++ = (byte)(offset & 0xFF);
+	*op++ = (byte)(offset >> 8);
+
+	match_length -= COMPRESS_MIN_MATCH;
+
+	*token |= (byte)(match_length < 15 ? match_length : 15);
+
+	if (match_length >= 15 && (op = compress_length(op, end, match_length - 15)) == NULL) return NULL;
+
+	return op;
+}
+
+u64 compress_bound(u64 size)
+{
+	return size + size / 255 + 16;
+}
+
+err_t compress_block(byte* dest, u64 capacity, u64* written, const byte* src, u64 size)
+{
+	if (dest == NULL) return error_param_null("dest", __FILE__, __LINE__);
+	if (written == NULL) return error_param_null("written", __FILE__, __LINE__);
+
+	if (src == NULL && size > 0) return error_param_null("src", __FILE__, __LINE__);
+
+	u32 table[1 << COMPRESS_HASH_LOG];
+
+	memset(table, 0, sizeof(table));
+
+	const byte* end = dest + capacity;
+	byte* op = dest;
+
+	u64 anchor = 0;
+	u64 ip = 0;
+
+	while (size >= COMPRESS_MATCH_LIMIT && ip <= size - COMPRESS_MATCH_LIMIT)
+	{
+		u32 sequence = compress_read32(src + ip);
+		u32 hash = compress_hash(sequence);
+
+		// a stale or colliding entry is still a real earlier position, so comparing the bytes is enough
+		u64 ref = table[hash];
+
+		table[hash] = (u32)ip;
+
+		if (ref >= ip || ip - ref > COMPRESS_MAX_OFFSET || compress_read32(src + ref) != sequence)
+		{
+			++ip;
+			continue;
+		}
+
+		u64 match_length = COMPRESS_MIN_MATCH;
+		u64 match_end = size - COMPRESS_LAST_LITERALS;
+
+		while (ip + match_length < match_end && src[ref + match_length] == src[ip + match_length]) ++match_length;
+
+		op = compress_sequence(op, end, src + anchor, ip - anchor, ip - ref, match_length);
+
+		if (op == NULL)
+		{
+			*written = 0;
+			return ERROR_NONE;
+		}
+
+		ip += match_length;
+		anchor = ip;
+	}
+
+	op = compress_sequence(op, end, src + anchor, size - anchor, 0, 0);
+
+	*written = op != NULL ? (u64)(op - dest) : 0;
+
+	return ERROR_NONE;
+}
+
+err_t decompress_block(byte* dest, u64 size, const byte* src, u64 length)
+{
+	if (dest == NULL && size > 0) return error_param_null("dest", __FILE__, __LINE__);
+	if (src == NULL) return error_param_null("src", __FILE__, __LINE__);
+
+	const byte* ip = src;
+	const byte* ip_end = src + length;
+
+	byte* op = dest;
+	byte* op_end = dest + size;
+
+	forever
+	{
+		if (ip >= ip_end) return error_invalid_container("truncated block", __FILE__, __LINE__);
+
+		byte token = *ip++;
+
+		u64 literal_length = token >> 4;
+
+		if (literal_length == 15)
+		{
+			byte extra;
+
+			do
+			{
+				if (ip >= ip_end) return error_invalid_container("truncated block", __FILE__, __LINE__);
+
+				extra = *ip++;
+				literal_length += extra;
+			} while (extra == 255);
+		}
+
+		if ((u64)(ip_end - ip) < literal_length || (u64)(op_end - op) < literal_length) return error_invalid_container("literal overrun", __FILE__, __LINE__);
+
+		memcpy(op, ip, literal_length);
+		ip += literal_length;
+		op += literal_length;
+
+		// only the last sequence ends exactly at the end of the input
+		if (ip == ip_end) break;
+
+		if (ip_end - ip < 2) return error_invalid_container("truncated block", __FILE__, __LINE__);
+
+		u64 offset = (u64)ip[0] | ((u64)ip[1] << 8);
+
+		ip += 2;
+
+		if (offset == 0 || offset > (u64)(op - dest)) return error_invalid_container("match offset", __FILE__, __LINE__);
+
+		u64 match_length = token & 0x0F;
+
+		if (match_length == 15)
+		{
+			byte extra;
+
+			do
+			{
+				if (ip >= ip_end) return error_invalid_container("truncated block", __FILE__, __LINE__);
+
+				extra = *ip++;
+				match_length += extra;
+			} while (extra == 255);
+		}
+
+		match_length += COMPRESS_MIN_MATCH;
+
+		if ((u64)(op_end - op) < match_length) return error_invalid_container("match overrun", __FILE__, __LINE__);
+
+		const byte* match = op - offset;
+
+		// an overlapping match repeats its own output, so it must be copied forwards a byte at a time
+		if (offset >= match_length) memcpy(op, match, match_length);
+		else for (u64 i = 0; i < match_length; ++i) op[i] = match[i];
+
+		op += match_length;
+	}
+
+	if (op != op_end) return error_size_mismatch(size, (u64)(op - dest), __FILE__, __LINE__);
+
+	return ERROR_NONE;
+}
+
+u64 compress_blocks_bound(u64 size, u32 block_size)
+{
+	if (block_size == 0) return 0;
+
+	u64 blocks = (size + block_size - 1) / block_size;
+
+	// blocks that do not shrink are stored verbatim, so each costs at most its own size
+	return blocks * sizeof(u32) + size;
+}
+
+typedef struct compress_job_t
+{
+	byte* staging;
+	u64* stored;
+	const byte* src;
+	u64 size;
+	u32 block_size;
+} compress_job_t;
+
+/// <summary>
+/// compresses a range of blocks, each into its own block-sized slot of the staging buffer
+/// </summary>
+/// <param name="begin">- first block</param>
+/// <param name="end">- block after the last</param>
+/// <param name="user">- address of a compress_job_t</param>
+/// <returns>ERROR_NONE</returns>
+static err_t compress_range(u64 begin, u64 end, ptr user)
+{
+	const compress_job_t* job = (const compress_job_t*)user;
+
+	for (u64 i = begin; i < end; ++i)
+	{
+		u64 start = i * job->block_size;
+		u64 raw = job->size - start < job->block_size ? job->size - start : job->block_size;
+
+		// a block is only kept compressed if it comes out strictly smaller, so a stored size equal to the raw size marks a verbatim block
+		compress_block(job->staging + start, raw - 1, &job->stored[i], job->src + start, raw);
+
+		if (job->stored[i] == 0)
+		{
+			memcpy(job->staging + start, job->src + start, raw);
+			job->stored[i] = raw;
+		}
+	}
+
+	return ERROR_NONE;
+}
+
+err_t compress_blocks(byte* dest, u64* length, const byte* src, u64 size, u32 block_size, struct workers_t* workers)
+{
+	if (dest == NULL) return error_param_null("dest", __FILE__, __LINE__);
+	if (length == NULL) return error_param_null("length", __FILE__, __LINE__);
+
+	if (src == NULL && size > 0) return error_param_null("src", __FILE__, __LINE__);
+
+	if (block_size == 0 || block_size % 64 != 0) return error_size_indivisible(block_size, 64, __FILE__, __LINE__);
+	if (block_size > COMPRESS_BLOCK_SIZE_MAX) return error_size_mismatch(COMPRESS_BLOCK_SIZE_MAX, block_size, __FILE__, __LINE__);
+
+	u64 blocks = (size + block_size - 1) / block_size;
+
+	compress_job_t job;
+
+	job.staging = (byte*)malloc(size > 0 ? size : 1);
+	job.stored = (u64*)malloc(blocks > 0 ? blocks * sizeof(u64) : 1);
+	job.src = src;
+	job.size = size;
+	job.block_size = block_size;
+
+	err_t err = ERROR_NONE;
+
+	if (job.staging == NULL || job.stored == NULL) err = error_alloc_fail("byte", size + blocks * sizeof(u64), __FILE__, __LINE__);
+
+	// blocks compress independently into slots of their raw size, then are packed together behind the table in order
+	if (err == ERROR_NONE) err = workers_parallel_for(workers, blocks, COMPRESS_GRAIN(block_size), compress_range, &job);
+
+	if (err == ERROR_NONE)
+	{
+		byte* op = dest + blocks * sizeof(u32);
+
+		for (u64 i = 0; i < blocks; ++i)
+		{
+			u32 entry = (u32)job.stored[i];
+
+			memcpy(op, job.staging + i * block_size, job.stored[i]);
+			op += job.stored[i];
+
+			if (endianness_detect() != ENDIAN_LITTLE) endian_swap_u32s(&entry, &entry, 1);
+
+			memcpy(dest + i * sizeof(u32), &entry, sizeof(u32));
+		}
+
+		*length = (u64)(op - dest);
+	}
+
+	free(job.staging);
+	free(job.stored);
+
+	return err;
+}
+
+typedef struct decompress_job_t
+{
+	byte* dest;
+	u64 size;
+	const byte* src;
+	const u64* offsets;
+	u32 block_size;
+} decompress_job_t;
+
+/// <summary>
+/// decompresses a contiguous range of blocks, the unit of work handed to each worker
+/// </summary>
+/// <param name="begin">- first block</param>
+/// <param name="end">- block after the last</param>
+/// <param name="user">- address of a decompress_job_t</param>
+/// <returns>ERROR_NONE on success, ERROR_INVALID_CONTAINER or ERROR_SIZE_MISMATCH on failure</returns>
+static err_t decompress_range(u64 begin, u64 end, ptr user)
+{
+	const decompress_job_t* job = (const decompress_job_t*)user;
+
+	for (u64 i = begin; i < end; ++i)
+	{
+		u64 start = i * job->block_size;
+		u64 raw = job->size - start < job->block_size ? job->size - start : job->block_size;
+		u64 stored = job->offsets[i + 1] - job->offsets[i];
+
+		if (stored == raw)
+		{
+			memcpy(job->dest + start, job->src + job->offsets[i], raw);
+			continue;
+		}
+
+		err_t err = decompress_block(job->dest + start, raw, job->src + job->offsets[i], stored);
+
+		if (err != ERROR_NONE) return err;
+	}
+
+	return ERROR_NONE;
+}
+
+err_t decompress_blocks(byte* dest, u64 size, const byte* src, u64 length, u32 block_size, struct workers_t* workers)
+{
+	if (dest == NULL && size > 0) return error_param_null("dest", __FILE__, __LINE__);
+	if (src == NULL) return error_param_null("src", __FILE__, __LINE__);
+
+	if (block_size == 0 || block_size % 64 != 0 || block_size > COMPRESS_BLOCK_SIZE_MAX) return error_invalid_container("block size", __FILE__, __LINE__);
+
+	u64 blocks = (size + block_size - 1) / block_size;
+
+	if (blocks > length / sizeof(u32)) return error_invalid_container("block table", __FILE__, __LINE__);
+
+	u64* offsets = (u64*)malloc((blocks + 1) * sizeof(u64));
+
+	if (offsets == NULL) return error_alloc_fail("u64", (blocks + 1) * sizeof(u64), __FILE__, __LINE__);
+
+	// the block table is walked once up front so every worker knows where its blocks start
+	offsets[0] = blocks * sizeof(u32);
+
+	for (u64 i = 0; i < blocks; ++i)
+	{
+		u32 stored;
+
+		memcpy(&stored, src + i * sizeof(u32), sizeof(u32));
+
+		if (endianness_detect() != ENDIAN_LITTLE) endian_swap_u32s(&stored, &stored, 1);
+
+		offsets[i + 1] = offsets[i] + stored;
+
+		if (offsets[i + 1] > length)
+		{
+			free(offsets);
+
+			return error_invalid_container("block table", __FILE__, __LINE__);
+		}
+	}
+
+	decompress_job_t job;
+
+	job.dest = dest;
+	job.size = size;
+	job.src = src;
+	job.offsets = offsets;
+	job.block_size = block_size;
+
+	err_t err = workers_parallel_for(workers, blocks, COMPRESS_GRAIN(block_size), decompress_range, &job);
+
+	free(offsets);
+
+	return err;
+}
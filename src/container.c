@@ -0,0 +1,179 @@
+#include "container.h"
+
+#include "endian.h"
+#include "indices.h"
+
+#include <string.h>
+
+u64 container_type_size(container_type_t type)
+{
+	switch (type)
+	{
+		case CONTAINER_TYPE_U8: return sizeof(u8);
+		case CONTAINER_TYPE_U16: return sizeof(u16);
+		case CONTAINER_TYPE_U32: return sizeof(u32);
+		case CONTAINER_TYPE_U64: return sizeof(u64);
+		case CONTAINER_TYPE_F32: return sizeof(f32);
+		case CONTAINER_TYPE_F16: return sizeof(u16);
+		case CONTAINER_TYPE_I16: return sizeof(i16);
+
+		default: return 0;
+	}
+}
+
+/// <summary>
+/// reverses the byte order of every multi-byte field of a header
+/// </summary>
+/// <param name="header">- address of the header</param>
+static void container_swap(container_t* header)
+{
+	endian_swap_u16s(&header->version, &header->version, 1);
+	endian_swap_u32s(&header->components, &header->components, 1);
+	endian_swap_u32s(&header->stride, &header->stride, 1);
+	endian_swap_u64s(&header->count, &header->count, 1);
+	endian_swap_u64s(&header->length, &header->length, 1);
+	endian_swap_u64s(&header->offset, &header->offset, 1);
+	endian_swap_u32s(&header->flags, &header->flags, 1);
+	endian_swap_u32s(&header->block_size, &header->block_size, 1);
+	endian_swap_u64s(&header->stored, &header->stored, 1);
+}
+
+err_t container_init(container_t* header, container_type_t type, u32 components, u64 count)
+{
+	if (header == NULL) return error_param_null("header", __FILE__, __LINE__);
+
+	u64 type_size = container_type_size(type);
+
+	if (type_size == 0) return error_unknown_enum("container_type_t", (i32)type, __FILE__, __LINE__);
+
+	memset(header, 0, sizeof(container_t));
+	memcpy(header->magic, CONTAINER_MAGIC, sizeof(header->magic));
+
+	header->version = CONTAINER_VERSION;
+	header->endianness = ENDIAN_LITTLE;
+	header->type = (u8)type;
+	header->components = components;
+	header->stride = (u32)(type_size * components);
+	header->count = count;
+	header->length = count * header->stride;
+	header->stored = header->length;
+
+	// the header is padded out so the payload starts on an aligned boundary
+	header->offset = CONTAINER_OFFSET;
+
+	return ERROR_NONE;
+}
+
+err_t container_write(byte* buffer, const container_t* header)
+{
+	if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
+	if (header == NULL) return error_param_null("header", __FILE__, __LINE__);
+
+	container_t translator = *header;
+
+	if (translator.endianness != endianness_detect()) container_swap(&translator);
+
+	memcpy(buffer, &translator, sizeof(container_t));
+
+	return ERROR_NONE;
+}
+
+err_t container_read(container_t* header, const byte* buffer)
+{
+	if (header == NULL) return error_param_null("header", __FILE__, __LINE__);
+	if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
+
+	memcpy(header, buffer, sizeof(container_t));
+
+	if (memcmp(header->magic, CONTAINER_MAGIC, sizeof(header->magic)) != 0) return error_invalid_container("magic", __FILE__, __LINE__);
+
+	if (header->endianness != ENDIAN_LITTLE && header->endianness != ENDIAN_BIGLY) return error_invalid_container("endianness", __FILE__, __LINE__);
+
+	if (header->endianness != endianness_detect()) container_swap(header);
+
+	if (header->version == 0 || header->version > CONTAINER_VERSION) return error_invalid_container("version", __FILE__, __LINE__);
+
+	u64 type_size = container_type_size((container_type_t)header->type);
+
+	if (type_size == 0) return error_invalid_container("type", __FILE__, __LINE__);
+
+	if (header->components == 0 || header->stride < type_size * header->components) return error_invalid_container("stride", __FILE__, __LINE__);
+
+	if (header->offset < sizeof(container_t) || header->offset % CONTAINER_ALIGNMENT != 0) return error_invalid_container("offset", __FILE__, __LINE__);
+
+	// length must be exactly count strides, checked by division so a forged count cannot overflow the product
+	if (header->count == 0 ? header->length != 0 : header->length % header->count != 0 || header->length / header->count != header->stride) return error_invalid_container("length", __FILE__, __LINE__);
+
+	if ((header->flags & ~CONTAINER_FLAGS_KNOWN) != 0) return error_invalid_container("flags", __FILE__, __LINE__);
+
+	if (header->flags & CONTAINER_FLAG_INTERLEAVED)
+	{
+		if (header->flags & CONTAINER_FLAG_DELTA) return error_invalid_container("interleaved delta payload", __FILE__, __LINE__);
+
+		// vertices are opaque bytes to the container, and their layout table sits between the header and the payload
+		if (header->type != CONTAINER_TYPE_U8 || header->stride != header->components) return error_invalid_container("interleaved stride", __FILE__, __LINE__);
+
+		if (header->offset <= CONTAINER_OFFSET) return error_invalid_container("interleaved offset", __FILE__, __LINE__);
+	}
+
+	// version 1 predates compression and left the stored size zero
+	if (header->version == 1) header->stored = header->length;
+
+	if (header->flags & CONTAINER_FLAG_COMPRESSED)
+	{
+		if (header->flags & CONTAINER_FLAG_DELTA) return error_invalid_container("compressed delta payload", __FILE__, __LINE__);
+
+		if (header->block_size == 0 || header->block_size % CONTAINER_ALIGNMENT != 0) return error_invalid_container("block size", __FILE__, __LINE__);
+	}
+	else if (header->flags & CONTAINER_FLAG_DELTA)
+	{
+		if (header->type != CONTAINER_TYPE_U8 && header->type != CONTAINER_TYPE_U16 && header->type != CONTAINER_TYPE_U32) return error_invalid_container("delta type", __FILE__, __LINE__);
+
+		// every index takes between one byte and a full 32-bit varint
+		if (header->components != 1 || header->block_size != 0 || header->stored < header->count || header->stored / INDICES_VARINT_MAX > header->count) return error_invalid_container("stored length", __FILE__, __LINE__);
+	}
+	else if (header->block_size != 0 || header->stored != header->length) return error_invalid_container("stored length", __FILE__, __LINE__);
+
+	return ERROR_NONE;
+}
+
+err_t container_validate(const container_t* header, u64 length)
+{
+	if (header == NULL) return error_param_null("header", __FILE__, __LINE__);
+
+	// checked by subtraction so a forged offset or stored size cannot overflow the sum; the layout table of interleaved containers sits below the offset, so it is covered too
+	if (header->offset > length || header->stored > length - header->offset) return error_invalid_container("buffer length", __FILE__, __LINE__);
+
+	return ERROR_NONE;
+}
+
+err_t container_expect(const container_t* header, container_type_t type, u32 components)
+{
+	if (header == NULL) return error_param_null("header", __FILE__, __LINE__);
+
+	// interleaved vertices mix component types, so they are only read through their layout
+	if (header->flags & CONTAINER_FLAG_INTERLEAVED) return error_invalid_container("interleaved payload", __FILE__, __LINE__);
+
+	if (header->type != (u8)type) return error_invalid_container("type mismatch", __FILE__, __LINE__);
+
+	if (header->components != components) return error_invalid_container("component mismatch", __FILE__, __LINE__);
+
+	if (header->stride != container_type_size(type) * components) return error_invalid_container("stride mismatch", __FILE__, __LINE__);
+
+	return ERROR_NONE;
+}
+
+err_t container_size(u64* size, const byte* buffer)
+{
+	if (size == NULL) return error_param_null("size", __FILE__, __LINE__);
+
+	container_t header;
+
+	err_t err = container_read(&header, buffer);
+
+	if (err != ERROR_NONE) return err;
+
+	*size = header.offset + header.stored;
+
+	return ERROR_NONE;
+}
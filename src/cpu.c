@@ -0,0 +1,89 @@
+#include "cpu.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CPU_X86
+#endif
+
+#ifdef CPU_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#define CPU_FEATURES_UNDETECTED 0xFFFFFFFFu
+
+static u32 cpu_features = CPU_FEATURES_UNDETECTED;
+
+#ifdef CPU_X86
+
+static void cpu_query(u32 leaf, u32 subleaf, u32 registers[4])
+{
+#ifdef _MSC_VER
+	__cpuidex((int*)registers, (int)leaf, (int)subleaf);
+#else
+	__cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+}
+
+static u64 cpu_xcr0()
+{
+#ifdef _MSC_VER
+	return _xgetbv(0);
+#else
+	u32 lo, hi;
+	__asm__ volatile ("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+	return ((u64)hi << 32) | lo;
+#endif
+}
+
+#endif
+
+u32 cpu_features_detect()
+{
+	if (cpu_features != CPU_FEATURES_UNDETECTED) return cpu_features;
+
+	u32 features = CPU_FEATURE_NONE;
+
+#ifdef CPU_X86
+	u32 registers[4] = { 0, 0, 0, 0 };
+
+	cpu_query(0, 0, registers);
+
+	u32 max_leaf = registers[0];
+
+	if (max_leaf >= 1)
+	{
+		cpu_query(1, 0, registers);
+
+		u32 ecx = registers[2];
+		u32 edx = registers[3];
+
+		if (edx & (1u << 26)) features |= CPU_FEATURE_SSE2;
+		if (ecx & (1u << 9)) features |= CPU_FEATURE_SSSE3;
+
+		// avx state must be enabled by the operating system (osxsave + xmm/ymm in xcr0) before any 256-bit path is usable
+		i32 avx_usable = (ecx & (1u << 27)) && (ecx & (1u << 28)) && (cpu_xcr0() & 0x6) == 0x6;
+
+		// f16c is vex-encoded, so it shares the avx state requirement
+		if (avx_usable && (ecx & (1u << 29))) features |= CPU_FEATURE_F16C;
+
+		if (avx_usable && max_leaf >= 7)
+		{
+			cpu_query(7, 0, registers);
+
+			if (registers[1] & (1u << 5)) features |= CPU_FEATURE_AVX2;
+		}
+	}
+#endif
+
+	cpu_features = features;
+
+	return features;
+}
+
+i32 cpu_supports(u32 features)
+{
+	return (cpu_features_detect() & features) == features ? true : false;
+}
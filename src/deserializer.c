@@ -4,291 +4,700 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "allocator.h"
+#include "compress.h"
 #include "endian.h"
+#include "indices.h"
+#include "layout.h"
+#include "memory.h"
+#include "workers.h"
 
 #include "vec2.h"
 #include "vec3.h"
 #include "vec4.h"
 
-#define DESERIALIZER_TYPE u64
+// seeks and offsets in 64 bits, as the long of the msvc runtime is 32 bits and streamed files may be larger than 2 GiB
+#ifdef _WIN32
+#define DESERIALIZER_FSEEK _fseeki64
+#define DESERIALIZER_FTELL _ftelli64
+#else
+#define DESERIALIZER_FSEEK fseeko
+#define DESERIALIZER_FTELL ftello
+#endif
 
-err_t deserialize_size(u64* size, const byte* buffer)
+// pool that large payloads are converted and decompressed on, or null for the calling thread alone
+static struct workers_t* deserializer_workers = NULL;
+
+void deserializer_workers_set(struct workers_t* workers)
 {
-    if (size == NULL) return error_param_null("size", __FILE__, __LINE__);
+    deserializer_workers = workers;
+}
 
-    union { DESERIALIZER_TYPE element; byte bytes[sizeof(DESERIALIZER_TYPE)]; } translator;
+err_t deserialize_header(container_t* header, const byte* buffer, u64 length)
+{
+    if (header == NULL) return error_param_null("header", __FILE__, __LINE__);
+    if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
 
-    translator.element = 0;
+    // the header is read before the payload length it records is known, so a buffer too short to hold it is caught first
+    if (length < sizeof(container_t)) return error_invalid_container("buffer length", __FILE__, __LINE__);
 
-    // detect endianness to standardize deserialization
-    endian_t endianness = endianness_detect();
+    err_t err = container_read(header, buffer);
 
-    switch (endianness)
-    {
-        case ENDIAN_LITTLE:
-            memcpy(&translator.bytes, buffer, sizeof(DESERIALIZER_TYPE));
-            break;
-        case ENDIAN_BIGLY:
-            memcpy_inv(&translator.bytes, buffer, sizeof(DESERIALIZER_TYPE));
-            break;
-    }
+    if (err != ERROR_NONE) return err;
+
+    return container_validate(header, length);
+}
 
-    *size = translator.element;
+err_t deserialize_size(u64* size, const byte* buffer, u64 length)
+{
+    if (size == NULL) return error_param_null("size", __FILE__, __LINE__);
+
+    container_t header;
+
+    err_t err = deserialize_header(&header, buffer, length);
+
+    if (err != ERROR_NONE) return err;
+
+    *size = header.count;
 
     return ERROR_NONE;
 }
 
-#undef DESERIALIZER_TYPE
-#define DESERIALIZER_TYPE f32
+err_t deserialize_array(mem* array, u64* size, const byte* buffer, u64 length, container_type_t type, u32 components)
+{
+    return deserialize_array_ex(array, size, buffer, length, type, components, NULL);
+}
 
-err_t deserialize_floats(f32** array, u64* size, const byte* buffer)
+err_t deserialize_array_ex(mem* array, u64* size, const byte* buffer, u64 length, container_type_t type, u32 components, const allocator_t* allocator)
 {
     if (array == NULL) return error_param_null("array", __FILE__, __LINE__);
     if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
 
     if (size == NULL) return error_param_null("size", __FILE__, __LINE__);
 
-    deserialize_size(size, buffer);
-
     if (*array != NULL) return error_param_notnull("array", __FILE__, __LINE__);
 
-    u64 mem_size = sizeof(DESERIALIZER_TYPE) * (*size);
+    container_t header;
 
-    *array = (DESERIALIZER_TYPE*)malloc(mem_size);
+    err_t err = deserialize_header(&header, buffer, length);
 
-    if (*array == NULL) return error_alloc_fail("f32", mem_size, __FILE__, __LINE__);
+    if (err != ERROR_NONE) return err;
 
-    // create union type to translate bytes to the appropriate type
-    union { DESERIALIZER_TYPE element; byte bytes[sizeof(DESERIALIZER_TYPE)]; } translator;
+    err = container_expect(&header, type, components);
+
+    if (err != ERROR_NONE) return err;
+
+    *size = header.count;
+
+    u64 mem_size = header.length;
+
+    err = allocator_alloc(allocator, array, mem_size, MEMORY_ALIGNMENT);
+
+    if (err != ERROR_NONE) return err;
 
     // offset pointer to the beginning of the array bytes portion of the buffer
-    const byte* array_base_ptr = buffer + sizeof(u64);
+    const byte* array_base_ptr = buffer + header.offset;
 
-    // detect endianness to standardize deserialization
-    endian_t endianness = endianness_detect();
+    if (header.flags & CONTAINER_FLAG_DELTA)
+    {
+        // varints decode straight into the system byte order
+        err = indices_decode(*array, header.count, type, array_base_ptr, header.stored);
+
+        if (err != ERROR_NONE)
+        {
+            allocator_free(allocator, array);
+        }
 
-    for (u64 i = 0; i < *size; ++i)
+        return err;
+    }
+
+    if (header.flags & CONTAINER_FLAG_COMPRESSED)
     {
-        switch (endianness)
+        // blocks decompress straight into the array on every hardware thread, then get swapped in place if need be
+        err = decompress_blocks((byte*)*array, mem_size, array_base_ptr, header.stored, header.block_size, deserializer_workers);
+
+        if (err != ERROR_NONE)
+        {
+            allocator_free(allocator, array);
+
+            return err;
+        }
+
+        if (header.endianness != endianness_detect()) err = workers_convert_array(deserializer_workers, *array, *array, container_type_size(type), header.count * components, true);
+
+        if (err != ERROR_NONE)
         {
-            case ENDIAN_LITTLE:
-                // copy the i-th element in bytes from the buffer into the bytes if the union
-                memcpy(&translator.bytes, array_base_ptr + i * sizeof(DESERIALIZER_TYPE), sizeof(DESERIALIZER_TYPE));
-                // copy the element of the union into the i-th element of the array
-                memcpy(*array + i, &translator.element, sizeof(DESERIALIZER_TYPE));
-                break;
-            case ENDIAN_BIGLY:
-                // copy the i-th element in bytes from the buffer into the bytes if the union
-                memcpy_inv(&translator.bytes, array_base_ptr + i * sizeof(DESERIALIZER_TYPE), sizeof(DESERIALIZER_TYPE));
-                // copy the element of the union into the i-th element of the array
-                memcpy_inv(*array + i, &translator.element, sizeof(DESERIALIZER_TYPE));
-                break;
+            allocator_free(allocator, array);
         }
+
+        return err;
+    }
+
+    // the payload only needs swapping when it was written in the other byte order
+    err = workers_convert_array(deserializer_workers, *array, array_base_ptr, container_type_size(type), header.count * components, header.endianness != endianness_detect());
+
+    if (err != ERROR_NONE)
+    {
+        allocator_free(allocator, array);
     }
 
+    return err;
+}
+
+err_t deserialize_indices(mem* array, u64* size, container_type_t* type, const byte* buffer, u64 length)
+{
+    return deserialize_indices_ex(array, size, type, buffer, length, NULL);
+}
+
+err_t deserialize_indices_ex(mem* array, u64* size, container_type_t* type, const byte* buffer, u64 length, const allocator_t* allocator)
+{
+    if (type == NULL) return error_param_null("type", __FILE__, __LINE__);
+    if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
+
+    container_t header;
+
+    err_t err = deserialize_header(&header, buffer, length);
+
+    if (err != ERROR_NONE) return err;
+
+    // the serializer chose the width, so it is read back from the header rather than expected
+    if (header.type != CONTAINER_TYPE_U8 && header.type != CONTAINER_TYPE_U16 && header.type != CONTAINER_TYPE_U32) return error_invalid_container("index type", __FILE__, __LINE__);
+
+    err = deserialize_array_ex(array, size, buffer, length, (container_type_t)header.type, 1, allocator);
+
+    if (err != ERROR_NONE) return err;
+
+    *type = (container_type_t)header.type;
+
     return ERROR_NONE;
 }
 
-#undef DESERIALIZER_TYPE
-#define DESERIALIZER_TYPE u32
+/// <summary>
+/// checks that serialized data holds components of a quantized format, including whether they are normalized
+/// </summary>
+/// <param name="buffer">- serialized binary data</param>
+/// <param name="length">- size of the buffer in bytes</param>
+/// <param name="format">- expected quantized format</param>
+/// <param name="type">- container type of the format</param>
+/// <returns>ERROR_NONE on success, ERROR_UNKNOWN_ENUM or ERROR_INVALID_CONTAINER on failure</returns>
+static err_t deserialize_quantized_expect(const byte* buffer, u64 length, quantize_format_t format, container_type_t* type)
+{
+    i32 normalized;
+
+    err_t err = quantize_format_type(format, type, &normalized);
+
+    if (err != ERROR_NONE) return err;
+
+    container_t header;
+
+    err = deserialize_header(&header, buffer, length);
+
+    if (err != ERROR_NONE) return err;
 
-err_t deserialize_u32s(u32** array, u64* size, const byte* buffer)
+    if (((header.flags & CONTAINER_FLAG_NORMALIZED) != 0) != (normalized != 0)) return error_invalid_container("normalization mismatch", __FILE__, __LINE__);
+
+    return ERROR_NONE;
+}
+
+err_t deserialize_quantized(mem* array, u64* size, const byte* buffer, u64 length, quantize_format_t format, u32 components)
+{
+    return deserialize_quantized_ex(array, size, buffer, length, format, components, NULL);
+}
+
+err_t deserialize_quantized_ex(mem* array, u64* size, const byte* buffer, u64 length, quantize_format_t format, u32 components, const allocator_t* allocator)
 {
-    if (array == NULL) return error_param_null("array", __FILE__, __LINE__);
     if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
 
+    container_type_t type;
+
+    err_t err = deserialize_quantized_expect(buffer, length, format, &type);
+
+    if (err != ERROR_NONE) return err;
+
+    return deserialize_array_ex(array, size, buffer, length, type, components, allocator);
+}
+
+err_t deserialize_quantized_view(cmem* array, u64* size, const byte* buffer, u64 length, quantize_format_t format, u32 components)
+{
+    if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
+
+    container_type_t type;
+
+    err_t err = deserialize_quantized_expect(buffer, length, format, &type);
+
+    if (err != ERROR_NONE) return err;
+
+    return deserialize_array_view(array, size, buffer, length, type, components);
+}
+
+err_t deserialize_quantized_inplace(mem* array, u64* size, byte* buffer, u64 length, quantize_format_t format, u32 components)
+{
+    if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
+
+    container_type_t type;
+
+    err_t err = deserialize_quantized_expect(buffer, length, format, &type);
+
+    if (err != ERROR_NONE) return err;
+
+    return deserialize_array_inplace(array, size, buffer, length, type, components);
+}
+
+err_t deserialize_floats(f32** array, u64* size, const byte* buffer, u64 length)
+{
+    return deserialize_array((mem*)array, size, buffer, length, CONTAINER_TYPE_F32, 1);
+}
+
+err_t deserialize_u32s(u32** array, u64* size, const byte* buffer, u64 length)
+{
+    return deserialize_array((mem*)array, size, buffer, length, CONTAINER_TYPE_U32, 1);
+}
+
+err_t deserialize_vec2s(vec2_t** array, u64* size, const byte* buffer, u64 length)
+{
+    return deserialize_array((mem*)array, size, buffer, length, CONTAINER_TYPE_F32, 2);
+}
+
+err_t deserialize_vec3s(vec3_t** array, u64* size, const byte* buffer, u64 length)
+{
+    return deserialize_array((mem*)array, size, buffer, length, CONTAINER_TYPE_F32, 3);
+}
+
+err_t deserialize_vec4s(vec4_t** array, u64* size, const byte* buffer, u64 length)
+{
+    return deserialize_array((mem*)array, size, buffer, length, CONTAINER_TYPE_F32, 4);
+}
+
+err_t deserialize_floats_ex(f32** array, u64* size, const byte* buffer, u64 length, const allocator_t* allocator)
+{
+    return deserialize_array_ex((mem*)array, size, buffer, length, CONTAINER_TYPE_F32, 1, allocator);
+}
+
+err_t deserialize_u32s_ex(u32** array, u64* size, const byte* buffer, u64 length, const allocator_t* allocator)
+{
+    return deserialize_array_ex((mem*)array, size, buffer, length, CONTAINER_TYPE_U32, 1, allocator);
+}
+
+err_t deserialize_vec2s_ex(vec2_t** array, u64* size, const byte* buffer, u64 length, const allocator_t* allocator)
+{
+    return deserialize_array_ex((mem*)array, size, buffer, length, CONTAINER_TYPE_F32, 2, allocator);
+}
+
+err_t deserialize_vec3s_ex(vec3_t** array, u64* size, const byte* buffer, u64 length, const allocator_t* allocator)
+{
+    return deserialize_array_ex((mem*)array, size, buffer, length, CONTAINER_TYPE_F32, 3, allocator);
+}
+
+err_t deserialize_vec4s_ex(vec4_t** array, u64* size, const byte* buffer, u64 length, const allocator_t* allocator)
+{
+    return deserialize_array_ex((mem*)array, size, buffer, length, CONTAINER_TYPE_F32, 4, allocator);
+}
+
+err_t deserialize_array_view(cmem* array, u64* size, const byte* buffer, u64 length, container_type_t type, u32 components)
+{
+    if (array == NULL) return error_param_null("array", __FILE__, __LINE__);
+    if (*array != NULL) return error_param_notnull("*array", __FILE__, __LINE__);
+
     if (size == NULL) return error_param_null("size", __FILE__, __LINE__);
+    if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
 
-    deserialize_size(size, buffer);
+    container_t header;
 
-    if (*array != NULL) return error_param_notnull("array", __FILE__, __LINE__);
+    err_t err = deserialize_header(&header, buffer, length);
 
-    u64 mem_size = sizeof(DESERIALIZER_TYPE) * (*size);
+    if (err != ERROR_NONE) return err;
 
-    *array = (DESERIALIZER_TYPE*)malloc(mem_size);
+    err = container_expect(&header, type, components);
 
-    if (*array == NULL) return error_alloc_fail("u32", mem_size, __FILE__, __LINE__);
+    if (err != ERROR_NONE) return err;
 
-    // create union type to translate bytes to the appropriate type
-    union { DESERIALIZER_TYPE element; byte bytes[sizeof(DESERIALIZER_TYPE)]; } translator;
+    // only an uncompressed payload already in the system byte order can be borrowed as-is
+    if (header.flags & CONTAINER_FLAG_COMPRESSED) return error_invalid_container("compressed payload", __FILE__, __LINE__);
+    if (header.flags & CONTAINER_FLAG_DELTA) return error_invalid_container("delta payload", __FILE__, __LINE__);
+    if (header.endianness != endianness_detect()) return error_endian_mismatch("payload", __FILE__, __LINE__);
 
     // offset pointer to the beginning of the array bytes portion of the buffer
-    const byte* array_base_ptr = buffer + sizeof(u64);
+    const byte* array_base_ptr = buffer + header.offset;
+
+    u64 alignment = container_type_size(type);
+
+    if ((uptr)array_base_ptr % alignment != 0) return error_misaligned_buffer("payload", alignment, __FILE__, __LINE__);
+
+    *size = header.count;
+    *array = array_base_ptr;
+
+    return ERROR_NONE;
+}
+
+err_t deserialize_array_inplace(mem* array, u64* size, byte* buffer, u64 length, container_type_t type, u32 components)
+{
+    if (array == NULL) return error_param_null("array", __FILE__, __LINE__);
+    if (*array != NULL) return error_param_notnull("*array", __FILE__, __LINE__);
+
+    if (size == NULL) return error_param_null("size", __FILE__, __LINE__);
+    if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
 
-    // detect endianness to standardize deserialization
-    endian_t endianness = endianness_detect();
+    container_t header;
 
-    for (u64 i = 0; i < *size; ++i)
+    err_t err = deserialize_header(&header, buffer, length);
+
+    if (err != ERROR_NONE) return err;
+
+    err = container_expect(&header, type, components);
+
+    if (err != ERROR_NONE) return err;
+
+    // decoded payloads are larger than what is stored, so they cannot land where they were read from
+    if (header.flags & CONTAINER_FLAG_COMPRESSED) return error_invalid_container("compressed payload", __FILE__, __LINE__);
+    if (header.flags & CONTAINER_FLAG_DELTA) return error_invalid_container("delta payload", __FILE__, __LINE__);
+
+    byte* array_base_ptr = buffer + header.offset;
+
+    u64 alignment = container_type_size(type);
+
+    if ((uptr)array_base_ptr % alignment != 0) return error_misaligned_buffer("payload", alignment, __FILE__, __LINE__);
+
+    // a payload already in the system byte order is left untouched, so this only costs the header check
+    if (header.endianness != endianness_detect())
     {
-        switch (endianness)
-        {
-            case ENDIAN_LITTLE:
-                // copy the i-th element in bytes from the buffer into the bytes if the union
-                memcpy(&translator.bytes, array_base_ptr + i * sizeof(DESERIALIZER_TYPE), sizeof(DESERIALIZER_TYPE));
-                // copy the element of the union into the i-th element of the array
-                memcpy(*array + i, &translator.element, sizeof(DESERIALIZER_TYPE));
-                break;
-            case ENDIAN_BIGLY:
-                // copy the i-th element in bytes from the buffer into the bytes if the union
-                memcpy_inv(&translator.bytes, array_base_ptr + i * sizeof(DESERIALIZER_TYPE), sizeof(DESERIALIZER_TYPE));
-                // copy the element of the union into the i-th element of the array
-                memcpy_inv(*array + i, &translator.element, sizeof(DESERIALIZER_TYPE));
-                break;
-        }
+        err = workers_convert_array(deserializer_workers, array_base_ptr, array_base_ptr, alignment, header.count * components, true);
+
+        if (err != ERROR_NONE) return err;
+
+        // the header follows the payload so that the buffer stays a valid container
+        header.endianness = (u8)endianness_detect();
+
+        container_write(buffer, &header);
     }
 
+    *size = header.count;
+    *array = array_base_ptr;
+
     return ERROR_NONE;
 }
 
-#undef DESERIALIZER_TYPE
-#define DESERIALIZER_TYPE vec2_t
+err_t deserialize_floats_inplace(f32** array, u64* size, byte* buffer, u64 length)
+{
+    return deserialize_array_inplace((mem*)array, size, buffer, length, CONTAINER_TYPE_F32, 1);
+}
 
-err_t deserialize_vec2s(vec2_t** array, u64* size, const byte* buffer)
+err_t deserialize_u32s_inplace(u32** array, u64* size, byte* buffer, u64 length)
+{
+    return deserialize_array_inplace((mem*)array, size, buffer, length, CONTAINER_TYPE_U32, 1);
+}
+
+err_t deserialize_vec2s_inplace(vec2_t** array, u64* size, byte* buffer, u64 length)
+{
+    return deserialize_array_inplace((mem*)array, size, buffer, length, CONTAINER_TYPE_F32, 2);
+}
+
+err_t deserialize_vec3s_inplace(vec3_t** array, u64* size, byte* buffer, u64 length)
+{
+    return deserialize_array_inplace((mem*)array, size, buffer, length, CONTAINER_TYPE_F32, 3);
+}
+
+err_t deserialize_vec4s_inplace(vec4_t** array, u64* size, byte* buffer, u64 length)
+{
+    return deserialize_array_inplace((mem*)array, size, buffer, length, CONTAINER_TYPE_F32, 4);
+}
+
+err_t deserialize_floats_view(const f32** array, u64* size, const byte* buffer, u64 length)
+{
+    return deserialize_array_view((cmem*)array, size, buffer, length, CONTAINER_TYPE_F32, 1);
+}
+
+err_t deserialize_u32s_view(const u32** array, u64* size, const byte* buffer, u64 length)
+{
+    return deserialize_array_view((cmem*)array, size, buffer, length, CONTAINER_TYPE_U32, 1);
+}
+
+err_t deserialize_vec2s_view(const vec2_t** array, u64* size, const byte* buffer, u64 length)
+{
+    return deserialize_array_view((cmem*)array, size, buffer, length, CONTAINER_TYPE_F32, 2);
+}
+
+err_t deserialize_vec3s_view(const vec3_t** array, u64* size, const byte* buffer, u64 length)
+{
+    return deserialize_array_view((cmem*)array, size, buffer, length, CONTAINER_TYPE_F32, 3);
+}
+
+err_t deserialize_vec4s_view(const vec4_t** array, u64* size, const byte* buffer, u64 length)
+{
+    return deserialize_array_view((cmem*)array, size, buffer, length, CONTAINER_TYPE_F32, 4);
+}
+
+/// <summary>
+/// reads the container header and layout table of serialized interleaved vertices
+/// </summary>
+/// <param name="header">- header, converted to the system byte order</param>
+/// <param name="layout">- layout of each vertex</param>
+/// <param name="buffer">- serialized binary data</param>
+/// <param name="length">- size of the buffer in bytes</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL, ERROR_INVALID_CONTAINER or ERROR_INVALID_LAYOUT on failure</returns>
+static err_t deserialize_interleaved_header(container_t* header, layout_t* layout, const byte* buffer, u64 length)
+{
+    err_t err = deserialize_header(header, buffer, length);
+
+    if (err != ERROR_NONE) return err;
+
+    if ((header->flags & CONTAINER_FLAG_INTERLEAVED) == 0) return error_invalid_container("not interleaved", __FILE__, __LINE__);
+
+    // the table fills the space between the header and the payload
+    err = layout_read(layout, buffer + CONTAINER_OFFSET, header->offset - CONTAINER_OFFSET, header->endianness);
+
+    if (err != ERROR_NONE) return err;
+
+    if (layout->stride != header->stride) return error_invalid_container("stride mismatch", __FILE__, __LINE__);
+
+    return ERROR_NONE;
+}
+
+err_t deserialize_interleaved(mem* array, u64* size, layout_t* layout, const byte* buffer, u64 length)
+{
+    return deserialize_interleaved_ex(array, size, layout, buffer, length, NULL);
+}
+
+err_t deserialize_interleaved_ex(mem* array, u64* size, layout_t* layout, const byte* buffer, u64 length, const allocator_t* allocator)
 {
     if (array == NULL) return error_param_null("array", __FILE__, __LINE__);
-    if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
+    if (*array != NULL) return error_param_notnull("*array", __FILE__, __LINE__);
 
     if (size == NULL) return error_param_null("size", __FILE__, __LINE__);
+    if (layout == NULL) return error_param_null("layout", __FILE__, __LINE__);
+    if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
 
-    deserialize_size(size, buffer);
+    container_t header;
 
-    if (*array != NULL) return error_param_notnull("array", __FILE__, __LINE__);
+    err_t err = deserialize_interleaved_header(&header, layout, buffer, length);
 
-    u64 mem_size = sizeof(DESERIALIZER_TYPE) * (*size);
+    if (err != ERROR_NONE) return err;
 
-    *array = (DESERIALIZER_TYPE*)malloc(mem_size);
+    err = allocator_alloc(allocator, array, header.length, MEMORY_ALIGNMENT);
 
-    if (*array == NULL) return error_alloc_fail("vec2_t", mem_size, __FILE__, __LINE__);
+    if (err != ERROR_NONE) return err;
 
-    // create union type to translate bytes to the appropriate type
-    union { DESERIALIZER_TYPE element; byte bytes[sizeof(DESERIALIZER_TYPE)]; } translator;
+    const byte* array_base_ptr = buffer + header.offset;
 
-    // offset pointer to the beginning of the array bytes portion of the buffer
-    const byte* array_base_ptr = buffer + sizeof(u64);
+    if (header.flags & CONTAINER_FLAG_COMPRESSED) err = decompress_blocks((byte*)*array, header.length, array_base_ptr, header.stored, header.block_size, deserializer_workers);
+    else err = workers_convert_array(deserializer_workers, *array, array_base_ptr, 1, header.length, false);
 
-    // detect endianness to standardize deserialization
-    endian_t endianness = endianness_detect();
+    // attributes of different widths share each vertex, so they are swapped one by one where they landed
+    if (err == ERROR_NONE && header.endianness != endianness_detect()) err = layout_swap(*array, layout, header.count);
 
-    for (u64 i = 0; i < *size; ++i)
+    if (err != ERROR_NONE)
     {
-        switch (endianness)
-        {
-            case ENDIAN_LITTLE:
-                // copy the i-th element in bytes from the buffer into the bytes if the union
-                memcpy(&translator.bytes, array_base_ptr + i * sizeof(DESERIALIZER_TYPE), sizeof(DESERIALIZER_TYPE));
-                // copy the element of the union into the i-th element of the array
-                memcpy(*array + i, &translator.element, sizeof(DESERIALIZER_TYPE));
-                break;
-            case ENDIAN_BIGLY:
-                // copy the i-th element in bytes from the buffer into the bytes if the union
-                memcpy_inv(&translator.bytes, array_base_ptr + i * sizeof(DESERIALIZER_TYPE), sizeof(DESERIALIZER_TYPE));
-                // copy the element of the union into the i-th element of the array
-                memcpy_inv(*array + i, &translator.element, sizeof(DESERIALIZER_TYPE));
-                break;
-        }
+        allocator_free(allocator, array);
+
+        return err;
     }
 
+    *size = header.count;
+
     return ERROR_NONE;
 }
 
-#undef DESERIALIZER_TYPE
-#define DESERIALIZER_TYPE vec3_t
+err_t deserialize_interleaved_view(cmem* array, u64* size, layout_t* layout, const byte* buffer, u64 length)
+{
+    if (array == NULL) return error_param_null("array", __FILE__, __LINE__);
+    if (*array != NULL) return error_param_notnull("*array", __FILE__, __LINE__);
+
+    if (size == NULL) return error_param_null("size", __FILE__, __LINE__);
+    if (layout == NULL) return error_param_null("layout", __FILE__, __LINE__);
+    if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
 
-err_t deserialize_vec3s(vec3_t** array, u64* size, const byte* buffer)
+    container_t header;
+
+    err_t err = deserialize_interleaved_header(&header, layout, buffer, length);
+
+    if (err != ERROR_NONE) return err;
+
+    if (header.flags & CONTAINER_FLAG_COMPRESSED) return error_invalid_container("compressed payload", __FILE__, __LINE__);
+    if (header.endianness != endianness_detect()) return error_endian_mismatch("payload", __FILE__, __LINE__);
+
+    const byte* array_base_ptr = buffer + header.offset;
+
+    // the stride is a multiple of LAYOUT_ALIGNMENT and each attribute is aligned to its type within a vertex, so an aligned first vertex aligns them all
+    if ((uptr)array_base_ptr % LAYOUT_ALIGNMENT != 0) return error_misaligned_buffer("payload", LAYOUT_ALIGNMENT, __FILE__, __LINE__);
+
+    *size = header.count;
+    *array = array_base_ptr;
+
+    return ERROR_NONE;
+}
+
+err_t deserialize_interleaved_inplace(mem* array, u64* size, layout_t* layout, byte* buffer, u64 length)
 {
     if (array == NULL) return error_param_null("array", __FILE__, __LINE__);
+    if (*array != NULL) return error_param_notnull("*array", __FILE__, __LINE__);
+
+    if (size == NULL) return error_param_null("size", __FILE__, __LINE__);
+    if (layout == NULL) return error_param_null("layout", __FILE__, __LINE__);
     if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
 
+    container_t header;
+
+    err_t err = deserialize_interleaved_header(&header, layout, buffer, length);
+
+    if (err != ERROR_NONE) return err;
+
+    if (header.flags & CONTAINER_FLAG_COMPRESSED) return error_invalid_container("compressed payload", __FILE__, __LINE__);
+
+    byte* array_base_ptr = buffer + header.offset;
+
+    if ((uptr)array_base_ptr % LAYOUT_ALIGNMENT != 0) return error_misaligned_buffer("payload", LAYOUT_ALIGNMENT, __FILE__, __LINE__);
+
+    if (header.endianness != endianness_detect())
+    {
+        err = layout_swap(array_base_ptr, layout, header.count);
+
+        if (err != ERROR_NONE) return err;
+
+        // the layout table is in the byte order of the header, so both are rewritten together
+        header.endianness = (u8)endianness_detect();
+
+        layout_write(buffer + CONTAINER_OFFSET, layout, header.endianness);
+        container_write(buffer, &header);
+    }
+
+    *size = header.count;
+    *array = array_base_ptr;
+
+    return ERROR_NONE;
+}
+
+typedef struct deserializer_stream_t
+{
+    FILE* file;
+    container_t header;
+    u64 type_size;
+    // elements not yet read from the file
+    u64 remaining;
+    i32 swap;
+} deserializer_stream_t;
+
+err_t deserializer_stream_open(deserializer_stream_t** stream, cstr path, container_type_t type, u32 components, u64* size)
+{
+    if (stream == NULL) return error_param_null("stream", __FILE__, __LINE__);
+    if (*stream != NULL) return error_param_notnull("*stream", __FILE__, __LINE__);
+
+    if (path == NULL) return error_param_null("path", __FILE__, __LINE__);
     if (size == NULL) return error_param_null("size", __FILE__, __LINE__);
 
-    deserialize_size(size, buffer);
+    FILE* file = NULL;
 
-    if (*array != NULL) return error_param_notnull("array", __FILE__, __LINE__);
+    if (fopen_s(&file, path, "rb") != 0) return error_unopenable_file(path, __FILE__, __LINE__);
 
-    u64 mem_size = sizeof(DESERIALIZER_TYPE) * (*size);
+    // chunks are read straight into the caller's array, so the c runtime buffer would only add a copy
+    setvbuf(file, NULL, _IONBF, 0);
 
-    *array = (DESERIALIZER_TYPE*)malloc(mem_size);
+    byte bytes[sizeof(container_t)];
+    container_t header;
 
-    if (*array == NULL) return error_alloc_fail("vec3_t", mem_size, __FILE__, __LINE__);
+    u64 read_size = fread(bytes, sizeof(byte), sizeof(bytes), file);
 
-    // create union type to translate bytes to the appropriate type
-    union { DESERIALIZER_TYPE element; byte bytes[sizeof(DESERIALIZER_TYPE)]; } translator;
+    err_t err = read_size == sizeof(bytes) ? ERROR_NONE : error_size_mismatch(sizeof(bytes), read_size, __FILE__, __LINE__);
 
-    // offset pointer to the beginning of the array bytes portion of the buffer
-    const byte* array_base_ptr = buffer + sizeof(u64);
+    if (err == ERROR_NONE) err = container_read(&header, bytes);
+
+    i64 file_size = -1;
 
-    // detect endianness to standardize deserialization
-    endian_t endianness = endianness_detect();
+    if (err == ERROR_NONE && DESERIALIZER_FSEEK(file, 0, SEEK_END) == 0) file_size = DESERIALIZER_FTELL(file);
 
-    for (u64 i = 0; i < *size; ++i)
+    // a truncated file is rejected up front rather than once the stream is partly consumed
+    if (err == ERROR_NONE) err = file_size >= 0 ? container_validate(&header, (u64)file_size) : error_invalid_container("buffer length", __FILE__, __LINE__);
+    if (err == ERROR_NONE) err = container_expect(&header, type, components);
+
+    // chunks are read raw, so compressed and delta encoded payloads must go through deserialize_array instead
+    if (err == ERROR_NONE && (header.flags & (CONTAINER_FLAG_COMPRESSED | CONTAINER_FLAG_DELTA))) err = error_invalid_container("encoded payload", __FILE__, __LINE__);
+
+    // skip the padding between the header and the payload
+    if (err == ERROR_NONE && DESERIALIZER_FSEEK(file, header.offset, SEEK_SET) != 0) err = error_invalid_container("offset", __FILE__, __LINE__);
+
+    if (err != ERROR_NONE)
     {
-        switch (endianness)
-        {
-            case ENDIAN_LITTLE:
-                // copy the i-th element in bytes from the buffer into the bytes if the union
-                memcpy(&translator.bytes, array_base_ptr + i * sizeof(DESERIALIZER_TYPE), sizeof(DESERIALIZER_TYPE));
-                // copy the element of the union into the i-th element of the array
-                memcpy(*array + i, &translator.element, sizeof(DESERIALIZER_TYPE));
-                break;
-            case ENDIAN_BIGLY:
-                // copy the i-th element in bytes from the buffer into the bytes if the union
-                memcpy_inv(&translator.bytes, array_base_ptr + i * sizeof(DESERIALIZER_TYPE), sizeof(DESERIALIZER_TYPE));
-                // copy the element of the union into the i-th element of the array
-                memcpy_inv(*array + i, &translator.element, sizeof(DESERIALIZER_TYPE));
-                break;
-        }
+        fclose(file);
+
+        return err;
     }
 
+    *stream = (deserializer_stream_t*)malloc(sizeof(deserializer_stream_t));
+
+    if (*stream == NULL)
+    {
+        fclose(file);
+
+        return error_alloc_fail("deserializer_stream_t", sizeof(deserializer_stream_t), __FILE__, __LINE__);
+    }
+
+    (*stream)->file = file;
+    (*stream)->header = header;
+    (*stream)->type_size = container_type_size(type);
+    (*stream)->remaining = header.count;
+    (*stream)->swap = header.endianness != endianness_detect();
+
+    *size = header.count;
+
     return ERROR_NONE;
 }
 
-#undef DESERIALIZER_TYPE
-#define DESERIALIZER_TYPE vec4_t
-
-err_t deserialize_vec4s(vec4_t** array, u64* size, const byte* buffer)
+err_t deserializer_stream_read(deserializer_stream_t* stream, mem array, u64 capacity, u64* count)
 {
+    if (stream == NULL) return error_param_null("stream", __FILE__, __LINE__);
     if (array == NULL) return error_param_null("array", __FILE__, __LINE__);
-    if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
+    if (count == NULL) return error_param_null("count", __FILE__, __LINE__);
 
-    if (size == NULL) return error_param_null("size", __FILE__, __LINE__);
+    u64 elements = capacity < stream->remaining ? capacity : stream->remaining;
+    u64 mem_size = elements * stream->header.stride;
 
-    deserialize_size(size, buffer);
+    *count = 0;
 
-    if (*array != NULL) return error_param_notnull("array", __FILE__, __LINE__);
+    if (elements == 0) return ERROR_NONE;
 
-    u64 mem_size = sizeof(DESERIALIZER_TYPE) * (*size);
+    u64 read_size = fread(array, sizeof(byte), mem_size, stream->file);
 
-    *array = (DESERIALIZER_TYPE*)malloc(mem_size);
+    if (read_size != mem_size) return error_size_mismatch(mem_size, read_size, __FILE__, __LINE__);
 
-    if (*array == NULL) return error_alloc_fail("vec4_t", mem_size, __FILE__, __LINE__);
+    // each chunk is converted where it landed, so no second buffer is needed for foreign byte orders
+    if (stream->swap) endian_swap_array(array, array, stream->type_size, mem_size / stream->type_size);
 
-    // create union type to translate bytes to the appropriate type
-    union { DESERIALIZER_TYPE element; byte bytes[sizeof(DESERIALIZER_TYPE)]; } translator;
+    stream->remaining -= elements;
+    *count = elements;
 
-    // offset pointer to the beginning of the array bytes portion of the buffer
-    const byte* array_base_ptr = buffer + sizeof(u64);
+    return ERROR_NONE;
+}
 
-    // detect endianness to standardize deserialization
-    endian_t endianness = endianness_detect();
+err_t deserializer_stream_each(deserializer_stream_t* stream, mem array, u64 capacity, deserializer_chunk_t callback, ptr user)
+{
+    if (stream == NULL) return error_param_null("stream", __FILE__, __LINE__);
+    if (callback == NULL) return error_param_null("callback", __FILE__, __LINE__);
 
-    for (u64 i = 0; i < *size; ++i)
+    forever
     {
-        switch (endianness)
-        {
-            case ENDIAN_LITTLE:
-                // copy the i-th element in bytes from the buffer into the bytes if the union
-                memcpy(&translator.bytes, array_base_ptr + i * sizeof(DESERIALIZER_TYPE), sizeof(DESERIALIZER_TYPE));
-                // copy the element of the union into the i-th element of the array
-                memcpy(*array + i, &translator.element, sizeof(DESERIALIZER_TYPE));
-                break;
-            case ENDIAN_BIGLY:
-                // copy the i-th element in bytes from the buffer into the bytes if the union
-                memcpy_inv(&translator.bytes, array_base_ptr + i * sizeof(DESERIALIZER_TYPE), sizeof(DESERIALIZER_TYPE));
-                // copy the element of the union into the i-th element of the array
-                memcpy_inv(*array + i, &translator.element, sizeof(DESERIALIZER_TYPE));
-                break;
-        }
+        u64 count = 0;
+
+        err_t err = deserializer_stream_read(stream, array, capacity, &count);
+
+        if (err != ERROR_NONE) return err;
+
+        if (count == 0) return ERROR_NONE;
+
+        err = callback(array, count, user);
+
+        if (err != ERROR_NONE) return err;
     }
+}
+
+err_t deserializer_stream_close(deserializer_stream_t** stream)
+{
+    if (stream == NULL) return error_param_null("stream", __FILE__, __LINE__);
+    if (*stream == NULL) return error_param_null("*stream", __FILE__, __LINE__);
+
+    i32 closed = fclose((*stream)->file);
+
+    free(*stream);
+    *stream = NULL;
+
+    if (closed != 0) return error_uncloseable_file("stream", __FILE__, __LINE__);
 
     return ERROR_NONE;
 }
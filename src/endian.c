@@ -1,15 +1,53 @@
 ﻿#include "endian.h"
 
 #include "typedef.h"
+#include "cpu.h"
+
+#include <string.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define ENDIAN_X86
+#include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <stdlib.h>
+#define ENDIAN_BSWAP16(x) _byteswap_ushort(x)
+#define ENDIAN_BSWAP32(x) _byteswap_ulong(x)
+#define ENDIAN_BSWAP64(x) _byteswap_uint64(x)
+#define ENDIAN_TARGET(isa)
+#else
+#define ENDIAN_BSWAP16(x) __builtin_bswap16(x)
+#define ENDIAN_BSWAP32(x) __builtin_bswap32(x)
+#define ENDIAN_BSWAP64(x) __builtin_bswap64(x)
+#define ENDIAN_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+#define ENDIAN_UNFORCED -1
+
+static i32 endian_forced = ENDIAN_UNFORCED;
+static i32 endian_simd = ENDIAN_UNFORCED;
 
 endian_t endianness_detect()
 {
+    if (endian_forced != ENDIAN_UNFORCED) return (endian_t)endian_forced;
+
     int i = 1;
     str p = (str)&i;
 
     return p[0] == 1 ? ENDIAN_LITTLE : ENDIAN_BIGLY;
 }
 
+void endianness_force(endian_t endianness)
+{
+    endian_forced = (i32)endianness;
+}
+
+void endianness_unforce()
+{
+    endian_forced = ENDIAN_UNFORCED;
+}
+
 mem memcpy_inv(mem dest, cmem src, u64 len)
 {
     str d = (str)dest + len - 1;
@@ -18,3 +56,249 @@ mem memcpy_inv(mem dest, cmem src, u64 len)
         *d-- = *s++;
     return dest;
 }
+
+static void endian_swap16_scalar(byte* dest, const byte* src, u64 count)
+{
+    for (u64 i = 0; i < count; ++i)
+    {
+        u16 element;
+        memcpy(&element, src + i * sizeof(u16), sizeof(u16));
+        element = ENDIAN_BSWAP16(element);
+        memcpy(dest + i * sizeof(u16), &element, sizeof(u16));
+    }
+}
+
+static void endian_swap32_scalar(byte* dest, const byte* src, u64 count)
+{
+    for (u64 i = 0; i < count; ++i)
+    {
+        u32 element;
+        memcpy(&element, src + i * sizeof(u32), sizeof(u32));
+        element = ENDIAN_BSWAP32(element);
+        memcpy(dest + i * sizeof(u32), &element, sizeof(u32));
+    }
+}
+
+static void endian_swap64_scalar(byte* dest, const byte* src, u64 count)
+{
+    for (u64 i = 0; i < count; ++i)
+    {
+        u64 element;
+        memcpy(&element, src + i * sizeof(u64), sizeof(u64));
+        element = ENDIAN_BSWAP64(element);
+        memcpy(dest + i * sizeof(u64), &element, sizeof(u64));
+    }
+}
+
+#ifdef ENDIAN_X86
+
+// shuffle masks reversing each 2, 4 and 8 byte element of a 128-bit register; avx2 shuffles within 128-bit halves so the same masks are broadcast
+#define ENDIAN_MASK_U16 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14
+#define ENDIAN_MASK_U32 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12
+#define ENDIAN_MASK_U64 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8
+
+ENDIAN_TARGET("ssse3")
+static u64 endian_swap_ssse3(byte* dest, const byte* src, u64 bytes, __m128i mask)
+{
+    u64 i = 0;
+
+    for (; i + 32 <= bytes; i += 32)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(src + i + 16));
+        _mm_storeu_si128((__m128i*)(dest + i), _mm_shuffle_epi8(a, mask));
+        _mm_storeu_si128((__m128i*)(dest + i + 16), _mm_shuffle_epi8(b, mask));
+    }
+
+    for (; i + 16 <= bytes; i += 16)
+        _mm_storeu_si128((__m128i*)(dest + i), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + i)), mask));
+
+    return i;
+}
+
+ENDIAN_TARGET("avx2")
+static u64 endian_swap_avx2(byte* dest, const byte* src, u64 bytes, __m256i mask)
+{
+    u64 i = 0;
+
+    for (; i + 64 <= bytes; i += 64)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(src + i + 32));
+        _mm256_storeu_si256((__m256i*)(dest + i), _mm256_shuffle_epi8(a, mask));
+        _mm256_storeu_si256((__m256i*)(dest + i + 32), _mm256_shuffle_epi8(b, mask));
+    }
+
+    for (; i + 32 <= bytes; i += 32)
+        _mm256_storeu_si256((__m256i*)(dest + i), _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(src + i)), mask));
+
+    return i;
+}
+
+ENDIAN_TARGET("ssse3")
+static void endian_swap16_ssse3(byte* dest, const byte* src, u64 count)
+{
+    u64 done = endian_swap_ssse3(dest, src, count * sizeof(u16), _mm_setr_epi8(ENDIAN_MASK_U16));
+    endian_swap16_scalar(dest + done, src + done, count - done / sizeof(u16));
+}
+
+ENDIAN_TARGET("ssse3")
+static void endian_swap32_ssse3(byte* dest, const byte* src, u64 count)
+{
+    u64 done = endian_swap_ssse3(dest, src, count * sizeof(u32), _mm_setr_epi8(ENDIAN_MASK_U32));
+    endian_swap32_scalar(dest + done, src + done, count - done / sizeof(u32));
+}
+
+ENDIAN_TARGET("ssse3")
+static void endian_swap64_ssse3(byte* dest, const byte* src, u64 count)
+{
+    u64 done = endian_swap_ssse3(dest, src, count * sizeof(u64), _mm_setr_epi8(ENDIAN_MASK_U64));
+    endian_swap64_scalar(dest + done, src + done, count - done / sizeof(u64));
+}
+
+ENDIAN_TARGET("avx2")
+static void endian_swap16_avx2(byte* dest, const byte* src, u64 count)
+{
+    u64 done = endian_swap_avx2(dest, src, count * sizeof(u16), _mm256_setr_epi8(ENDIAN_MASK_U16, ENDIAN_MASK_U16));
+    endian_swap16_scalar(dest + done, src + done, count - done / sizeof(u16));
+}
+
+ENDIAN_TARGET("avx2")
+static void endian_swap32_avx2(byte* dest, const byte* src, u64 count)
+{
+    u64 done = endian_swap_avx2(dest, src, count * sizeof(u32), _mm256_setr_epi8(ENDIAN_MASK_U32, ENDIAN_MASK_U32));
+    endian_swap32_scalar(dest + done, src + done, count - done / sizeof(u32));
+}
+
+ENDIAN_TARGET("avx2")
+static void endian_swap64_avx2(byte* dest, const byte* src, u64 count)
+{
+    u64 done = endian_swap_avx2(dest, src, count * sizeof(u64), _mm256_setr_epi8(ENDIAN_MASK_U64, ENDIAN_MASK_U64));
+    endian_swap64_scalar(dest + done, src + done, count - done / sizeof(u64));
+}
+
+#endif
+
+endian_simd_t endian_simd_detect()
+{
+    if (endian_simd != ENDIAN_UNFORCED) return (endian_simd_t)endian_simd;
+
+    endian_simd_t simd = ENDIAN_SIMD_SCALAR;
+
+#ifdef ENDIAN_X86
+    if (cpu_supports(CPU_FEATURE_AVX2)) simd = ENDIAN_SIMD_AVX2;
+    else if (cpu_supports(CPU_FEATURE_SSSE3)) simd = ENDIAN_SIMD_SSSE3;
+#endif
+
+    endian_simd = (i32)simd;
+
+    return simd;
+}
+
+endian_simd_t endian_simd_force(endian_simd_t simd)
+{
+    // forget any previous choice so the clamp below is made against the hardware rather than the last force
+    endian_simd = ENDIAN_UNFORCED;
+
+    endian_simd_t supported = endian_simd_detect();
+
+    if (simd < supported) supported = simd;
+
+    endian_simd = (i32)supported;
+
+    return supported;
+}
+
+void endian_swap_u16s(mem dest, cmem src, u64 count)
+{
+    switch (endian_simd_detect())
+    {
+#ifdef ENDIAN_X86
+        case ENDIAN_SIMD_AVX2:
+            endian_swap16_avx2(dest, src, count);
+            break;
+        case ENDIAN_SIMD_SSSE3:
+            endian_swap16_ssse3(dest, src, count);
+            break;
+#endif
+        default:
+            endian_swap16_scalar(dest, src, count);
+            break;
+    }
+}
+
+void endian_swap_u32s(mem dest, cmem src, u64 count)
+{
+    switch (endian_simd_detect())
+    {
+#ifdef ENDIAN_X86
+        case ENDIAN_SIMD_AVX2:
+            endian_swap32_avx2(dest, src, count);
+            break;
+        case ENDIAN_SIMD_SSSE3:
+            endian_swap32_ssse3(dest, src, count);
+            break;
+#endif
+        default:
+            endian_swap32_scalar(dest, src, count);
+            break;
+    }
+}
+
+void endian_swap_u64s(mem dest, cmem src, u64 count)
+{
+    switch (endian_simd_detect())
+    {
+#ifdef ENDIAN_X86
+        case ENDIAN_SIMD_AVX2:
+            endian_swap64_avx2(dest, src, count);
+            break;
+        case ENDIAN_SIMD_SSSE3:
+            endian_swap64_ssse3(dest, src, count);
+            break;
+#endif
+        default:
+            endian_swap64_scalar(dest, src, count);
+            break;
+    }
+}
+
+void endian_swap_array(mem dest, cmem src, u64 width, u64 count)
+{
+    switch (width)
+    {
+        case sizeof(u16):
+            endian_swap_u16s(dest, src, count);
+            break;
+        case sizeof(u32):
+            endian_swap_u32s(dest, src, count);
+            break;
+        case sizeof(u64):
+            endian_swap_u64s(dest, src, count);
+            break;
+        default:
+            // single bytes have no order to reverse
+            if (dest != src) memmove(dest, src, (size_t)(width * count));
+            break;
+    }
+}
+
+void endian_swap_f32s(mem dest, cmem src, u64 count)
+{
+    endian_swap_u32s(dest, src, count);
+}
+
+void endian_swap_vec2s(mem dest, cmem src, u64 count)
+{
+    endian_swap_u32s(dest, src, count * 2);
+}
+
+void endian_swap_vec3s(mem dest, cmem src, u64 count)
+{
+    endian_swap_u32s(dest, src, count * 3);
+}
+
+void endian_swap_vec4s(mem dest, cmem src, u64 count)
+{
+    endian_swap_u32s(dest, src, count * 4);
+}
@@ -120,3 +120,80 @@ err_t error_shader_link_fail(str message, cstr file, i32 line)
 
 	return ERROR_SHADER_LINK_FAIL;
 }
+
+err_t error_endian_mismatch(cstr name, cstr file, i32 line)
+{
+	printf("[%s] - ERROR (%s, line %d): byte order of %s does not match the system!\n", __TIME__, file, line, name);
+
+	return ERROR_ENDIAN_MISMATCH;
+}
+
+err_t error_misaligned_buffer(cstr name, u64 alignment, cstr file, i32 line)
+{
+	printf("[%s] - ERROR (%s, line %d): %s is not aligned to %llu bytes!\n", __TIME__, file, line, name, alignment);
+
+	return ERROR_MISALIGNED_BUFFER;
+}
+
+err_t error_unmappable_file(cstr path, cstr file, i32 line)
+{
+	printf("[%s] - ERROR (%s, line %d): failed to map file %s!\n", __TIME__, file, line, path);
+
+	return ERROR_UNMAPPABLE_FILE;
+}
+
+err_t error_invalid_container(cstr reason, cstr file, i32 line)
+{
+	printf("[%s] - ERROR (%s, line %d): invalid container! (%s)\n", __TIME__, file, line, reason);
+
+	return ERROR_INVALID_CONTAINER;
+}
+
+err_t error_missing_entry(cstr name, cstr file, i32 line)
+{
+	printf("[%s] - ERROR (%s, line %d): no entry named %s!\n", __TIME__, file, line, name);
+
+	return ERROR_MISSING_ENTRY;
+}
+
+err_t error_thread_fail(cstr operation, cstr file, i32 line)
+{
+	printf("[%s] - ERROR (%s, line %d): could not %s!\n", __TIME__, file, line, operation);
+
+	return ERROR_THREAD_FAIL;
+}
+
+err_t error_invalid_layout(cstr reason, cstr file, i32 line)
+{
+	printf("[%s] - ERROR (%s, line %d): invalid layout! (%s)\n", __TIME__, file, line, reason);
+
+	return ERROR_INVALID_LAYOUT;
+}
+
+err_t error_unwritable_file(cstr path, cstr file, i32 line)
+{
+	printf("[%s] - ERROR (%s, line %d): failed to write file %s!\n", __TIME__, file, line, path);
+
+	return ERROR_UNWRITABLE_FILE;
+}
+
+err_t error_queue_full(cstr name, cstr file, i32 line)
+{
+	printf("[%s] - ERROR (%s, line %d): %s queue is full!\n", __TIME__, file, line, name);
+
+	return ERROR_QUEUE_FULL;
+}
+
+err_t error_invalid_manifest(cstr path, u32 number, cstr file, i32 line)
+{
+	printf("[%s] - ERROR (%s, line %d): manifest %s is invalid at line %u!\n", __TIME__, file, line, path, number);
+
+	return ERROR_INVALID_MANIFEST;
+}
+
+err_t error_unmappable_buffer(cstr name, cstr file, i32 line)
+{
+	printf("[%s] - ERROR (%s, line %d): failed to map buffer %s!\n", __TIME__, file, line, name);
+
+	return ERROR_UNMAPPABLE_BUFFER;
+}
\ No newline at end of file
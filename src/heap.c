@@ -0,0 +1,563 @@
+#include "heap.h"
+
+#include <GL/glew.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+/// <summary>offsets of the free ranges of one size in a block</summary>
+typedef struct heap_list_t
+{
+	u64* offsets;
+	u32 count;
+	u32 capacity;
+} heap_list_t;
+
+typedef struct heap_block_t
+{
+	u32 buffer;
+	// free ranges of each power of two size, indexed by the exponent
+	heap_list_t free[HEAP_ORDERS];
+} heap_block_t;
+
+typedef struct heap_entry_t
+{
+	u32 block;
+	// exponent of the size of the buddy range, or -1 once freed
+	i32 order;
+	// offset of the buddy range, which the allocation starts at or after to respect its stride
+	u64 start;
+	u64 size;
+	u32 stride;
+} heap_entry_t;
+
+typedef struct heap_t
+{
+	u32 target;
+	u64 block_size;
+	u32 block_order;
+
+	heap_block_t* blocks;
+	u32 block_count;
+
+	// allocations by id minus one, with the ids of freed ones kept for reuse
+	heap_entry_t* entries;
+	u32 entry_count;
+	u32 entry_capacity;
+
+	u32* spare;
+	u32 spare_count;
+	u32 spare_capacity;
+} heap_t;
+
+/// <summary>
+/// grows an array by doubling when it is full
+/// </summary>
+/// <param name="array">- address of the array</param>
+/// <param name="capacity">- address of the capacity of the array in elements</param>
+/// <param name="count">- number of elements in use</param>
+/// <param name="size">- size of each element</param>
+/// <returns>ERROR_NONE on success, ERROR_ALLOC_FAIL on failure</returns>
+static err_t heap_grow(mem* array, u32* capacity, u32 count, u64 size)
+{
+	if (count < *capacity) return ERROR_NONE;
+
+	u32 grown = *capacity > 0 ? *capacity * 2 : 8;
+
+	mem resized = realloc(*array, grown * size);
+
+	if (resized == NULL) return error_alloc_fail("heap", grown * size, __FILE__, __LINE__);
+
+	*array = resized;
+	*capacity = grown;
+
+	return ERROR_NONE;
+}
+
+/// <summary>
+/// appends an offset to a free list
+/// </summary>
+/// <param name="list">- address of the list</param>
+/// <param name="offset">- offset to append</param>
+/// <returns>ERROR_NONE on success, ERROR_ALLOC_FAIL on failure</returns>
+static err_t heap_list_push(heap_list_t* list, u64 offset)
+{
+	err_t err = heap_grow((mem*)&list->offsets, &list->capacity, list->count, sizeof(u64));
+
+	if (err != ERROR_NONE) return err;
+
+	list->offsets[list->count++] = offset;
+
+	return ERROR_NONE;
+}
+
+/// <summary>
+/// removes an offset from a free list if it is there
+/// </summary>
+/// <param name="list">- address of the list</param>
+/// <param name="offset">- offset to remove</param>
+/// <returns>true if the offset was free</returns>
+static i32 heap_list_take(heap_list_t* list, u64 offset)
+{
+	for (u32 i = 0; i < list->count; ++i)
+	{
+		if (list->offsets[i] != offset) continue;
+
+		list->offsets[i] = list->offsets[--list->count];
+
+		return true;
+	}
+
+	return false;
+}
+
+/// <summary>
+/// checks whether an offset is in a free list
+/// </summary>
+/// <param name="list">- address of the list</param>
+/// <param name="offset">- offset to look for</param>
+/// <returns>true if the offset is free</returns>
+static i32 heap_list_has(const heap_list_t* list, u64 offset)
+{
+	for (u32 i = 0; i < list->count; ++i)
+	{
+		if (list->offsets[i] == offset) return true;
+	}
+
+	return false;
+}
+
+/// <summary>
+/// fetches where an allocation starts inside its buddy range
+/// </summary>
+/// <param name="start">- offset of the buddy range</param>
+/// <param name="stride">- stride of the allocation</param>
+/// <returns>first multiple of the stride at or after the start</returns>
+static u64 heap_aligned(u64 start, u32 stride)
+{
+	if (stride <= 1) return start;
+
+	return (start + stride - 1) / stride * stride;
+}
+
+/// <summary>
+/// fetches the exponent of the smallest buddy range holding an allocation, with room to move its start to a multiple of its stride
+/// </summary>
+/// <param name="size">- bytes of the allocation</param>
+/// <param name="stride">- stride of the allocation</param>
+/// <returns>exponent of the range size</returns>
+static u32 heap_order(u64 size, u32 stride)
+{
+	// ranges start at multiples of the minimum size, so only strides that do not divide it need padding
+	if (stride > 1 && HEAP_MIN_SIZE % stride != 0) size += stride - 1;
+
+	u32 order = 0;
+
+	while (((u64)1 << order) < HEAP_MIN_SIZE || ((u64)1 << order) < size) ++order;
+
+	return order;
+}
+
+/// <summary>
+/// reserves another buffer object, entirely free
+/// </summary>
+/// <param name="heap">- address of the heap</param>
+/// <param name="blocks">- address of the blocks to append to</param>
+/// <param name="count">- address of the number of blocks</param>
+/// <returns>ERROR_NONE on success, ERROR_ALLOC_FAIL on failure</returns>
+static err_t heap_block_add(heap_t* heap, heap_block_t** blocks, u32* count)
+{
+	heap_block_t* resized = (heap_block_t*)realloc(*blocks, (*count + 1) * sizeof(heap_block_t));
+
+	if (resized == NULL) return error_alloc_fail("heap_block_t", (*count + 1) * sizeof(heap_block_t), __FILE__, __LINE__);
+
+	*blocks = resized;
+
+	heap_block_t* block = &resized[*count];
+
+	memset(block, 0, sizeof(heap_block_t));
+
+	err_t err = heap_list_push(&block->free[heap->block_order], 0);
+
+	if (err != ERROR_NONE) return err;
+
+	glGenBuffers(1, &block->buffer);
+	glBindBuffer(heap->target, block->buffer);
+	glBufferData(heap->target, heap->block_size, NULL, GL_STATIC_DRAW);
+
+	++*count;
+
+	return ERROR_NONE;
+}
+
+static void heap_block_release(heap_block_t* block)
+{
+	glDeleteBuffers(1, &block->buffer);
+
+	for (u32 i = 0; i < HEAP_ORDERS; ++i) free(block->free[i].offsets);
+}
+
+/// <summary>
+/// takes a free range of a size out of a block, splitting a larger one if none is free
+/// </summary>
+/// <param name="heap">- address of the heap</param>
+/// <param name="block">- address of the block</param>
+/// <param name="order">- exponent of the range size</param>
+/// <param name="start">- address of the offset of the range</param>
+/// <param name="taken">- address of whether the block had room</param>
+/// <returns>ERROR_NONE on success, ERROR_ALLOC_FAIL on failure</returns>
+static err_t heap_block_take(heap_t* heap, heap_block_t* block, u32 order, u64* start, i32* taken)
+{
+	*taken = false;
+
+	u32 found = order;
+
+	while (found <= heap->block_order && block->free[found].count == 0) ++found;
+
+	if (found > heap->block_order) return ERROR_NONE;
+
+	// room for the upper half of every split is made first, so a failed allocation leaves the block as it was
+	for (u32 i = order; i < found; ++i)
+	{
+		heap_list_t* half = &block->free[i];
+
+		err_t err = heap_grow((mem*)&half->offsets, &half->capacity, half->count, sizeof(u64));
+
+		if (err != ERROR_NONE) return err;
+	}
+
+	heap_list_t* list = &block->free[found];
+
+	*start = list->offsets[--list->count];
+
+	// the upper halves of every split are left free, from the largest down
+	while (found > order)
+	{
+		--found;
+
+		heap_list_t* half = &block->free[found];
+
+		half->offsets[half->count++] = *start + ((u64)1 << found);
+	}
+
+	*taken = true;
+
+	return ERROR_NONE;
+}
+
+/// <summary>
+/// returns a range to a block, merging it with its buddy for as long as the buddy is free
+/// </summary>
+/// <param name="heap">- address of the heap</param>
+/// <param name="block">- address of the block</param>
+/// <param name="order">- exponent of the range size</param>
+/// <param name="start">- offset of the range</param>
+/// <returns>ERROR_NONE on success, ERROR_ALLOC_FAIL on failure</returns>
+static err_t heap_block_give(heap_t* heap, heap_block_t* block, u32 order, u64 start)
+{
+	u32 merged = order;
+	u64 merged_start = start;
+
+	while (merged < heap->block_order && heap_list_has(&block->free[merged], merged_start ^ ((u64)1 << merged)))
+	{
+		merged_start &= ~((u64)1 << merged);
+
+		++merged;
+	}
+
+	// the list of the merged range is grown before any buddy is taken out, so a failed allocation leaves the block as it was
+	heap_list_t* list = &block->free[merged];
+
+	err_t err = heap_grow((mem*)&list->offsets, &list->capacity, list->count, sizeof(u64));
+
+	if (err != ERROR_NONE) return err;
+
+	while (order < merged)
+	{
+		heap_list_take(&block->free[order], start ^ ((u64)1 << order));
+
+		start &= ~((u64)1 << order);
+
+		++order;
+	}
+
+	list->offsets[list->count++] = start;
+
+	return ERROR_NONE;
+}
+
+/// <summary>
+/// fetches a live allocation by id
+/// </summary>
+/// <param name="heap">- address of the heap</param>
+/// <param name="id">- id of the allocation</param>
+/// <returns>address of the allocation, or null if there is none</returns>
+static heap_entry_t* heap_entry(heap_t* heap, u32 id)
+{
+	if (id == 0 || id > heap->entry_count) return NULL;
+
+	heap_entry_t* entry = &heap->entries[id - 1];
+
+	return entry->order >= 0 ? entry : NULL;
+}
+
+err_t heap_create(heap_t** heap, u32 target, u64 block_size)
+{
+	if (heap == NULL) return error_param_null("heap", __FILE__, __LINE__);
+	if (*heap != NULL) return error_param_notnull("*heap", __FILE__, __LINE__);
+
+	heap_t* creating = (heap_t*)calloc(1, sizeof(heap_t));
+
+	if (creating == NULL) return error_alloc_fail("heap_t", sizeof(heap_t), __FILE__, __LINE__);
+
+	if (block_size == 0) block_size = HEAP_BLOCK_SIZE;
+
+	creating->target = target;
+	creating->block_order = heap_order(block_size, 0);
+	creating->block_size = (u64)1 << creating->block_order;
+
+	*heap = creating;
+
+	return ERROR_NONE;
+}
+
+err_t heap_alloc(heap_t* heap, u64 size, u32 stride, u32* id)
+{
+	if (heap == NULL) return error_param_null("heap", __FILE__, __LINE__);
+	if (id == NULL) return error_param_null("id", __FILE__, __LINE__);
+
+	u32 order = heap_order(size, stride);
+
+	if (order > heap->block_order) return error_size_mismatch(size, heap->block_size, __FILE__, __LINE__);
+
+	err_t err = ERROR_NONE;
+
+	if (heap->spare_count == 0 && (err = heap_grow((mem*)&heap->entries, &heap->entry_capacity, heap->entry_count, sizeof(heap_entry_t))) != ERROR_NONE) return err;
+
+	// the first block with room is used, which keeps the later ones emptier
+	u32 block = 0;
+	u64 start = 0;
+	i32 taken = false;
+
+	for (; block < heap->block_count; ++block)
+	{
+		if ((err = heap_block_take(heap, &heap->blocks[block], order, &start, &taken)) != ERROR_NONE) return err;
+
+		if (taken) break;
+	}
+
+	if (!taken)
+	{
+		if ((err = heap_block_add(heap, &heap->blocks, &heap->block_count)) != ERROR_NONE) return err;
+
+		if ((err = heap_block_take(heap, &heap->blocks[block], order, &start, &taken)) != ERROR_NONE) return err;
+	}
+
+	*id = heap->spare_count > 0 ? heap->spare[--heap->spare_count] : ++heap->entry_count;
+
+	heap_entry_t* entry = &heap->entries[*id - 1];
+
+	entry->block = block;
+	entry->order = (i32)order;
+	entry->start = start;
+	entry->size = size;
+	entry->stride = stride;
+
+	return ERROR_NONE;
+}
+
+err_t heap_fetch(heap_t* heap, u32 id, heap_range_t* range)
+{
+	if (heap == NULL) return error_param_null("heap", __FILE__, __LINE__);
+	if (range == NULL) return error_param_null("range", __FILE__, __LINE__);
+
+	heap_entry_t* entry = heap_entry(heap, id);
+
+	if (entry == NULL) return error_missing_entry("heap allocation", __FILE__, __LINE__);
+
+	range->buffer = heap->blocks[entry->block].buffer;
+	range->offset = heap_aligned(entry->start, entry->stride);
+	range->size = entry->size;
+
+	return ERROR_NONE;
+}
+
+err_t heap_upload(heap_t* heap, u32 id, cmem data, u64 size)
+{
+	if (heap == NULL) return error_param_null("heap", __FILE__, __LINE__);
+	if (data == NULL) return error_param_null("data", __FILE__, __LINE__);
+
+	heap_range_t range;
+
+	err_t err = heap_fetch(heap, id, &range);
+
+	if (err != ERROR_NONE) return err;
+
+	if (size > range.size) return error_size_mismatch(size, range.size, __FILE__, __LINE__);
+
+	glBindBuffer(heap->target, range.buffer);
+	glBufferSubData(heap->target, range.offset, size, data);
+
+	return ERROR_NONE;
+}
+
+err_t heap_free(heap_t* heap, u32 id)
+{
+	if (heap == NULL) return error_param_null("heap", __FILE__, __LINE__);
+
+	heap_entry_t* entry = heap_entry(heap, id);
+
+	if (entry == NULL) return error_missing_entry("heap allocation", __FILE__, __LINE__);
+
+	// the id is kept before the range is given back, so the entry is never left freed but unlisted
+	err_t err = heap_grow((mem*)&heap->spare, &heap->spare_capacity, heap->spare_count, sizeof(u32));
+
+	if (err != ERROR_NONE) return err;
+
+	if ((err = heap_block_give(heap, &heap->blocks[entry->block], (u32)entry->order, entry->start)) != ERROR_NONE) return err;
+
+	entry->order = -1;
+
+	heap->spare[heap->spare_count++] = id;
+
+	return ERROR_NONE;
+}
+
+err_t heap_usage(heap_t* heap, u64* used, u64* reserved)
+{
+	if (heap == NULL) return error_param_null("heap", __FILE__, __LINE__);
+	if (used == NULL) return error_param_null("used", __FILE__, __LINE__);
+	if (reserved == NULL) return error_param_null("reserved", __FILE__, __LINE__);
+
+	*used = 0;
+
+	for (u32 i = 0; i < heap->entry_count; ++i)
+	{
+		if (heap->entries[i].order >= 0) *used += (u64)1 << heap->entries[i].order;
+	}
+
+	*reserved = heap->block_count * heap->block_size;
+
+	return ERROR_NONE;
+}
+
+/// <summary>an allocation being moved by heap_defragment, and where it goes</summary>
+typedef struct heap_move_t
+{
+	u32 index;
+	i32 order;
+	u32 block;
+	u64 start;
+} heap_move_t;
+
+static int heap_move_compare(const void* a, const void* b)
+{
+	const heap_move_t* move_a = (const heap_move_t*)a;
+	const heap_move_t* move_b = (const heap_move_t*)b;
+
+	if (move_a->order != move_b->order) return move_a->order > move_b->order ? -1 : 1;
+
+	return move_a->index < move_b->index ? -1 : 1;
+}
+
+err_t heap_defragment(heap_t* heap)
+{
+	if (heap == NULL) return error_param_null("heap", __FILE__, __LINE__);
+
+	u32 live = 0;
+
+	for (u32 i = 0; i < heap->entry_count; ++i)
+	{
+		if (heap->entries[i].order >= 0) ++live;
+	}
+
+	heap_move_t* moves = (heap_move_t*)malloc((live > 0 ? live : 1) * sizeof(heap_move_t));
+
+	if (moves == NULL) return error_alloc_fail("heap_move_t", live * sizeof(heap_move_t), __FILE__, __LINE__);
+
+	for (u32 i = 0, j = 0; i < heap->entry_count; ++i)
+	{
+		if (heap->entries[i].order < 0) continue;
+
+		moves[j].index = i;
+		moves[j].order = heap->entries[i].order;
+
+		++j;
+	}
+
+	// placing the largest ranges first leaves no holes between them, so the fewest blocks are needed
+	qsort(moves, live, sizeof(heap_move_t), heap_move_compare);
+
+	heap_block_t* blocks = NULL;
+	u32 block_count = 0;
+
+	err_t err = ERROR_NONE;
+
+	for (u32 i = 0; i < live && err == ERROR_NONE; ++i)
+	{
+		heap_move_t* move = &moves[i];
+
+		i32 taken = false;
+
+		for (move->block = 0; move->block < block_count; ++move->block)
+		{
+			if ((err = heap_block_take(heap, &blocks[move->block], (u32)move->order, &move->start, &taken)) != ERROR_NONE || taken) break;
+		}
+
+		if (err != ERROR_NONE || taken) continue;
+
+		if ((err = heap_block_add(heap, &blocks, &block_count)) == ERROR_NONE) err = heap_block_take(heap, &blocks[move->block], (u32)move->order, &move->start, &taken);
+	}
+
+	if (err != ERROR_NONE)
+	{
+		for (u32 i = 0; i < block_count; ++i) heap_block_release(&blocks[i]);
+
+		free(blocks);
+		free(moves);
+
+		return err;
+	}
+
+	// the new blocks are separate buffer objects, so no copy can overwrite a range another has yet to read
+	for (u32 i = 0; i < live; ++i)
+	{
+		heap_entry_t* entry = &heap->entries[moves[i].index];
+
+		glBindBuffer(GL_COPY_READ_BUFFER, heap->blocks[entry->block].buffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, blocks[moves[i].block].buffer);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, heap_aligned(entry->start, entry->stride), heap_aligned(moves[i].start, entry->stride), entry->size);
+
+		entry->block = moves[i].block;
+		entry->start = moves[i].start;
+	}
+
+	for (u32 i = 0; i < heap->block_count; ++i) heap_block_release(&heap->blocks[i]);
+
+	free(heap->blocks);
+	free(moves);
+
+	heap->blocks = blocks;
+	heap->block_count = block_count;
+
+	return ERROR_NONE;
+}
+
+err_t heap_destroy(heap_t** heap)
+{
+	if (heap == NULL) return error_param_null("heap", __FILE__, __LINE__);
+	if (*heap == NULL) return error_param_null("*heap", __FILE__, __LINE__);
+
+	heap_t* destroying = *heap;
+
+	for (u32 i = 0; i < destroying->block_count; ++i) heap_block_release(&destroying->blocks[i]);
+
+	free(destroying->blocks);
+	free(destroying->entries);
+	free(destroying->spare);
+	free(destroying);
+
+	*heap = NULL;
+
+	return ERROR_NONE;
+}
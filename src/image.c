@@ -3,6 +3,12 @@
 #include <GL/glew.h>
 #include <stb_image.h>
 
+#include "allocator.h"
+#include "memory.h"
+
+#include <limits.h>
+#include <string.h>
+
 err_t image_load(u32* handle, cstr path)
 {
 	if (handle == NULL) return error_param_null("handle", __FILE__, __LINE__);
@@ -58,6 +64,61 @@ err_t image_reload(u32* handle, cstr path)
 	return ERROR_NONE;
 }
 
+err_t image_decode(byte** pixels, i32* width, i32* height, const byte* data, u64 size, const allocator_t* allocator)
+{
+	if (pixels == NULL) return error_param_null("pixels", __FILE__, __LINE__);
+	if (width == NULL) return error_param_null("width", __FILE__, __LINE__);
+	if (height == NULL) return error_param_null("height", __FILE__, __LINE__);
+	if (data == NULL) return error_param_null("data", __FILE__, __LINE__);
+
+	if (*pixels != NULL) return error_param_notnull("*pixels", __FILE__, __LINE__);
+
+	if (size > INT_MAX) return error_size_mismatch(INT_MAX, size, __FILE__, __LINE__);
+
+	// the flip flag of stb_image is shared by every thread, so rows are flipped below instead
+	i32 channels;
+	byte* decoded = stbi_load_from_memory(data, (i32)size, width, height, &channels, 4);
+
+	if (decoded == NULL) return error_image_load(stbi_failure_reason(), __FILE__, __LINE__);
+
+	u64 row_size = (u64)*width * 4;
+
+	err_t err = allocator_alloc(allocator, (mem*)pixels, row_size * (u64)*height, MEMORY_ALIGNMENT);
+
+	if (err != ERROR_NONE)
+	{
+		stbi_image_free(decoded);
+
+		return err;
+	}
+
+	// copying the rows in reverse flips the image on its way into the allocator
+	for (i32 i = 0; i < *height; ++i)
+	{
+		memcpy(*pixels + (u64)(*height - 1 - i) * row_size, decoded + (u64)i * row_size, row_size);
+	}
+
+	stbi_image_free(decoded);
+
+	return ERROR_NONE;
+}
+
+err_t image_create(u32* handle, const byte* pixels, i32 width, i32 height)
+{
+	if (handle == NULL) return error_param_null("handle", __FILE__, __LINE__);
+	if (pixels == NULL) return error_param_null("pixels", __FILE__, __LINE__);
+
+	if (width % 2 != 0) return error_not_power_of_two("width", width, __FILE__, __LINE__);
+	if (height % 2 != 0) return error_not_power_of_two("height", height, __FILE__, __LINE__);
+
+	glGenTextures(1, handle);
+	glBindTexture(GL_TEXTURE_2D, *handle);
+
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+	return ERROR_NONE;
+}
+
 err_t image_destroy(u32* handle)
 {
 	if (handle == NULL) return error_param_null("handle", __FILE__, __LINE__);
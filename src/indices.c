@@ -0,0 +1,181 @@
+#include "indices.h"
+
+#include <string.h>
+
+u32 indices_max(const u32* indices, u64 count)
+{
+	u32 largest = 0;
+
+	if (indices == NULL) return largest;
+
+	for (u64 i = 0; i < count; ++i)
+		if (indices[i] > largest) largest = indices[i];
+
+	return largest;
+}
+
+container_type_t indices_narrowest(const u32* indices, u64 count)
+{
+	u32 largest = indices_max(indices, count);
+
+	if (largest <= 0xFF) return CONTAINER_TYPE_U8;
+	if (largest <= 0xFFFF) return CONTAINER_TYPE_U16;
+
+	return CONTAINER_TYPE_U32;
+}
+
+/// <summary>
+/// checks that a container type is one indices can be stored as
+/// </summary>
+static err_t indices_type_valid(container_type_t type)
+{
+	switch (type)
+	{
+		case CONTAINER_TYPE_U8:
+		case CONTAINER_TYPE_U16:
+		case CONTAINER_TYPE_U32:
+			return ERROR_NONE;
+
+		default: return error_unknown_enum("container_type_t", (i32)type, __FILE__, __LINE__);
+	}
+}
+
+/// <summary>
+/// stores one index at a position of an array of a narrower type, which has already been range checked
+/// </summary>
+static void indices_store(mem dest, u64 i, u32 index, container_type_t type)
+{
+	switch (type)
+	{
+		case CONTAINER_TYPE_U8:
+			((u8*)dest)[i] = (u8)index;
+			break;
+		case CONTAINER_TYPE_U16:
+			((u16*)dest)[i] = (u16)index;
+			break;
+		default:
+			((u32*)dest)[i] = index;
+			break;
+	}
+}
+
+err_t indices_narrow(mem dest, const u32* src, u64 count, container_type_t type)
+{
+	if (dest == NULL) return error_param_null("dest", __FILE__, __LINE__);
+	if (src == NULL) return error_param_null("src", __FILE__, __LINE__);
+
+	err_t err = indices_type_valid(type);
+
+	if (err != ERROR_NONE) return err;
+
+	u32 limit = type == CONTAINER_TYPE_U8 ? 0xFF : type == CONTAINER_TYPE_U16 ? 0xFFFF : 0xFFFFFFFF;
+
+	for (u64 i = 0; i < count; ++i)
+	{
+		if (src[i] > limit) return error_size_mismatch(limit, src[i], __FILE__, __LINE__);
+
+		indices_store(dest, i, src[i], type);
+	}
+
+	return ERROR_NONE;
+}
+
+err_t indices_widen(u32* dest, cmem src, u64 count, container_type_t type)
+{
+	if (dest == NULL) return error_param_null("dest", __FILE__, __LINE__);
+	if (src == NULL) return error_param_null("src", __FILE__, __LINE__);
+
+	err_t err = indices_type_valid(type);
+
+	if (err != ERROR_NONE) return err;
+
+	switch (type)
+	{
+		case CONTAINER_TYPE_U8:
+			for (u64 i = 0; i < count; ++i) dest[i] = ((const u8*)src)[i];
+			break;
+		case CONTAINER_TYPE_U16:
+			for (u64 i = 0; i < count; ++i) dest[i] = ((const u16*)src)[i];
+			break;
+		default:
+			memcpy(dest, src, count * sizeof(u32));
+			break;
+	}
+
+	return ERROR_NONE;
+}
+
+err_t indices_encode(byte* dest, u64* length, const u32* src, u64 count)
+{
+	if (dest == NULL) return error_param_null("dest", __FILE__, __LINE__);
+	if (length == NULL) return error_param_null("length", __FILE__, __LINE__);
+
+	if (src == NULL && count > 0) return error_param_null("src", __FILE__, __LINE__);
+
+	byte* op = dest;
+	u32 previous = 0;
+
+	for (u64 i = 0; i < count; ++i)
+	{
+		// the difference wraps modulo 2^32 and zigzag folds its sign into the low bit, keeping small steps either way small
+		u32 delta = src[i] - previous;
+		u32 zigzag = (delta << 1) ^ (0u - (delta >> 31));
+
+		previous = src[i];
+
+		while (zigzag >= 0x80)
+		{
+			*op++ = (byte)(zigzag | 0x80);
+			zigzag >>= 7;
+		}
+
+		*op++ = (byte)zigzag;
+	}
+
+	*length = (u64)(op - dest);
+
+	return ERROR_NONE;
+}
+
+err_t indices_decode(mem dest, u64 count, container_type_t type, const byte* src, u64 length)
+{
+	if (dest == NULL && count > 0) return error_param_null("dest", __FILE__, __LINE__);
+	if (src == NULL && length > 0) return error_param_null("src", __FILE__, __LINE__);
+
+	err_t err = indices_type_valid(type);
+
+	if (err != ERROR_NONE) return err;
+
+	u32 limit = type == CONTAINER_TYPE_U8 ? 0xFF : type == CONTAINER_TYPE_U16 ? 0xFFFF : 0xFFFFFFFF;
+
+	const byte* ip = src;
+	const byte* ip_end = src + length;
+
+	u32 previous = 0;
+
+	for (u64 i = 0; i < count; ++i)
+	{
+		u32 zigzag = 0;
+		u32 shift = 0;
+		byte next;
+
+		do
+		{
+			if (ip >= ip_end || shift >= 7 * INDICES_VARINT_MAX) return error_invalid_container("truncated index", __FILE__, __LINE__);
+
+			next = *ip++;
+			zigzag |= (u32)(next & 0x7F) << shift;
+			shift += 7;
+		} while (next & 0x80);
+
+		previous += (zigzag >> 1) ^ (0u - (zigzag & 1));
+
+		if (previous > limit) return error_invalid_container("index out of range", __FILE__, __LINE__);
+
+		indices_store(dest, i, previous, type);
+	}
+
+	if (ip != ip_end) return error_invalid_container("trailing index bytes", __FILE__, __LINE__);
+
+	return ERROR_NONE;
+}
@@ -0,0 +1,343 @@
+#include "layout.h"
+
+#include <GL/glew.h>
+
+#include "endian.h"
+
+#include <string.h>
+
+#define LAYOUT_FNV_OFFSET 14695981039346656037ull
+#define LAYOUT_FNV_PRIME 1099511628211ull
+
+/// <summary>
+/// checks the fields of one attribute against the stride of its layout
+/// </summary>
+/// <param name="attribute">- address of the attribute</param>
+/// <param name="stride">- stride of the layout in bytes</param>
+/// <returns>ERROR_NONE on success, ERROR_INVALID_LAYOUT on failure</returns>
+static err_t layout_attribute_validate(const layout_attribute_t* attribute, u32 stride)
+{
+	u64 type_size = container_type_size(attribute->type);
+
+	// opengl has no 64-bit float conversion for vertex attributes
+	if (type_size == 0 || attribute->type == CONTAINER_TYPE_U64) return error_invalid_layout("attribute type", __FILE__, __LINE__);
+
+	if (attribute->components == 0 || attribute->components > 4) return error_invalid_layout("attribute components", __FILE__, __LINE__);
+
+	if (attribute->offset % type_size != 0 || attribute->offset > stride || type_size * attribute->components > stride - attribute->offset) return error_invalid_layout("attribute offset", __FILE__, __LINE__);
+
+	return ERROR_NONE;
+}
+
+err_t layout_validate(const layout_t* layout)
+{
+	if (layout == NULL) return error_param_null("layout", __FILE__, __LINE__);
+
+	if (layout->count == 0 || layout->count > LAYOUT_ATTRIBUTES_MAX) return error_invalid_layout("attribute count", __FILE__, __LINE__);
+
+	if (layout->stride == 0 || layout->stride % LAYOUT_ALIGNMENT != 0) return error_invalid_layout("stride", __FILE__, __LINE__);
+
+	for (u32 i = 0; i < layout->count; ++i)
+	{
+		err_t err = layout_attribute_validate(&layout->attributes[i], layout->stride);
+
+		if (err != ERROR_NONE) return err;
+
+		for (u32 j = 0; j < i; ++j)
+		{
+			if (layout->attributes[j].index == layout->attributes[i].index) return error_invalid_layout("duplicate index", __FILE__, __LINE__);
+		}
+	}
+
+	return ERROR_NONE;
+}
+
+err_t layout_init(layout_t* layout)
+{
+	if (layout == NULL) return error_param_null("layout", __FILE__, __LINE__);
+
+	memset(layout, 0, sizeof(layout_t));
+
+	return ERROR_NONE;
+}
+
+err_t layout_add(layout_t* layout, u32 index, container_type_t type, u32 components, i32 normalized)
+{
+	if (layout == NULL) return error_param_null("layout", __FILE__, __LINE__);
+
+	if (layout->count == LAYOUT_ATTRIBUTES_MAX) return error_invalid_layout("too many attributes", __FILE__, __LINE__);
+
+	for (u32 i = 0; i < layout->count; ++i)
+	{
+		if (layout->attributes[i].index == index) return error_invalid_layout("duplicate index", __FILE__, __LINE__);
+	}
+
+	// the stride is kept aligned, so the end of the last attribute is always a valid offset for the next
+	layout_attribute_t attribute = { index, type, components, layout->stride, normalized != 0 };
+
+	u64 type_size = container_type_size(type);
+	u64 end = (u64)attribute.offset + type_size * components;
+
+	err_t err = layout_attribute_validate(&attribute, (u32)((end + LAYOUT_ALIGNMENT - 1) / LAYOUT_ALIGNMENT * LAYOUT_ALIGNMENT));
+
+	if (err != ERROR_NONE) return err;
+
+	layout->attributes[layout->count++] = attribute;
+	layout->stride = (u32)((end + LAYOUT_ALIGNMENT - 1) / LAYOUT_ALIGNMENT * LAYOUT_ALIGNMENT);
+
+	return ERROR_NONE;
+}
+
+err_t layout_add_quantized(layout_t* layout, u32 index, quantize_format_t format, u32 components)
+{
+	container_type_t type;
+	i32 normalized;
+
+	err_t err = quantize_format_type(format, &type, &normalized);
+
+	if (err != ERROR_NONE) return err;
+
+	return layout_add(layout, index, type, components, normalized);
+}
+
+/// <summary>
+/// copies a u32 into a table in a byte order
+/// </summary>
+/// <param name="dest">- destination of 4 bytes</param>
+/// <param name="value">- value in the system byte order</param>
+/// <param name="swap">- true to reverse the byte order</param>
+static void layout_put_u32(byte* dest, u32 value, i32 swap)
+{
+	if (swap) endian_swap_u32s(&value, &value, 1);
+
+	memcpy(dest, &value, sizeof(u32));
+}
+
+/// <summary>
+/// copies a u32 out of a table in a byte order
+/// </summary>
+/// <param name="src">- source of 4 bytes</param>
+/// <param name="swap">- true to reverse the byte order</param>
+/// <returns>the value in the system byte order</returns>
+static u32 layout_get_u32(const byte* src, i32 swap)
+{
+	u32 value;
+
+	memcpy(&value, src, sizeof(u32));
+
+	if (swap) endian_swap_u32s(&value, &value, 1);
+
+	return value;
+}
+
+err_t layout_write(byte* table, const layout_t* layout, u8 endianness)
+{
+	if (table == NULL) return error_param_null("table", __FILE__, __LINE__);
+	if (layout == NULL) return error_param_null("layout", __FILE__, __LINE__);
+
+	i32 swap = endianness != endianness_detect();
+
+	memset(table, 0, LAYOUT_TABLE_SIZE(layout->count));
+
+	layout_put_u32(table, layout->count, swap);
+	layout_put_u32(table + 4, layout->stride, swap);
+
+	for (u32 i = 0; i < layout->count; ++i)
+	{
+		const layout_attribute_t* attribute = &layout->attributes[i];
+
+		byte* record = table + LAYOUT_TABLE_SIZE(i);
+
+		layout_put_u32(record, attribute->index, swap);
+		layout_put_u32(record + 4, attribute->offset, swap);
+
+		record[8] = (u8)attribute->type;
+		record[9] = (u8)attribute->components;
+		record[10] = (u8)(attribute->normalized != 0);
+	}
+
+	return ERROR_NONE;
+}
+
+err_t layout_read(layout_t* layout, const byte* table, u64 length, u8 endianness)
+{
+	if (layout == NULL) return error_param_null("layout", __FILE__, __LINE__);
+	if (table == NULL) return error_param_null("table", __FILE__, __LINE__);
+
+	i32 swap = endianness != endianness_detect();
+
+	if (length < LAYOUT_TABLE_SIZE(0)) return error_invalid_layout("table length", __FILE__, __LINE__);
+
+	layout_init(layout);
+
+	u32 count = layout_get_u32(table, swap);
+
+	if (count == 0 || count > LAYOUT_ATTRIBUTES_MAX) return error_invalid_layout("attribute count", __FILE__, __LINE__);
+
+	if (length < LAYOUT_TABLE_SIZE(count)) return error_invalid_layout("table length", __FILE__, __LINE__);
+
+	layout->count = count;
+	layout->stride = layout_get_u32(table + 4, swap);
+
+	for (u32 i = 0; i < count; ++i)
+	{
+		layout_attribute_t* attribute = &layout->attributes[i];
+
+		const byte* record = table + LAYOUT_TABLE_SIZE(i);
+
+		attribute->index = layout_get_u32(record, swap);
+		attribute->offset = layout_get_u32(record + 4, swap);
+		attribute->type = (container_type_t)record[8];
+		attribute->components = record[9];
+		attribute->normalized = record[10] != 0;
+	}
+
+	return layout_validate(layout);
+}
+
+err_t layout_interleave(mem dest, const layout_t* layout, const cmem* arrays, u64 count)
+{
+	if (dest == NULL) return error_param_null("dest", __FILE__, __LINE__);
+	if (layout == NULL) return error_param_null("layout", __FILE__, __LINE__);
+	if (arrays == NULL) return error_param_null("arrays", __FILE__, __LINE__);
+
+	u64 packed = 0;
+
+	for (u32 i = 0; i < layout->count; ++i)
+	{
+		if (arrays[i] == NULL) return error_param_null("arrays[i]", __FILE__, __LINE__);
+
+		packed += container_type_size(layout->attributes[i].type) * layout->attributes[i].components;
+	}
+
+	// padding is only cleared when the attributes leave gaps, so the output stays deterministic without a second pass otherwise
+	if (packed != layout->stride) memset(dest, 0, count * layout->stride);
+
+	for (u32 i = 0; i < layout->count; ++i)
+	{
+		const layout_attribute_t* attribute = &layout->attributes[i];
+
+		u64 size = container_type_size(attribute->type) * attribute->components;
+
+		// each source is read front to back while the destination is written at the stride
+		const byte* src = (const byte*)arrays[i];
+		byte* vertex = (byte*)dest + attribute->offset;
+
+		for (u64 j = 0; j < count; ++j)
+		{
+			memcpy(vertex, src, size);
+
+			src += size;
+			vertex += layout->stride;
+		}
+	}
+
+	return ERROR_NONE;
+}
+
+err_t layout_swap(mem vertices, const layout_t* layout, u64 count)
+{
+	if (vertices == NULL) return error_param_null("vertices", __FILE__, __LINE__);
+	if (layout == NULL) return error_param_null("layout", __FILE__, __LINE__);
+
+	for (u32 i = 0; i < layout->count; ++i)
+	{
+		const layout_attribute_t* attribute = &layout->attributes[i];
+
+		u64 type_size = container_type_size(attribute->type);
+
+		if (type_size < 2) continue;
+
+		byte* vertex = (byte*)vertices + attribute->offset;
+
+		for (u64 j = 0; j < count; ++j)
+		{
+			endian_swap_array(vertex, vertex, type_size, attribute->components);
+
+			vertex += layout->stride;
+		}
+	}
+
+	return ERROR_NONE;
+}
+
+/// <summary>
+/// fetches the opengl type of a container type
+/// </summary>
+/// <param name="type">- container type</param>
+/// <returns>the opengl type, or 0 for a type vertex attributes cannot hold</returns>
+static u32 layout_gl_type(container_type_t type)
+{
+	switch (type)
+	{
+		case CONTAINER_TYPE_U8: return GL_UNSIGNED_BYTE;
+		case CONTAINER_TYPE_U16: return GL_UNSIGNED_SHORT;
+		case CONTAINER_TYPE_U32: return GL_UNSIGNED_INT;
+		case CONTAINER_TYPE_F32: return GL_FLOAT;
+		case CONTAINER_TYPE_F16: return GL_HALF_FLOAT;
+		case CONTAINER_TYPE_I16: return GL_SHORT;
+
+		default: return 0;
+	}
+}
+
+err_t layout_apply(const layout_t* layout, u64 offset)
+{
+	if (layout == NULL) return error_param_null("layout", __FILE__, __LINE__);
+
+	err_t err = layout_validate(layout);
+
+	if (err != ERROR_NONE) return err;
+
+	for (u32 i = 0; i < layout->count; ++i)
+	{
+		const layout_attribute_t* attribute = &layout->attributes[i];
+
+		// integer attributes are converted to floats as they are fetched, so shaders keep their vecN inputs
+		glVertexAttribPointer(attribute->index, attribute->components, layout_gl_type(attribute->type), attribute->normalized ? GL_TRUE : GL_FALSE, layout->stride, (const void*)(uptr)(offset + attribute->offset));
+		glEnableVertexAttribArray(attribute->index);
+	}
+
+	return ERROR_NONE;
+}
+
+/// <summary>
+/// folds the bytes of a value into an fnv-1a hash, least significant first so the hash is the same in either byte order
+/// </summary>
+/// <param name="hash">- hash so far</param>
+/// <param name="value">- value to fold in</param>
+/// <returns>the updated hash</returns>
+static u64 layout_hash_u32(u64 hash, u32 value)
+{
+	for (u32 i = 0; i < 4; ++i)
+	{
+		hash ^= (value >> (i * 8)) & 0xFF;
+		hash *= LAYOUT_FNV_PRIME;
+	}
+
+	return hash;
+}
+
+u64 layout_hash(const layout_t* layout)
+{
+	if (layout == NULL) return 0;
+
+	u64 hash = LAYOUT_FNV_OFFSET;
+
+	hash = layout_hash_u32(hash, layout->count);
+	hash = layout_hash_u32(hash, layout->stride);
+
+	// only the attributes in use are hashed, so stale entries past the count never split equal layouts
+	for (u32 i = 0; i < layout->count; ++i)
+	{
+		const layout_attribute_t* attribute = &layout->attributes[i];
+
+		hash = layout_hash_u32(hash, attribute->index);
+		hash = layout_hash_u32(hash, (u32)attribute->type);
+		hash = layout_hash_u32(hash, attribute->components);
+		hash = layout_hash_u32(hash, attribute->offset);
+		hash = layout_hash_u32(hash, attribute->normalized ? 1 : 0);
+	}
+
+	return hash;
+}
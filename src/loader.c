@@ -0,0 +1,422 @@
+#include "loader.h"
+
+#include "allocator.h"
+#include "reader.h"
+#include "thread.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/// <summary>one read, moved from the queued list to the running list to the finished list</summary>
+typedef struct loader_request_t
+{
+	struct loader_request_t* next;
+
+	// holds the path, copied into the same allocation after the request
+	loader_result_t result;
+	const struct allocator_t* allocator;
+	loader_process_t process;
+	loader_callback_t callback;
+	ptr user;
+	// set when the read is cancelled while running, so its contents are dropped once it finishes
+	i32 cancelled;
+} loader_request_t;
+
+/// <summary>a first-in first-out list of requests</summary>
+typedef struct loader_list_t
+{
+	loader_request_t* head;
+	loader_request_t* tail;
+	u32 count;
+} loader_list_t;
+
+typedef struct loader_t
+{
+	struct thread_t** threads;
+	u32 count;
+
+	struct mutex_t* mutex;
+	// signalled when a read is queued or the loader is stopping
+	struct condition_t* wake;
+	// signalled when a read finishes
+	struct condition_t* done;
+
+	loader_list_t queued;
+	loader_list_t running;
+	loader_list_t finished;
+
+	// handle of the next read, starting at 1 so 0 is never a valid handle
+	u64 next;
+	i32 stopping;
+} loader_t;
+
+/// <summary>
+/// appends a request to the end of a list
+/// </summary>
+/// <param name="list">- address of the list</param>
+/// <param name="request">- address of the request</param>
+static void loader_list_push(loader_list_t* list, loader_request_t* request)
+{
+	request->next = NULL;
+
+	if (list->tail != NULL) list->tail->next = request;
+	else list->head = request;
+
+	list->tail = request;
+
+	++list->count;
+}
+
+/// <summary>
+/// unlinks a request from a list
+/// </summary>
+/// <param name="list">- address of the list</param>
+/// <param name="request">- address of the request, which must be in the list</param>
+static void loader_list_remove(loader_list_t* list, loader_request_t* request)
+{
+	loader_request_t* previous = NULL;
+
+	for (loader_request_t* it = list->head; it != request; it = it->next) previous = it;
+
+	if (previous != NULL) previous->next = request->next;
+	else list->head = request->next;
+
+	if (list->tail == request) list->tail = previous;
+
+	request->next = NULL;
+
+	--list->count;
+}
+
+/// <summary>
+/// finds a request in a list by its handle
+/// </summary>
+/// <param name="list">- address of the list</param>
+/// <param name="handle">- handle of the read</param>
+/// <returns>address of the request, or null if it is not in the list</returns>
+static loader_request_t* loader_list_find(const loader_list_t* list, u64 handle)
+{
+	for (loader_request_t* it = list->head; it != NULL; it = it->next)
+	{
+		if (it->result.request == handle) return it;
+	}
+
+	return NULL;
+}
+
+/// <summary>
+/// frees a request along with any contents it still owns
+/// </summary>
+/// <param name="request">- address of the request</param>
+static void loader_request_release(loader_request_t* request)
+{
+	allocator_free(request->allocator, &request->result.data);
+
+	free(request);
+}
+
+/// <summary>
+/// reads the file of a request into its result and processes it; called without the mutex held
+/// </summary>
+/// <param name="request">- address of the request</param>
+static void loader_request_run(loader_request_t* request)
+{
+	loader_result_t* result = &request->result;
+
+	if (result->kind == LOADER_KIND_STRING)
+	{
+		str content = NULL;
+
+		result->err = reader_string_ex(result->path, &content, request->allocator);
+
+		result->data = content;
+		result->size = content != NULL ? strlen(content) : 0;
+	}
+	else
+	{
+		byte* buffer = NULL;
+
+		result->err = reader_binary_sized_ex(result->path, &buffer, &result->size, request->allocator);
+
+		result->data = buffer;
+	}
+
+	if (result->err != ERROR_NONE || request->process == NULL) return;
+
+	result->err = request->process(result, request->allocator, request->user);
+
+	// a failed result never carries contents, so callbacks need not tell partial data from none
+	if (result->err != ERROR_NONE)
+	{
+		allocator_free(request->allocator, &result->data);
+
+		result->size = 0;
+	}
+}
+
+static err_t loader_entry(ptr user)
+{
+	loader_t* loader = (loader_t*)user;
+
+	mutex_lock(loader->mutex);
+
+	forever
+	{
+		while (!loader->stopping && loader->queued.head == NULL) condition_wait(loader->wake, loader->mutex);
+
+		// reads not yet started are dropped by loader_destroy, so a stopping thread takes no more
+		if (loader->stopping) break;
+
+		loader_request_t* request = loader->queued.head;
+
+		loader_list_remove(&loader->queued, request);
+		loader_list_push(&loader->running, request);
+
+		mutex_unlock(loader->mutex);
+
+		loader_request_run(request);
+
+		mutex_lock(loader->mutex);
+
+		loader_list_remove(&loader->running, request);
+
+		if (request->cancelled) loader_request_release(request);
+		else loader_list_push(&loader->finished, request);
+
+		condition_broadcast(loader->done);
+	}
+
+	mutex_unlock(loader->mutex);
+
+	return ERROR_NONE;
+}
+
+err_t loader_create(loader_t** loader, u32 threads)
+{
+	if (loader == NULL) return error_param_null("loader", __FILE__, __LINE__);
+	if (*loader != NULL) return error_param_notnull("*loader", __FILE__, __LINE__);
+
+	// the threads mostly sleep on the disk, so they are not held to the free hardware threads like the workers
+	if (threads == 0) threads = thread_concurrency() < LOADER_THREADS ? thread_concurrency() : LOADER_THREADS;
+
+	loader_t* creating = (loader_t*)calloc(1, sizeof(loader_t));
+
+	if (creating == NULL) return error_alloc_fail("loader_t", sizeof(loader_t), __FILE__, __LINE__);
+
+	creating->next = 1;
+	creating->threads = (struct thread_t**)calloc(threads, sizeof(struct thread_t*));
+
+	err_t err = creating->threads != NULL ? ERROR_NONE : error_alloc_fail("thread_t", threads * sizeof(struct thread_t*), __FILE__, __LINE__);
+
+	if (err == ERROR_NONE) err = mutex_create(&creating->mutex);
+	if (err == ERROR_NONE) err = condition_create(&creating->wake);
+	if (err == ERROR_NONE) err = condition_create(&creating->done);
+
+	for (u32 i = 0; i < threads && err == ERROR_NONE; ++i)
+	{
+		err = thread_create(&creating->threads[i], loader_entry, creating);
+
+		if (err == ERROR_NONE) ++creating->count;
+	}
+
+	if (err != ERROR_NONE)
+	{
+		loader_destroy(&creating);
+
+		return err;
+	}
+
+	*loader = creating;
+
+	return ERROR_NONE;
+}
+
+err_t loader_read(loader_t* loader, cstr path, loader_kind_t kind, const struct allocator_t* allocator, loader_callback_t callback, ptr user, u64* request)
+{
+	return loader_read_ex(loader, path, kind, allocator, NULL, callback, user, request);
+}
+
+err_t loader_read_ex(loader_t* loader, cstr path, loader_kind_t kind, const struct allocator_t* allocator, loader_process_t process, loader_callback_t callback, ptr user, u64* request)
+{
+	if (loader == NULL) return error_param_null("loader", __FILE__, __LINE__);
+	if (path == NULL) return error_param_null("path", __FILE__, __LINE__);
+	if (callback == NULL) return error_param_null("callback", __FILE__, __LINE__);
+
+	if (kind != LOADER_KIND_BINARY && kind != LOADER_KIND_STRING) return error_unknown_enum("loader_kind_t", (i32)kind, __FILE__, __LINE__);
+
+	u64 path_size = strlen(path) + 1;
+
+	loader_request_t* queuing = (loader_request_t*)calloc(1, sizeof(loader_request_t) + path_size);
+
+	if (queuing == NULL) return error_alloc_fail("loader_request_t", sizeof(loader_request_t) + path_size, __FILE__, __LINE__);
+
+	memcpy(queuing + 1, path, path_size);
+
+	queuing->result.path = (cstr)(queuing + 1);
+	queuing->result.kind = kind;
+	queuing->allocator = allocator;
+	queuing->process = process;
+	queuing->callback = callback;
+	queuing->user = user;
+
+	mutex_lock(loader->mutex);
+
+	queuing->result.request = loader->next++;
+
+	if (request != NULL) *request = queuing->result.request;
+
+	loader_list_push(&loader->queued, queuing);
+
+	condition_signal(loader->wake);
+
+	mutex_unlock(loader->mutex);
+
+	return ERROR_NONE;
+}
+
+err_t loader_cancel(loader_t* loader, u64 request)
+{
+	if (loader == NULL) return error_param_null("loader", __FILE__, __LINE__);
+
+	mutex_lock(loader->mutex);
+
+	loader_request_t* cancelling = NULL;
+
+	if ((cancelling = loader_list_find(&loader->queued, request)) != NULL)
+	{
+		loader_list_remove(&loader->queued, cancelling);
+		loader_request_release(cancelling);
+	}
+	else if ((cancelling = loader_list_find(&loader->finished, request)) != NULL)
+	{
+		loader_list_remove(&loader->finished, cancelling);
+		loader_request_release(cancelling);
+	}
+	else if ((cancelling = loader_list_find(&loader->running, request)) != NULL)
+	{
+		// the thread reading it still holds the request, and frees it once the read returns
+		cancelling->cancelled = true;
+	}
+
+	mutex_unlock(loader->mutex);
+
+	return ERROR_NONE;
+}
+
+u32 loader_pending(loader_t* loader)
+{
+	if (loader == NULL) return 0;
+
+	mutex_lock(loader->mutex);
+
+	u32 pending = loader->queued.count + loader->finished.count;
+
+	// a cancelled read still running no longer counts, as its callback will never be called
+	for (loader_request_t* it = loader->running.head; it != NULL; it = it->next)
+	{
+		if (!it->cancelled) ++pending;
+	}
+
+	mutex_unlock(loader->mutex);
+
+	return pending;
+}
+
+err_t loader_drain(loader_t* loader, u32 limit)
+{
+	if (loader == NULL) return error_param_null("loader", __FILE__, __LINE__);
+
+	err_t err = ERROR_NONE;
+
+	for (u32 i = 0; limit == 0 || i < limit; ++i)
+	{
+		mutex_lock(loader->mutex);
+
+		loader_request_t* request = loader->finished.head;
+
+		if (request != NULL) loader_list_remove(&loader->finished, request);
+
+		mutex_unlock(loader->mutex);
+
+		if (request == NULL) break;
+
+		// the callback runs without the lock, so it may queue further reads
+		err_t callback_err = request->callback(&request->result, request->user);
+
+		if (err == ERROR_NONE) err = callback_err;
+
+		// the contents now belong to the callback
+		free(request);
+	}
+
+	return err;
+}
+
+err_t loader_finish(loader_t* loader)
+{
+	if (loader == NULL) return error_param_null("loader", __FILE__, __LINE__);
+
+	mutex_lock(loader->mutex);
+
+	while (loader->queued.head != NULL || loader->running.head != NULL) condition_wait(loader->done, loader->mutex);
+
+	mutex_unlock(loader->mutex);
+
+	return ERROR_NONE;
+}
+
+err_t loader_destroy(loader_t** loader)
+{
+	if (loader == NULL) return error_param_null("loader", __FILE__, __LINE__);
+	if (*loader == NULL) return error_param_null("*loader", __FILE__, __LINE__);
+
+	loader_t* destroying = *loader;
+
+	err_t err = ERROR_NONE;
+
+	if (destroying->mutex != NULL && destroying->wake != NULL)
+	{
+		mutex_lock(destroying->mutex);
+
+		destroying->stopping = true;
+
+		condition_broadcast(destroying->wake);
+
+		mutex_unlock(destroying->mutex);
+	}
+
+	for (u32 i = 0; i < destroying->count; ++i)
+	{
+		err_t join_err = thread_join(&destroying->threads[i], NULL);
+
+		if (err == ERROR_NONE) err = join_err;
+	}
+
+	// with every thread joined, the running list is empty and the rest are dropped unread or undelivered
+	while (destroying->queued.head != NULL)
+	{
+		loader_request_t* request = destroying->queued.head;
+
+		loader_list_remove(&destroying->queued, request);
+		loader_request_release(request);
+	}
+
+	while (destroying->finished.head != NULL)
+	{
+		loader_request_t* request = destroying->finished.head;
+
+		loader_list_remove(&destroying->finished, request);
+		loader_request_release(request);
+	}
+
+	if (destroying->done != NULL) condition_destroy(&destroying->done);
+	if (destroying->wake != NULL) condition_destroy(&destroying->wake);
+	if (destroying->mutex != NULL) mutex_destroy(&destroying->mutex);
+
+	free(destroying->threads);
+	free(destroying);
+
+	*loader = NULL;
+
+	return err;
+}
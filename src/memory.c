@@ -0,0 +1,47 @@
+#include "memory.h"
+
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+err_t memory_aligned_alloc(mem* memory, u64 size, u64 alignment)
+{
+	if (memory == NULL) return error_param_null("memory", __FILE__, __LINE__);
+	if (*memory != NULL) return error_param_notnull("*memory", __FILE__, __LINE__);
+
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0) return error_not_power_of_two("alignment", alignment, __FILE__, __LINE__);
+
+	// zero-sized requests still hand back a unique block so that success always means non-null
+	u64 block_size = size > 0 ? size : 1;
+
+#ifdef _WIN32
+	*memory = _aligned_malloc((size_t)block_size, (size_t)alignment);
+#else
+	if (alignment < sizeof(void*)) alignment = sizeof(void*);
+
+	if (posix_memalign(memory, (size_t)alignment, (size_t)block_size) != 0) *memory = NULL;
+#endif
+
+	if (*memory == NULL) return error_alloc_fail("mem", block_size, __FILE__, __LINE__);
+
+	return ERROR_NONE;
+}
+
+err_t memory_aligned_free(mem* memory)
+{
+	if (memory == NULL) return error_param_null("memory", __FILE__, __LINE__);
+
+	if (*memory == NULL) return ERROR_NONE;
+
+#ifdef _WIN32
+	_aligned_free(*memory);
+#else
+	free(*memory);
+#endif
+
+	*memory = NULL;
+
+	return ERROR_NONE;
+}
@@ -0,0 +1,467 @@
+#include "pack.h"
+
+#include "endian.h"
+#include "reader.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define PACK_FNV_OFFSET 14695981039346656037ull
+#define PACK_FNV_PRIME 1099511628211ull
+
+/// <summary>the 64-byte header at the start of a pack, little-endian on disk</summary>
+typedef struct pack_header_t
+{
+	byte magic[4];
+	u16 version;
+	u8 endianness;
+	u8 padding;
+	u32 entry_count;
+	// power of two, at least twice the entry count so probes stay short
+	u32 bucket_count;
+	u64 toc_offset;
+	u64 bucket_offset;
+	u64 names_offset;
+	u64 names_length;
+	u64 size;
+	byte reserved[8];
+} pack_header_t;
+
+/// <summary>one table of contents record, little-endian on disk</summary>
+typedef struct pack_record_t
+{
+	u64 hash;
+	u64 offset;
+	u64 size;
+	u32 name_offset;
+	u32 name_length;
+	u32 type;
+	u32 reserved;
+} pack_record_t;
+
+typedef struct pack_item_t
+{
+	str name;
+	str path;
+	pack_type_t type;
+} pack_item_t;
+
+typedef struct pack_builder_t
+{
+	pack_item_t* items;
+	u32 count;
+	u32 capacity;
+} pack_builder_t;
+
+typedef struct pack_t
+{
+	reader_map_t map;
+	pack_header_t header;
+	i32 swap;
+} pack_t;
+
+static u64 pack_hash(cstr name, u64 length)
+{
+	u64 hash = PACK_FNV_OFFSET;
+
+	for (u64 i = 0; i < length; ++i)
+	{
+		hash ^= (byte)name[i];
+		hash *= PACK_FNV_PRIME;
+	}
+
+	return hash;
+}
+
+static void pack_header_swap(pack_header_t* header)
+{
+	endian_swap_u16s(&header->version, &header->version, 1);
+	endian_swap_u32s(&header->entry_count, &header->entry_count, 1);
+	endian_swap_u32s(&header->bucket_count, &header->bucket_count, 1);
+	endian_swap_u64s(&header->toc_offset, &header->toc_offset, 1);
+	endian_swap_u64s(&header->bucket_offset, &header->bucket_offset, 1);
+	endian_swap_u64s(&header->names_offset, &header->names_offset, 1);
+	endian_swap_u64s(&header->names_length, &header->names_length, 1);
+	endian_swap_u64s(&header->size, &header->size, 1);
+}
+
+static void pack_record_swap(pack_record_t* record)
+{
+	endian_swap_u64s(&record->hash, &record->hash, 1);
+	endian_swap_u64s(&record->offset, &record->offset, 1);
+	endian_swap_u64s(&record->size, &record->size, 1);
+	endian_swap_u32s(&record->name_offset, &record->name_offset, 1);
+	endian_swap_u32s(&record->name_length, &record->name_length, 1);
+	endian_swap_u32s(&record->type, &record->type, 1);
+}
+
+static str pack_strdup(cstr source)
+{
+	u64 length = strlen(source) + 1;
+
+	str copy = (str)malloc(length);
+
+	if (copy != NULL) memcpy(copy, source, length);
+
+	return copy;
+}
+
+/// <summary>
+/// writes bytes to a pack file followed by zeros up to the next aligned offset
+/// </summary>
+/// <param name="file">- pack file</param>
+/// <param name="bytes">- bytes to write, which may be null when size is 0</param>
+/// <param name="size">- number of bytes</param>
+/// <param name="offset">- offset of the file, advanced past the bytes and padding</param>
+/// <returns>ERROR_NONE on success, ERROR_SIZE_MISMATCH on failure</returns>
+static err_t pack_emit(FILE* file, cmem bytes, u64 size, u64* offset)
+{
+	static const byte zeros[PACK_ALIGNMENT] = { 0 };
+
+	if (size > 0)
+	{
+		u64 written = fwrite(bytes, sizeof(byte), size, file);
+
+		if (written != size) return error_size_mismatch(size, written, __FILE__, __LINE__);
+	}
+
+	u64 padding = (PACK_ALIGNMENT - (*offset + size) % PACK_ALIGNMENT) % PACK_ALIGNMENT;
+
+	if (padding > 0 && fwrite(zeros, sizeof(byte), padding, file) != padding) return error_size_mismatch(padding, 0, __FILE__, __LINE__);
+
+	*offset += size + padding;
+
+	return ERROR_NONE;
+}
+
+err_t pack_builder_create(pack_builder_t** builder)
+{
+	if (builder == NULL) return error_param_null("builder", __FILE__, __LINE__);
+	if (*builder != NULL) return error_param_notnull("*builder", __FILE__, __LINE__);
+
+	*builder = (pack_builder_t*)malloc(sizeof(pack_builder_t));
+
+	if (*builder == NULL) return error_alloc_fail("pack_builder_t", sizeof(pack_builder_t), __FILE__, __LINE__);
+
+	(*builder)->items = NULL;
+	(*builder)->count = 0;
+	(*builder)->capacity = 0;
+
+	return ERROR_NONE;
+}
+
+err_t pack_builder_add(pack_builder_t* builder, cstr name, cstr path, pack_type_t type)
+{
+	if (builder == NULL) return error_param_null("builder", __FILE__, __LINE__);
+	if (name == NULL) return error_param_null("name", __FILE__, __LINE__);
+	if (path == NULL) return error_param_null("path", __FILE__, __LINE__);
+
+	if (type < PACK_TYPE_BINARY || type > PACK_TYPE_SHADER) return error_unknown_enum("pack_type_t", (i32)type, __FILE__, __LINE__);
+
+	for (u32 i = 0; i < builder->count; ++i)
+		if (strcmp(builder->items[i].name, name) == 0) return error_invalid_container("duplicate pack entry", __FILE__, __LINE__);
+
+	if (builder->count == builder->capacity)
+	{
+		u32 capacity = builder->capacity > 0 ? builder->capacity * 2 : 16;
+
+		pack_item_t* items = (pack_item_t*)realloc(builder->items, capacity * sizeof(pack_item_t));
+
+		if (items == NULL) return error_alloc_fail("pack_item_t", capacity * sizeof(pack_item_t), __FILE__, __LINE__);
+
+		builder->items = items;
+		builder->capacity = capacity;
+	}
+
+	pack_item_t* item = &builder->items[builder->count];
+
+	item->name = pack_strdup(name);
+	item->path = pack_strdup(path);
+	item->type = type;
+
+	if (item->name == NULL || item->path == NULL)
+	{
+		free(item->name);
+		free(item->path);
+
+		return error_alloc_fail("str", strlen(name) + strlen(path) + 2, __FILE__, __LINE__);
+	}
+
+	++builder->count;
+
+	return ERROR_NONE;
+}
+
+err_t pack_builder_write(const pack_builder_t* builder, cstr path)
+{
+	if (builder == NULL) return error_param_null("builder", __FILE__, __LINE__);
+	if (path == NULL) return error_param_null("path", __FILE__, __LINE__);
+
+	u32 bucket_count = 1;
+
+	while (bucket_count < builder->count * 2) bucket_count <<= 1;
+
+	u64 names_length = 0;
+
+	for (u32 i = 0; i < builder->count; ++i) names_length += strlen(builder->items[i].name);
+
+	pack_record_t* records = (pack_record_t*)calloc(builder->count > 0 ? builder->count : 1, sizeof(pack_record_t));
+	u32* buckets = (u32*)calloc(bucket_count, sizeof(u32));
+	byte* names = (byte*)malloc(names_length > 0 ? names_length : 1);
+
+	FILE* file = NULL;
+	err_t err = ERROR_NONE;
+
+	if (records == NULL || buckets == NULL || names == NULL) err = error_alloc_fail("pack_record_t", builder->count * sizeof(pack_record_t) + bucket_count * sizeof(u32) + names_length, __FILE__, __LINE__);
+	else if (fopen_s(&file, path, "wb") != 0) err = error_unopenable_file(path, __FILE__, __LINE__);
+
+	pack_header_t header;
+
+	memset(&header, 0, sizeof(pack_header_t));
+
+	u64 offset = 0;
+
+	// reserve the header; it is rewritten once every offset is known
+	if (err == ERROR_NONE) err = pack_emit(file, &header, sizeof(pack_header_t), &offset);
+
+	u64 name_offset = 0;
+
+	for (u32 i = 0; i < builder->count && err == ERROR_NONE; ++i)
+	{
+		const pack_item_t* item = &builder->items[i];
+
+		reader_map_t map = { NULL, 0 };
+
+		err = reader_map(item->path, &map);
+
+		if (err != ERROR_NONE) break;
+
+		u64 name_length = strlen(item->name);
+
+		records[i].hash = pack_hash(item->name, name_length);
+		records[i].offset = offset;
+		records[i].size = map.size;
+		records[i].name_offset = (u32)name_offset;
+		records[i].name_length = (u32)name_length;
+		records[i].type = (u32)item->type;
+
+		memcpy(names + name_offset, item->name, name_length);
+		name_offset += name_length;
+
+		reader_map_advise(&map, READER_ADVICE_SEQUENTIAL);
+
+		err = pack_emit(file, map.data, map.size, &offset);
+
+		reader_unmap(&map);
+
+		// open addressing with linear probing; the load factor is at most one half
+		u32 bucket = (u32)(records[i].hash & (bucket_count - 1));
+
+		while (buckets[bucket] != 0) bucket = (bucket + 1) & (bucket_count - 1);
+
+		buckets[bucket] = i + 1;
+	}
+
+	if (err == ERROR_NONE)
+	{
+		header.toc_offset = offset;
+
+		if (endianness_detect() != ENDIAN_LITTLE)
+			for (u32 i = 0; i < builder->count; ++i) pack_record_swap(&records[i]);
+
+		err = pack_emit(file, records, builder->count * sizeof(pack_record_t), &offset);
+	}
+
+	if (err == ERROR_NONE)
+	{
+		header.bucket_offset = offset;
+
+		if (endianness_detect() != ENDIAN_LITTLE) endian_swap_u32s(buckets, buckets, bucket_count);
+
+		err = pack_emit(file, buckets, bucket_count * sizeof(u32), &offset);
+	}
+
+	if (err == ERROR_NONE)
+	{
+		header.names_offset = offset;
+		header.names_length = names_length;
+
+		err = pack_emit(file, names, names_length, &offset);
+	}
+
+	if (err == ERROR_NONE)
+	{
+		memcpy(header.magic, PACK_MAGIC, sizeof(header.magic));
+
+		header.version = PACK_VERSION;
+		header.endianness = ENDIAN_LITTLE;
+		header.entry_count = builder->count;
+		header.bucket_count = bucket_count;
+		header.size = offset;
+
+		if (endianness_detect() != ENDIAN_LITTLE) pack_header_swap(&header);
+
+		rewind(file);
+
+		u64 header_offset = 0;
+
+		err = pack_emit(file, &header, sizeof(pack_header_t), &header_offset);
+	}
+
+	if (file != NULL && fclose(file) != 0 && err == ERROR_NONE) err = error_uncloseable_file(path, __FILE__, __LINE__);
+
+	free(records);
+	free(buckets);
+	free(names);
+
+	return err;
+}
+
+err_t pack_builder_destroy(pack_builder_t** builder)
+{
+	if (builder == NULL) return error_param_null("builder", __FILE__, __LINE__);
+	if (*builder == NULL) return error_param_null("*builder", __FILE__, __LINE__);
+
+	for (u32 i = 0; i < (*builder)->count; ++i)
+	{
+		free((*builder)->items[i].name);
+		free((*builder)->items[i].path);
+	}
+
+	free((*builder)->items);
+	free(*builder);
+	*builder = NULL;
+
+	return ERROR_NONE;
+}
+
+/// <summary>
+/// checks that a range lies within a pack, phrased so that forged offsets cannot overflow
+/// </summary>
+static i32 pack_range_valid(u64 offset, u64 size, u64 pack_size)
+{
+	return offset <= pack_size && size <= pack_size - offset;
+}
+
+err_t pack_open(pack_t** pack, cstr path)
+{
+	if (pack == NULL) return error_param_null("pack", __FILE__, __LINE__);
+	if (*pack != NULL) return error_param_notnull("*pack", __FILE__, __LINE__);
+
+	if (path == NULL) return error_param_null("path", __FILE__, __LINE__);
+
+	pack_t* opening = (pack_t*)malloc(sizeof(pack_t));
+
+	if (opening == NULL) return error_alloc_fail("pack_t", sizeof(pack_t), __FILE__, __LINE__);
+
+	opening->map.data = NULL;
+	opening->map.size = 0;
+
+	err_t err = reader_map(path, &opening->map);
+
+	if (err == ERROR_NONE && opening->map.size < sizeof(pack_header_t)) err = error_invalid_container("pack size", __FILE__, __LINE__);
+
+	pack_header_t* header = &opening->header;
+
+	if (err == ERROR_NONE)
+	{
+		memcpy(header, opening->map.data, sizeof(pack_header_t));
+
+		if (memcmp(header->magic, PACK_MAGIC, sizeof(header->magic)) != 0) err = error_invalid_container("pack magic", __FILE__, __LINE__);
+		else if (header->endianness != ENDIAN_LITTLE && header->endianness != ENDIAN_BIGLY) err = error_invalid_container("pack endianness", __FILE__, __LINE__);
+	}
+
+	if (err == ERROR_NONE)
+	{
+		opening->swap = header->endianness != endianness_detect();
+
+		if (opening->swap) pack_header_swap(header);
+
+		u64 size = opening->map.size;
+
+		if (header->version == 0 || header->version > PACK_VERSION) err = error_invalid_container("pack version", __FILE__, __LINE__);
+		else if (header->bucket_count == 0 || (header->bucket_count & (header->bucket_count - 1)) != 0 || header->bucket_count < header->entry_count) err = error_invalid_container("pack buckets", __FILE__, __LINE__);
+		else if (header->size != size) err = error_invalid_container("pack size", __FILE__, __LINE__);
+		else if (!pack_range_valid(header->toc_offset, (u64)header->entry_count * sizeof(pack_record_t), size)) err = error_invalid_container("pack toc", __FILE__, __LINE__);
+		else if (!pack_range_valid(header->bucket_offset, (u64)header->bucket_count * sizeof(u32), size)) err = error_invalid_container("pack buckets", __FILE__, __LINE__);
+		else if (!pack_range_valid(header->names_offset, header->names_length, size)) err = error_invalid_container("pack names", __FILE__, __LINE__);
+	}
+
+	if (err != ERROR_NONE)
+	{
+		reader_unmap(&opening->map);
+		free(opening);
+
+		return err;
+	}
+
+	// lookups touch the table at random
+	reader_map_advise(&opening->map, READER_ADVICE_RANDOM);
+
+	*pack = opening;
+
+	return ERROR_NONE;
+}
+
+err_t pack_find(const pack_t* pack, cstr name, pack_entry_t* entry)
+{
+	if (pack == NULL) return error_param_null("pack", __FILE__, __LINE__);
+	if (name == NULL) return error_param_null("name", __FILE__, __LINE__);
+	if (entry == NULL) return error_param_null("entry", __FILE__, __LINE__);
+
+	const pack_header_t* header = &pack->header;
+	const byte* data = pack->map.data;
+
+	u64 name_length = strlen(name);
+	u64 hash = pack_hash(name, name_length);
+	u32 mask = header->bucket_count - 1;
+
+	for (u32 probe = 0, bucket = (u32)(hash & mask); probe < header->bucket_count; ++probe, bucket = (bucket + 1) & mask)
+	{
+		u32 slot;
+
+		memcpy(&slot, data + header->bucket_offset + bucket * sizeof(u32), sizeof(u32));
+
+		if (pack->swap) endian_swap_u32s(&slot, &slot, 1);
+
+		if (slot == 0) break;
+
+		if (slot > header->entry_count) return error_invalid_container("pack bucket", __FILE__, __LINE__);
+
+		pack_record_t record;
+
+		memcpy(&record, data + header->toc_offset + (slot - 1) * sizeof(pack_record_t), sizeof(pack_record_t));
+
+		if (pack->swap) pack_record_swap(&record);
+
+		if (record.hash != hash || record.name_length != name_length) continue;
+
+		if (!pack_range_valid(record.name_offset, record.name_length, header->names_length)) return error_invalid_container("pack name", __FILE__, __LINE__);
+
+		if (memcmp(data + header->names_offset + record.name_offset, name, name_length) != 0) continue;
+
+		if (!pack_range_valid(record.offset, record.size, header->size)) return error_invalid_container("pack entry", __FILE__, __LINE__);
+
+		entry->data = data + record.offset;
+		entry->size = record.size;
+		entry->type = (pack_type_t)record.type;
+
+		return ERROR_NONE;
+	}
+
+	return error_missing_entry(name, __FILE__, __LINE__);
+}
+
+err_t pack_close(pack_t** pack)
+{
+	if (pack == NULL) return error_param_null("pack", __FILE__, __LINE__);
+	if (*pack == NULL) return error_param_null("*pack", __FILE__, __LINE__);
+
+	err_t err = reader_unmap(&(*pack)->map);
+
+	free(*pack);
+	*pack = NULL;
+
+	return err;
+}
@@ -0,0 +1,528 @@
+#include "preload.h"
+
+#include <GL/glew.h>
+
+#include "allocator.h"
+#include "buffer.h"
+#include "deserializer.h"
+#include "image.h"
+#include "loader.h"
+#include "reader.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/// <summary>an asset along with what its loader thread hands to the main thread</summary>
+typedef struct preload_entry_t
+{
+	preload_asset_t asset;
+	struct preload_t* preload;
+	// handle of the read, to withdraw it if the preload is destroyed first
+	u64 request;
+	// decoded array inside the contents of the read, set by the loader thread
+	cmem array;
+	// reload in flight for a listed asset, or for a reload the asset it replaces
+	struct preload_entry_t* staging;
+	struct preload_entry_t* target;
+	// true when the file changed again while it was being read, so it is read once more
+	i32 stale;
+} preload_entry_t;
+
+typedef struct preload_t
+{
+	struct loader_t* loader;
+	preload_entry_t* entries;
+	u32 count;
+	// assets not yet ready and reloads in flight, only touched on the thread draining the loader
+	u32 remaining;
+	u32 reloading;
+	// the manifest, split in place, which the paths of the assets point into
+	str manifest;
+} preload_t;
+
+/// <summary>
+/// fetches the kind named by the first word of a manifest line
+/// </summary>
+/// <param name="name">- name of the kind</param>
+/// <param name="kind">- address of the kind</param>
+/// <returns>true if the name is known</returns>
+static i32 preload_kind_parse(cstr name, preload_kind_t* kind)
+{
+	if (strcmp(name, "texture") == 0) *kind = PRELOAD_KIND_TEXTURE;
+	else if (strcmp(name, "vertices") == 0) *kind = PRELOAD_KIND_VERTICES;
+	else if (strcmp(name, "indices") == 0) *kind = PRELOAD_KIND_INDICES;
+	else if (strcmp(name, "text") == 0) *kind = PRELOAD_KIND_TEXT;
+	else return false;
+
+	return true;
+}
+
+/// <summary>
+/// splits a manifest in place into its assets, skipping blank lines and lines starting with #
+/// </summary>
+/// <param name="preload">- address of the preload, whose manifest is split and whose entries are filled in</param>
+/// <param name="path">- path of the manifest, for errors</param>
+/// <returns>ERROR_NONE on success, ERROR_INVALID_MANIFEST or ERROR_ALLOC_FAIL on failure</returns>
+static err_t preload_manifest_parse(preload_t* preload, cstr path)
+{
+	u32 lines = 1;
+
+	for (cstr it = preload->manifest; *it != '\0'; ++it)
+	{
+		if (*it == '\n') ++lines;
+	}
+
+	preload->entries = (preload_entry_t*)calloc(lines, sizeof(preload_entry_t));
+
+	if (preload->entries == NULL) return error_alloc_fail("preload_entry_t", lines * sizeof(preload_entry_t), __FILE__, __LINE__);
+
+	str line = preload->manifest;
+
+	for (u32 number = 1; line != NULL; ++number)
+	{
+		str end = strchr(line, '\n');
+
+		if (end != NULL) *end = '\0';
+
+		str next = end != NULL ? end + 1 : NULL;
+
+		// words are cut out of the line in place, so each ends up null-terminated
+		str words[3] = { NULL, NULL, NULL };
+		u32 count = 0;
+
+		for (str it = line; *it != '\0' && count < 3;)
+		{
+			while (*it == ' ' || *it == '\t' || *it == '\r') *it++ = '\0';
+
+			if (*it == '\0') break;
+
+			words[count++] = it;
+
+			while (*it != '\0' && *it != ' ' && *it != '\t' && *it != '\r') ++it;
+		}
+
+		line = next;
+
+		if (count == 0 || words[0][0] == '#') continue;
+
+		preload_entry_t* entry = &preload->entries[preload->count];
+
+		if (count != 2 || !preload_kind_parse(words[0], &entry->asset.kind)) return error_invalid_manifest(path, number, __FILE__, __LINE__);
+
+		entry->asset.path = words[1];
+		entry->preload = preload;
+
+		++preload->count;
+	}
+
+	return ERROR_NONE;
+}
+
+/// <summary>
+/// decodes the contents of a texture on a loader thread, replacing them with its pixels
+/// </summary>
+/// <param name="result">- address of the result</param>
+/// <param name="allocator">- allocator of the read</param>
+/// <param name="entry">- address of the entry</param>
+/// <returns>ERROR_NONE on success, or the error decoding failed with on failure</returns>
+static err_t preload_decode_texture(loader_result_t* result, const struct allocator_t* allocator, preload_entry_t* entry)
+{
+	byte* pixels = NULL;
+
+	err_t err = image_decode(&pixels, &entry->asset.width, &entry->asset.height, (const byte*)result->data, result->size, allocator);
+
+	if (err != ERROR_NONE) return err;
+
+	allocator_free(allocator, &result->data);
+
+	result->data = pixels;
+	result->size = (u64)entry->asset.width * (u64)entry->asset.height * 4;
+
+	entry->array = pixels;
+
+	return ERROR_NONE;
+}
+
+/// <summary>
+/// deserializes the contents of an array on a loader thread, in place unless it must be decompressed or decoded
+/// </summary>
+/// <param name="result">- address of the result</param>
+/// <param name="allocator">- allocator of the read</param>
+/// <param name="entry">- address of the entry</param>
+/// <returns>ERROR_NONE on success, or the error decoding failed with on failure</returns>
+static err_t preload_decode_array(loader_result_t* result, const struct allocator_t* allocator, preload_entry_t* entry)
+{
+	container_t header;
+
+	// a file still being written, as hot reload may read it, holds only part of its payload and is rejected here
+	err_t err = deserialize_header(&header, (const byte*)result->data, result->size);
+
+	if (err != ERROR_NONE) return err;
+
+	preload_asset_t* asset = &entry->asset;
+
+	asset->type = (container_type_t)header.type;
+	asset->components = header.components;
+
+	mem array = NULL;
+
+	if (header.flags & (CONTAINER_FLAG_COMPRESSED | CONTAINER_FLAG_DELTA))
+	{
+		if (header.flags & CONTAINER_FLAG_INTERLEAVED) err = deserialize_interleaved_ex(&array, &asset->count, &asset->layout, (const byte*)result->data, result->size, allocator);
+		else err = deserialize_array_ex(&array, &asset->count, (const byte*)result->data, result->size, asset->type, asset->components, allocator);
+
+		if (err != ERROR_NONE) return err;
+
+		// the decoded array replaces the file, which is no longer needed
+		allocator_free(allocator, &result->data);
+
+		result->data = array;
+		result->size = asset->count * header.stride;
+	}
+	else if (header.flags & CONTAINER_FLAG_INTERLEAVED) err = deserialize_interleaved_inplace(&array, &asset->count, &asset->layout, (byte*)result->data, result->size);
+	else err = deserialize_array_inplace(&array, &asset->count, (byte*)result->data, result->size, asset->type, asset->components);
+
+	entry->array = array;
+
+	return err;
+}
+
+static err_t preload_decode(loader_result_t* result, const struct allocator_t* allocator, ptr user)
+{
+	preload_entry_t* entry = (preload_entry_t*)user;
+
+	switch (entry->asset.kind)
+	{
+		case PRELOAD_KIND_TEXTURE: return preload_decode_texture(result, allocator, entry);
+		case PRELOAD_KIND_VERTICES:
+		case PRELOAD_KIND_INDICES: return preload_decode_array(result, allocator, entry);
+
+		default: return ERROR_NONE;
+	}
+}
+
+/// <summary>
+/// uploads a decoded asset on the thread draining the loader, which holds the opengl context
+/// </summary>
+/// <param name="entry">- address of the entry</param>
+/// <param name="result">- address of the decoded result</param>
+/// <returns>ERROR_NONE on success, or the error the upload failed with on failure</returns>
+static err_t preload_upload(preload_entry_t* entry, const loader_result_t* result)
+{
+	preload_asset_t* asset = &entry->asset;
+
+	switch (asset->kind)
+	{
+		case PRELOAD_KIND_TEXTURE: return image_create(&asset->handle, (const byte*)entry->array, asset->width, asset->height);
+		case PRELOAD_KIND_VERTICES:
+			if (asset->layout.count > 0) return interleaved_buffer_create(&asset->handle, entry->array, asset->count, &asset->layout);
+
+			return array_buffer_create(&asset->handle, entry->array, asset->count, asset->type, asset->components);
+		case PRELOAD_KIND_INDICES:
+			if (asset->components != 1 || asset->layout.count > 0) return error_invalid_container("index components", __FILE__, __LINE__);
+
+			return element_buffer_create_typed(&asset->handle, &asset->index_type, entry->array, asset->count, asset->type);
+		case PRELOAD_KIND_TEXT:
+			// text stays in memory for its users, and is freed with the preload
+			asset->text = (cstr)result->data;
+			asset->size = result->size;
+
+			return ERROR_NONE;
+
+		default: return error_unknown_enum("preload_kind_t", (i32)asset->kind, __FILE__, __LINE__);
+	}
+}
+
+static err_t preload_deliver(const loader_result_t* result, ptr user)
+{
+	preload_entry_t* entry = (preload_entry_t*)user;
+
+	entry->asset.err = result->err;
+
+	if (entry->asset.err == ERROR_NONE) entry->asset.err = preload_upload(entry, result);
+
+	// only text is kept once uploaded, and nothing is kept of a failed asset
+	if (entry->asset.kind != PRELOAD_KIND_TEXT || entry->asset.err != ERROR_NONE)
+	{
+		mem data = result->data;
+
+		allocator_free(NULL, &data);
+
+		entry->asset.text = NULL;
+		entry->asset.size = 0;
+	}
+
+	entry->array = NULL;
+	entry->request = 0;
+	entry->asset.ready = true;
+
+	--entry->preload->remaining;
+
+	if (entry->stale) preload_reload(entry->preload, entry->asset.path);
+
+	return entry->asset.err;
+}
+
+/// <summary>
+/// deletes the texture or buffer of an asset and frees its text
+/// </summary>
+/// <param name="asset">- address of the asset</param>
+static void preload_release(preload_asset_t* asset)
+{
+	if (asset->handle != 0)
+	{
+		if (asset->kind == PRELOAD_KIND_TEXTURE) glDeleteTextures(1, &asset->handle);
+		else glDeleteBuffers(1, &asset->handle);
+
+		asset->handle = 0;
+	}
+
+	mem text = (mem)asset->text;
+
+	allocator_free(NULL, &text);
+
+	asset->text = NULL;
+	asset->size = 0;
+}
+
+static err_t preload_redeliver(const loader_result_t* result, ptr user)
+{
+	preload_entry_t* staging = (preload_entry_t*)user;
+	preload_entry_t* entry = staging->target;
+
+	err_t err = result->err;
+
+	if (err == ERROR_NONE) err = preload_upload(staging, result);
+
+	if (staging->asset.kind != PRELOAD_KIND_TEXT || err != ERROR_NONE)
+	{
+		mem data = result->data;
+
+		allocator_free(NULL, &data);
+	}
+
+	// a failed reload was logged where it failed, and the asset keeps the objects it had so rendering carries on
+	if (err == ERROR_NONE)
+	{
+		preload_release(&entry->asset);
+
+		staging->asset.ready = true;
+
+		entry->asset = staging->asset;
+	}
+	else if (staging->asset.handle != 0) preload_release(&staging->asset);
+
+	entry->staging = NULL;
+
+	--entry->preload->reloading;
+
+	free(staging);
+
+	if (entry->stale) return preload_reload(entry->preload, entry->asset.path);
+
+	return ERROR_NONE;
+}
+
+err_t preload_create(preload_t** preload, struct loader_t* loader, cstr manifest)
+{
+	if (preload == NULL) return error_param_null("preload", __FILE__, __LINE__);
+	if (*preload != NULL) return error_param_notnull("*preload", __FILE__, __LINE__);
+
+	if (loader == NULL) return error_param_null("loader", __FILE__, __LINE__);
+	if (manifest == NULL) return error_param_null("manifest", __FILE__, __LINE__);
+
+	reader_view_t view;
+
+	err_t err = reader_text_scratch(manifest, &view);
+
+	if (err != ERROR_NONE) return err;
+
+	preload_t* creating = (preload_t*)calloc(1, sizeof(preload_t));
+
+	if (creating == NULL) return error_alloc_fail("preload_t", sizeof(preload_t), __FILE__, __LINE__);
+
+	creating->loader = loader;
+
+	// the scratch buffer is reused by the next read, so the manifest is copied out to keep its paths
+	creating->manifest = (str)malloc(view.size + 1);
+
+	err = creating->manifest != NULL ? ERROR_NONE : error_alloc_fail("str", view.size + 1, __FILE__, __LINE__);
+
+	if (err == ERROR_NONE)
+	{
+		memcpy(creating->manifest, view.data, view.size + 1);
+
+		err = preload_manifest_parse(creating, manifest);
+	}
+
+	for (u32 i = 0; i < creating->count && err == ERROR_NONE; ++i)
+	{
+		preload_entry_t* entry = &creating->entries[i];
+
+		loader_kind_t kind = entry->asset.kind == PRELOAD_KIND_TEXT ? LOADER_KIND_STRING : LOADER_KIND_BINARY;
+
+		err = loader_read_ex(loader, entry->asset.path, kind, NULL, preload_decode, preload_deliver, entry, &entry->request);
+
+		if (err == ERROR_NONE) ++creating->remaining;
+	}
+
+	if (err != ERROR_NONE)
+	{
+		preload_destroy(&creating);
+
+		return err;
+	}
+
+	*preload = creating;
+
+	return ERROR_NONE;
+}
+
+u32 preload_pending(preload_t* preload)
+{
+	if (preload == NULL) return 0;
+
+	return preload->remaining;
+}
+
+err_t preload_finish(preload_t* preload)
+{
+	if (preload == NULL) return error_param_null("preload", __FILE__, __LINE__);
+
+	err_t err = loader_finish(preload->loader);
+
+	if (err != ERROR_NONE) return err;
+
+	// every asset is decoded by now, so draining uploads them all; other reads on the loader are delivered too
+	loader_drain(preload->loader, 0);
+
+	for (u32 i = 0; i < preload->count; ++i)
+	{
+		if (preload->entries[i].asset.err != ERROR_NONE) return preload->entries[i].asset.err;
+	}
+
+	return ERROR_NONE;
+}
+
+err_t preload_find(preload_t* preload, cstr path, const preload_asset_t** asset)
+{
+	if (preload == NULL) return error_param_null("preload", __FILE__, __LINE__);
+	if (path == NULL) return error_param_null("path", __FILE__, __LINE__);
+	if (asset == NULL) return error_param_null("asset", __FILE__, __LINE__);
+
+	for (u32 i = 0; i < preload->count; ++i)
+	{
+		if (strcmp(preload->entries[i].asset.path, path) != 0) continue;
+
+		*asset = &preload->entries[i].asset;
+
+		return ERROR_NONE;
+	}
+
+	return error_missing_entry(path, __FILE__, __LINE__);
+}
+
+u32 preload_count(preload_t* preload)
+{
+	if (preload == NULL) return 0;
+
+	return preload->count;
+}
+
+err_t preload_at(preload_t* preload, u32 index, const preload_asset_t** asset)
+{
+	if (preload == NULL) return error_param_null("preload", __FILE__, __LINE__);
+	if (asset == NULL) return error_param_null("asset", __FILE__, __LINE__);
+
+	if (index >= preload->count) return error_missing_entry("index", __FILE__, __LINE__);
+
+	*asset = &preload->entries[index].asset;
+
+	return ERROR_NONE;
+}
+
+err_t preload_reload(preload_t* preload, cstr path)
+{
+	if (preload == NULL) return error_param_null("preload", __FILE__, __LINE__);
+	if (path == NULL) return error_param_null("path", __FILE__, __LINE__);
+
+	preload_entry_t* entry = NULL;
+
+	for (u32 i = 0; i < preload->count && entry == NULL; ++i)
+	{
+		if (strcmp(preload->entries[i].asset.path, path) == 0) entry = &preload->entries[i];
+	}
+
+	if (entry == NULL) return error_missing_entry(path, __FILE__, __LINE__);
+
+	// the read in flight may have seen the file before this change, so another follows once it is delivered
+	if (!entry->asset.ready || entry->staging != NULL)
+	{
+		entry->stale = true;
+
+		return ERROR_NONE;
+	}
+
+	entry->stale = false;
+
+	preload_entry_t* staging = (preload_entry_t*)calloc(1, sizeof(preload_entry_t));
+
+	if (staging == NULL) return error_alloc_fail("preload_entry_t", sizeof(preload_entry_t), __FILE__, __LINE__);
+
+	staging->asset.kind = entry->asset.kind;
+	staging->asset.path = entry->asset.path;
+	staging->preload = preload;
+	staging->target = entry;
+
+	loader_kind_t kind = entry->asset.kind == PRELOAD_KIND_TEXT ? LOADER_KIND_STRING : LOADER_KIND_BINARY;
+
+	err_t err = loader_read_ex(preload->loader, entry->asset.path, kind, NULL, preload_decode, preload_redeliver, staging, &staging->request);
+
+	if (err != ERROR_NONE)
+	{
+		free(staging);
+
+		return err;
+	}
+
+	entry->staging = staging;
+
+	++preload->reloading;
+
+	return ERROR_NONE;
+}
+
+err_t preload_destroy(preload_t** preload)
+{
+	if (preload == NULL) return error_param_null("preload", __FILE__, __LINE__);
+	if (*preload == NULL) return error_param_null("*preload", __FILE__, __LINE__);
+
+	preload_t* destroying = *preload;
+
+	// a read being decoded still points at its entry, so every running read must return before any is withdrawn
+	if (destroying->remaining > 0 || destroying->reloading > 0) loader_finish(destroying->loader);
+
+	for (u32 i = 0; i < destroying->count; ++i)
+	{
+		preload_entry_t* entry = &destroying->entries[i];
+
+		if (entry->request != 0) loader_cancel(destroying->loader, entry->request);
+
+		if (entry->staging != NULL)
+		{
+			loader_cancel(destroying->loader, entry->staging->request);
+
+			free(entry->staging);
+		}
+
+		preload_release(&entry->asset);
+	}
+
+	free(destroying->entries);
+	free(destroying->manifest);
+	free(destroying);
+
+	*preload = NULL;
+
+	return ERROR_NONE;
+}
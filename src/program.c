@@ -9,9 +9,15 @@
 
 #include "writer.h"
 #include "reader.h"
+#include "loader.h"
+#include "preload.h"
 
 #include "serializer.h"
 #include "deserializer.h"
+#include "workers.h"
+#include "writeback.h"
+#include "watch.h"
+#include "stream.h"
 
 #include "shader.h"
 
@@ -33,6 +39,20 @@ const int WINDOW_HEIGHT_HALF = 480 / 2;
 
 static GLFWwindow* window;
 
+static struct workers_t* workers;
+
+static struct writeback_t* writeback;
+
+static struct loader_t* loader;
+
+static struct preload_t* preload;
+
+static struct watch_t* watch;
+
+static u32 program;
+
+static struct stream_t* stream;
+
 void framebufferReizeCallback(GLFWwindow* window, int width, int height);
 
 int glfwSetWindowCenter(GLFWwindow* window);
@@ -60,16 +80,24 @@ err_t reserialize_test()
     err |= serialize_vec3s(&vertex_byte_buffer, vertices, sizeof(vertices) / sizeof(vec3_t));
     if (err != ERROR_NONE) return err;
 
-    err |= writer_binary("data/arrays/cube.vertices", vertex_byte_buffer);
+    u64 vertex_byte_size = 0;
+
+    err |= container_size(&vertex_byte_size, vertex_byte_buffer);
+    if (err != ERROR_NONE) return err;
+
+    err |= writer_binary("data/arrays/cube.vertices", vertex_byte_buffer, vertex_byte_size);
     if (err != ERROR_NONE) return err;
 
-    err |= reader_binary("data/arrays/cube.vertices", &vertex_byte_buffer);
+    err |= buffer_destroy(&vertex_byte_buffer);
+    if (err != ERROR_NONE) return err;
+
+    err |= reader_binary_sized_ex("data/arrays/cube.vertices", &vertex_byte_buffer, &vertex_byte_size, NULL);
     if (err != ERROR_NONE) return err;
 
     vec3_t* vertex_buffer = NULL;
     u64 vertex_buffer_size;
 
-    err |= deserialize_vec3s(&vertex_buffer, &vertex_buffer_size, vertex_byte_buffer);
+    err |= deserialize_vec3s(&vertex_buffer, &vertex_buffer_size, vertex_byte_buffer, vertex_byte_size);
     if (err != ERROR_NONE) return err;
 
     err |= buffer_destroy(&vertex_byte_buffer);
@@ -83,16 +111,24 @@ err_t reserialize_test()
     err |= serialize_u32s(&index_byte_buffer, indices, sizeof(indices) / sizeof(u32));
     if (err != ERROR_NONE) return err;
 
-    err |= writer_binary("data/arrays/cube.indices", index_byte_buffer);
+    u64 index_byte_size = 0;
+
+    err |= container_size(&index_byte_size, index_byte_buffer);
+    if (err != ERROR_NONE) return err;
+
+    err |= writer_binary("data/arrays/cube.indices", index_byte_buffer, index_byte_size);
+    if (err != ERROR_NONE) return err;
+
+    err |= buffer_destroy(&index_byte_buffer);
     if (err != ERROR_NONE) return err;
 
-    err |= reader_binary("data/arrays/cube.indices", &index_byte_buffer);
+    err |= reader_binary_sized_ex("data/arrays/cube.indices", &index_byte_buffer, &index_byte_size, NULL);
     if (err != ERROR_NONE) return err;
 
     u32* index_buffer = NULL;
     u64 index_buffer_size;
 
-    err |= deserialize_u32s(&index_buffer, &index_buffer_size, index_byte_buffer);
+    err |= deserialize_u32s(&index_buffer, &index_buffer_size, index_byte_buffer, index_byte_size);
     if (err != ERROR_NONE) return err;
 
     err |= buffer_destroy(&index_byte_buffer);
@@ -139,27 +175,95 @@ err_t load_window()
     return ERROR_NONE;
 }
 
+err_t load_workers()
+{
+    err_t err = workers_create(&workers, 0);
+
+    if (err != ERROR_NONE) return err;
+
+    serializer_workers_set(workers);
+    deserializer_workers_set(workers);
+
+    return ERROR_NONE;
+}
+
+err_t load_writeback()
+{
+    return writeback_create(&writeback, 0);
+}
+
+err_t load_loader()
+{
+    return loader_create(&loader, 0);
+}
+
+err_t load_preload()
+{
+    return preload_create(&preload, loader, PRELOAD_MANIFEST);
+}
+
 err_t load_shaders()
 {
-    err_t err = ERROR_NONE;
+    return program_load("data/shaders", "basic_shader", &program, SHADER_VERTEX | SHADER_FRAGMENT);
+}
+
+err_t reload_asset(cstr path, ptr user)
+{
+    return preload_reload(preload, path);
+}
+
+err_t reload_shaders(cstr path, ptr user)
+{
+    // a shader that fails to build is logged and the running program is kept, so a typo never stops the loop
+    program_reload("data/shaders", "basic_shader", &program, SHADER_VERTEX | SHADER_FRAGMENT);
 
     return ERROR_NONE;
 }
 
-err_t load_arrays()
+err_t load_watch()
 {
-    err_t err = ERROR_NONE;
+    err_t err = watch_create(&watch, 0);
+
+    if (err != ERROR_NONE) return err;
+
+    for (u32 i = 0; i < preload_count(preload); ++i)
+    {
+        const preload_asset_t* asset = NULL;
+
+        if ((err = preload_at(preload, i, &asset)) != ERROR_NONE) return err;
+
+        // nothing rebuilds from reloaded text, and the shader files are watched below so a save triggers a single reload
+        if (asset->kind == PRELOAD_KIND_TEXT) continue;
+
+        if ((err = watch_add(watch, asset->path, reload_asset, NULL)) != ERROR_NONE) return err;
+    }
+
+    if ((err = watch_add(watch, "data/shaders/basic_shader.vert", reload_shaders, NULL)) != ERROR_NONE) return err;
+    if ((err = watch_add(watch, "data/shaders/basic_shader.frag", reload_shaders, NULL)) != ERROR_NONE) return err;
 
     return ERROR_NONE;
 }
 
+err_t load_arrays()
+{
+    // geometry rebuilt every frame is written here rather than into buffers created and dropped each frame; the frames that write it bracket their draws with stream_begin and stream_end
+    return stream_create(&stream, GL_ARRAY_BUFFER, STREAM_SIZE);
+}
+
 err_t initialize()
 {
     err_t err = ERROR_NONE;
 
+    // assets are read and decoded in the background from here on, while the window and context are created
+    if ((err = load_workers()) != ERROR_NONE) return err;
+    if ((err = load_writeback()) != ERROR_NONE) return err;
+    if ((err = load_loader()) != ERROR_NONE) return err;
+    if ((err = load_preload()) != ERROR_NONE) return err;
     if (err = load_window() != ERROR_NONE) return err;
-    if (err = load_shaders() != ERROR_NONE) return err;
-    if (err = load_arrays() != ERROR_NONE) return err;
+    if ((err = preload_finish(preload)) != ERROR_NONE) return err;
+    if ((err = load_shaders()) != ERROR_NONE) return err;
+    if ((err = load_arrays()) != ERROR_NONE) return err;
+    if ((err = load_watch()) != ERROR_NONE) return err;
 
     return ERROR_NONE;
 }
@@ -176,7 +280,13 @@ err_t input()
 
 err_t update()
 {
-    return ERROR_NONE;
+    err_t err = ERROR_NONE;
+
+    // changed files are queued for reading first, and whatever finished is swapped in below, between two frames
+    if ((err = watch_poll(watch)) != ERROR_NONE) return err;
+
+    // reads finished in the background are handed over here, so their callbacks run on the thread owning the context
+    return loader_drain(loader, 0);
 }
 
 err_t render()
@@ -191,6 +301,26 @@ err_t render()
 
 err_t terminate()
 {
+    serializer_workers_set(NULL);
+    deserializer_workers_set(NULL);
+
+    if (watch != NULL) watch_destroy(&watch);
+
+    if (program != 0) program_delete(program);
+
+    if (stream != NULL) stream_destroy(&stream);
+
+    if (preload != NULL) preload_destroy(&preload);
+
+    if (loader != NULL) loader_destroy(&loader);
+
+    workers_destroy(&workers);
+
+    // queued cache writes are finished before exit rather than lost
+    if (writeback != NULL) writeback_destroy(&writeback);
+
+    reader_scratch_release();
+
     glfwDestroyWindow(window);
 
     glfwTerminate();
@@ -0,0 +1,563 @@
+#include "quantize.h"
+
+#include "cpu.h"
+
+#include "vec2.h"
+#include "vec3.h"
+#include "vec4.h"
+
+#include <math.h>
+#include <string.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define QUANTIZE_X86
+#include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#define QUANTIZE_TARGET(isa)
+#else
+#define QUANTIZE_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+// largest finite half-precision value
+#define QUANTIZE_F16_MAX 65504.0f
+
+#define QUANTIZE_SNORM16_SCALE 32767.0f
+#define QUANTIZE_UNORM8_SCALE 255.0f
+
+// headroom for the float rounding of scaling into and out of the normalized formats, a few ulps of 1
+#define QUANTIZE_SCALE_ROUNDING 2.384185791015625e-07f
+
+// processes count components starting at an index, returning how many it handled so the scalar kernel can finish the tail
+typedef u64 (*quantize_kernel_t)(mem dest, const f32* src, u64 count);
+typedef u64 (*dequantize_kernel_t)(f32* dest, cmem src, u64 count);
+
+/// <summary>
+/// converts a float to half precision, rounding to nearest even exactly as f16c does
+/// </summary>
+static u16 quantize_f16(f32 value)
+{
+	u32 bits;
+
+	memcpy(&bits, &value, sizeof(u32));
+
+	u16 sign = (u16)((bits >> 16) & 0x8000);
+	u32 magnitude = bits & 0x7FFFFFFF;
+
+	// infinity stays infinite and nan stays a quiet nan with the top of its payload
+	if (magnitude >= 0x7F800000) return sign | 0x7C00 | (magnitude > 0x7F800000 ? 0x0200 | ((magnitude >> 13) & 0x03FF) : 0);
+
+	// 65520 and above round past the largest half
+	if (magnitude >= 0x477FF000) return sign | 0x7C00;
+
+	// below 2^-25 everything rounds to zero
+	if (magnitude < 0x33000000) return sign;
+
+	u32 half;
+	u32 remainder;
+	u32 midpoint;
+
+	if (magnitude < 0x38800000)
+	{
+		// subnormal half: the implicit bit is made explicit and the mantissa shifted down to units of 2^-24
+		u32 mantissa = (magnitude & 0x007FFFFF) | 0x00800000;
+		u32 shift = 126 - (magnitude >> 23);
+
+		half = mantissa >> shift;
+		remainder = mantissa & ((1u << shift) - 1);
+		midpoint = 1u << (shift - 1);
+	}
+	else
+	{
+		// rebias the exponent from 127 to 15 and drop 13 mantissa bits
+		half = (magnitude - 0x38000000) >> 13;
+		remainder = magnitude & 0x1FFF;
+		midpoint = 0x1000;
+	}
+
+	// a carry out of the mantissa correctly bumps the exponent
+	if (remainder > midpoint || (remainder == midpoint && (half & 1))) ++half;
+
+	return sign | (u16)half;
+}
+
+/// <summary>
+/// converts a half-precision value to a float, which is always exact
+/// </summary>
+static f32 dequantize_f16(u16 half)
+{
+	u32 sign = (u32)(half & 0x8000) << 16;
+	u32 exponent = (half >> 10) & 0x1F;
+	u32 mantissa = half & 0x03FF;
+	u32 bits;
+
+	if (exponent == 0x1F) bits = sign | 0x7F800000 | (mantissa << 13);
+	else if (exponent != 0) bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+	else if (mantissa == 0) bits = sign;
+	else
+	{
+		// subnormal half becomes a normal float once its leading bit is shifted into the implicit position
+		exponent = 113;
+
+		do
+		{
+			mantissa <<= 1;
+			--exponent;
+		} while ((mantissa & 0x0400) == 0);
+
+		bits = sign | (exponent << 23) | ((mantissa & 0x03FF) << 13);
+	}
+
+	f32 value;
+
+	memcpy(&value, &bits, sizeof(f32));
+
+	return value;
+}
+
+// the clamps are ordered so nan lands on the upper bound, matching minps/maxps in the simd kernels
+static i16 quantize_snorm16(f32 value)
+{
+	f32 clamped = value < 1.0f ? value : 1.0f;
+
+	clamped = clamped > -1.0f ? clamped : -1.0f;
+
+	return (i16)lrintf(clamped * QUANTIZE_SNORM16_SCALE);
+}
+
+static f32 dequantize_snorm16(i16 value)
+{
+	// -32768 is folded onto -1 so both ends of the range are exact
+	f32 expanded = (f32)value * (1.0f / QUANTIZE_SNORM16_SCALE);
+
+	return expanded > -1.0f ? expanded : -1.0f;
+}
+
+static u8 quantize_unorm8(f32 value)
+{
+	f32 clamped = value < 1.0f ? value : 1.0f;
+
+	clamped = clamped > 0.0f ? clamped : 0.0f;
+
+	return (u8)lrintf(clamped * QUANTIZE_UNORM8_SCALE);
+}
+
+static f32 dequantize_unorm8(u8 value)
+{
+	return (f32)value * (1.0f / QUANTIZE_UNORM8_SCALE);
+}
+
+static u64 quantize_f16_scalar(mem dest, const f32* src, u64 count)
+{
+	for (u64 i = 0; i < count; ++i)
+	{
+		u16 half = quantize_f16(src[i]);
+
+		memcpy((byte*)dest + i * sizeof(u16), &half, sizeof(u16));
+	}
+
+	return count;
+}
+
+static u64 dequantize_f16_scalar(f32* dest, cmem src, u64 count)
+{
+	for (u64 i = 0; i < count; ++i)
+	{
+		u16 half;
+
+		memcpy(&half, (const byte*)src + i * sizeof(u16), sizeof(u16));
+
+		dest[i] = dequantize_f16(half);
+	}
+
+	return count;
+}
+
+static u64 quantize_snorm16_scalar(mem dest, const f32* src, u64 count)
+{
+	for (u64 i = 0; i < count; ++i)
+	{
+		i16 snorm = quantize_snorm16(src[i]);
+
+		memcpy((byte*)dest + i * sizeof(i16), &snorm, sizeof(i16));
+	}
+
+	return count;
+}
+
+static u64 dequantize_snorm16_scalar(f32* dest, cmem src, u64 count)
+{
+	for (u64 i = 0; i < count; ++i)
+	{
+		i16 snorm;
+
+		memcpy(&snorm, (const byte*)src + i * sizeof(i16), sizeof(i16));
+
+		dest[i] = dequantize_snorm16(snorm);
+	}
+
+	return count;
+}
+
+static u64 quantize_unorm8_scalar(mem dest, const f32* src, u64 count)
+{
+	for (u64 i = 0; i < count; ++i) ((u8*)dest)[i] = quantize_unorm8(src[i]);
+
+	return count;
+}
+
+static u64 dequantize_unorm8_scalar(f32* dest, cmem src, u64 count)
+{
+	for (u64 i = 0; i < count; ++i) dest[i] = dequantize_unorm8(((const u8*)src)[i]);
+
+	return count;
+}
+
+#ifdef QUANTIZE_X86
+
+QUANTIZE_TARGET("avx,f16c")
+static u64 quantize_f16_f16c(mem dest, const f32* src, u64 count)
+{
+	byte* out = (byte*)dest;
+	u64 i = 0;
+
+	for (; i + 8 <= count; i += 8)
+		_mm_storeu_si128((__m128i*)(out + i * sizeof(u16)), _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+
+	return i;
+}
+
+QUANTIZE_TARGET("avx,f16c")
+static u64 dequantize_f16_f16c(f32* dest, cmem src, u64 count)
+{
+	const byte* in = (const byte*)src;
+	u64 i = 0;
+
+	for (; i + 8 <= count; i += 8)
+		_mm256_storeu_ps(dest + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(in + i * sizeof(u16)))));
+
+	return i;
+}
+
+QUANTIZE_TARGET("sse2")
+static u64 quantize_snorm16_sse2(mem dest, const f32* src, u64 count)
+{
+	const __m128 upper = _mm_set1_ps(1.0f);
+	const __m128 lower = _mm_set1_ps(-1.0f);
+	const __m128 scale = _mm_set1_ps(QUANTIZE_SNORM16_SCALE);
+
+	byte* out = (byte*)dest;
+	u64 i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128 a = _mm_max_ps(_mm_min_ps(_mm_loadu_ps(src + i), upper), lower);
+		__m128 b = _mm_max_ps(_mm_min_ps(_mm_loadu_ps(src + i + 4), upper), lower);
+
+		__m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(a, scale)), _mm_cvtps_epi32(_mm_mul_ps(b, scale)));
+
+		_mm_storeu_si128((__m128i*)(out + i * sizeof(i16)), packed);
+	}
+
+	return i;
+}
+
+QUANTIZE_TARGET("sse2")
+static u64 dequantize_snorm16_sse2(f32* dest, cmem src, u64 count)
+{
+	const __m128 lower = _mm_set1_ps(-1.0f);
+	const __m128 scale = _mm_set1_ps(1.0f / QUANTIZE_SNORM16_SCALE);
+
+	const byte* in = (const byte*)src;
+	u64 i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i packed = _mm_loadu_si128((const __m128i*)(in + i * sizeof(i16)));
+
+		// duplicating each lane into both halves and shifting arithmetically sign-extends without sse4.1
+		__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+		__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(packed, packed), 16);
+
+		_mm_storeu_ps(dest + i, _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(lo), scale), lower));
+		_mm_storeu_ps(dest + i + 4, _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(hi), scale), lower));
+	}
+
+	return i;
+}
+
+QUANTIZE_TARGET("sse2")
+static u64 quantize_unorm8_sse2(mem dest, const f32* src, u64 count)
+{
+	const __m128 upper = _mm_set1_ps(1.0f);
+	const __m128 lower = _mm_setzero_ps();
+	const __m128 scale = _mm_set1_ps(QUANTIZE_UNORM8_SCALE);
+
+	byte* out = (byte*)dest;
+	u64 i = 0;
+
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i q[4];
+
+		for (u64 j = 0; j < 4; ++j)
+			q[j] = _mm_cvtps_epi32(_mm_mul_ps(_mm_max_ps(_mm_min_ps(_mm_loadu_ps(src + i + j * 4), upper), lower), scale));
+
+		__m128i packed = _mm_packus_epi16(_mm_packs_epi32(q[0], q[1]), _mm_packs_epi32(q[2], q[3]));
+
+		_mm_storeu_si128((__m128i*)(out + i), packed);
+	}
+
+	return i;
+}
+
+QUANTIZE_TARGET("sse2")
+static u64 dequantize_unorm8_sse2(f32* dest, cmem src, u64 count)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 scale = _mm_set1_ps(1.0f / QUANTIZE_UNORM8_SCALE);
+
+	const byte* in = (const byte*)src;
+	u64 i = 0;
+
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i packed = _mm_loadu_si128((const __m128i*)(in + i));
+
+		__m128i lo = _mm_unpacklo_epi8(packed, zero);
+		__m128i hi = _mm_unpackhi_epi8(packed, zero);
+
+		_mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+		_mm_storeu_ps(dest + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+		_mm_storeu_ps(dest + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+		_mm_storeu_ps(dest + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+	}
+
+	return i;
+}
+
+#endif
+
+u64 quantize_format_size(quantize_format_t format)
+{
+	switch (format)
+	{
+		case QUANTIZE_FORMAT_F16: return sizeof(u16);
+		case QUANTIZE_FORMAT_SNORM16: return sizeof(i16);
+		case QUANTIZE_FORMAT_UNORM8: return sizeof(u8);
+
+		default: return 0;
+	}
+}
+
+err_t quantize_format_type(quantize_format_t format, container_type_t* type, i32* normalized)
+{
+	if (type == NULL) return error_param_null("type", __FILE__, __LINE__);
+	if (normalized == NULL) return error_param_null("normalized", __FILE__, __LINE__);
+
+	switch (format)
+	{
+		case QUANTIZE_FORMAT_F16:
+			*type = CONTAINER_TYPE_F16;
+			*normalized = false;
+			return ERROR_NONE;
+		case QUANTIZE_FORMAT_SNORM16:
+			*type = CONTAINER_TYPE_I16;
+			*normalized = true;
+			return ERROR_NONE;
+		case QUANTIZE_FORMAT_UNORM8:
+			*type = CONTAINER_TYPE_U8;
+			*normalized = true;
+			return ERROR_NONE;
+
+		default: return error_unknown_enum("quantize_format_t", (i32)format, __FILE__, __LINE__);
+	}
+}
+
+/// <summary>
+/// measures the error of an array already quantized by comparing each input to its decoded value
+/// </summary>
+/// <param name="error">- address of the error report</param>
+/// <param name="quantized">- quantized components</param>
+/// <param name="src">- original floats</param>
+/// <param name="count">- number of components</param>
+/// <param name="format">- quantized format</param>
+static void quantize_measure(quantize_error_t* error, cmem quantized, const f32* src, u64 count, quantize_format_t format)
+{
+	f64 total = 0.0;
+	f32 largest = 0.0f;
+	u64 measured = 0;
+
+	memset(error, 0, sizeof(quantize_error_t));
+
+	for (u64 i = 0; i < count; ++i)
+	{
+		f32 value = src[i];
+		f32 decoded;
+		i32 in_range;
+
+		switch (format)
+		{
+			case QUANTIZE_FORMAT_F16:
+				in_range = fabsf(value) <= QUANTIZE_F16_MAX;
+				dequantize_f16_scalar(&decoded, (const byte*)quantized + i * sizeof(u16), 1);
+				break;
+			case QUANTIZE_FORMAT_SNORM16:
+				in_range = value >= -1.0f && value <= 1.0f;
+				dequantize_snorm16_scalar(&decoded, (const byte*)quantized + i * sizeof(i16), 1);
+				break;
+			default:
+				in_range = value >= 0.0f && value <= 1.0f;
+				decoded = dequantize_unorm8(((const u8*)quantized)[i]);
+				break;
+		}
+
+		// nan compares false and so is counted as out of range
+		if (!in_range)
+		{
+			++error->clamped;
+			continue;
+		}
+
+		f32 difference = fabsf(decoded - value);
+
+		if (difference > error->max) error->max = difference;
+		if (fabsf(value) > largest) largest = fabsf(value);
+
+		total += difference;
+		++measured;
+	}
+
+	error->mean = measured > 0 ? (f32)(total / (f64)measured) : 0.0f;
+
+	switch (format)
+	{
+		case QUANTIZE_FORMAT_F16:
+		{
+			// half an ulp at the magnitude of the largest input, floored at the fixed spacing of the subnormals
+			i32 exponent = 0;
+
+			frexpf(largest, &exponent);
+
+			error->bound = largest < 6.103515625e-05f ? ldexpf(1.0f, -25) : ldexpf(1.0f, exponent - 12);
+			break;
+		}
+		case QUANTIZE_FORMAT_SNORM16:
+			error->bound = 0.5f / QUANTIZE_SNORM16_SCALE + QUANTIZE_SCALE_ROUNDING;
+			break;
+		default:
+			error->bound = 0.5f / QUANTIZE_UNORM8_SCALE + QUANTIZE_SCALE_ROUNDING;
+			break;
+	}
+}
+
+err_t quantize_floats(mem dest, const f32* src, u64 count, quantize_format_t format, quantize_error_t* error)
+{
+	if (dest == NULL) return error_param_null("dest", __FILE__, __LINE__);
+	if (src == NULL) return error_param_null("src", __FILE__, __LINE__);
+
+	quantize_kernel_t scalar = NULL;
+	quantize_kernel_t simd = NULL;
+
+	switch (format)
+	{
+		case QUANTIZE_FORMAT_F16:
+			scalar = quantize_f16_scalar;
+#ifdef QUANTIZE_X86
+			if (cpu_supports(CPU_FEATURE_F16C)) simd = quantize_f16_f16c;
+#endif
+			break;
+		case QUANTIZE_FORMAT_SNORM16:
+			scalar = quantize_snorm16_scalar;
+#ifdef QUANTIZE_X86
+			if (cpu_supports(CPU_FEATURE_SSE2)) simd = quantize_snorm16_sse2;
+#endif
+			break;
+		case QUANTIZE_FORMAT_UNORM8:
+			scalar = quantize_unorm8_scalar;
+#ifdef QUANTIZE_X86
+			if (cpu_supports(CPU_FEATURE_SSE2)) simd = quantize_unorm8_sse2;
+#endif
+			break;
+		default:
+			return error_unknown_enum("quantize_format_t", (i32)format, __FILE__, __LINE__);
+	}
+
+	u64 done = simd != NULL ? simd(dest, src, count) : 0;
+
+	scalar((byte*)dest + done * quantize_format_size(format), src + done, count - done);
+
+	if (error != NULL) quantize_measure(error, dest, src, count, format);
+
+	return ERROR_NONE;
+}
+
+err_t dequantize_floats(f32* dest, cmem src, u64 count, quantize_format_t format)
+{
+	if (dest == NULL) return error_param_null("dest", __FILE__, __LINE__);
+	if (src == NULL) return error_param_null("src", __FILE__, __LINE__);
+
+	dequantize_kernel_t scalar = NULL;
+	dequantize_kernel_t simd = NULL;
+
+	switch (format)
+	{
+		case QUANTIZE_FORMAT_F16:
+			scalar = dequantize_f16_scalar;
+#ifdef QUANTIZE_X86
+			if (cpu_supports(CPU_FEATURE_F16C)) simd = dequantize_f16_f16c;
+#endif
+			break;
+		case QUANTIZE_FORMAT_SNORM16:
+			scalar = dequantize_snorm16_scalar;
+#ifdef QUANTIZE_X86
+			if (cpu_supports(CPU_FEATURE_SSE2)) simd = dequantize_snorm16_sse2;
+#endif
+			break;
+		case QUANTIZE_FORMAT_UNORM8:
+			scalar = dequantize_unorm8_scalar;
+#ifdef QUANTIZE_X86
+			if (cpu_supports(CPU_FEATURE_SSE2)) simd = dequantize_unorm8_sse2;
+#endif
+			break;
+		default:
+			return error_unknown_enum("quantize_format_t", (i32)format, __FILE__, __LINE__);
+	}
+
+	u64 done = simd != NULL ? simd(dest, src, count) : 0;
+
+	scalar(dest + done, (const byte*)src + done * quantize_format_size(format), count - done);
+
+	return ERROR_NONE;
+}
+
+err_t quantize_vec2s(mem dest, const vec2_t* src, u64 count, quantize_format_t format, quantize_error_t* error)
+{
+	return quantize_floats(dest, (const f32*)src, count * 2, format, error);
+}
+
+err_t quantize_vec3s(mem dest, const vec3_t* src, u64 count, quantize_format_t format, quantize_error_t* error)
+{
+	return quantize_floats(dest, (const f32*)src, count * 3, format, error);
+}
+
+err_t quantize_vec4s(mem dest, const vec4_t* src, u64 count, quantize_format_t format, quantize_error_t* error)
+{
+	return quantize_floats(dest, (const f32*)src, count * 4, format, error);
+}
+
+err_t dequantize_vec2s(vec2_t* dest, cmem src, u64 count, quantize_format_t format)
+{
+	return dequantize_floats((f32*)dest, src, count * 2, format);
+}
+
+err_t dequantize_vec3s(vec3_t* dest, cmem src, u64 count, quantize_format_t format)
+{
+	return dequantize_floats((f32*)dest, src, count * 3, format);
+}
+
+err_t dequantize_vec4s(vec4_t* dest, cmem src, u64 count, quantize_format_t format)
+{
+	return dequantize_floats((f32*)dest, src, count * 4, format);
+}
@@ -1,10 +1,47 @@
 #include "reader.h"
 
+#include "allocator.h"
+#include "memory.h"
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 
-int reader_string(cstr path, str* content)
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef _MSC_VER
+#define READER_THREAD_LOCAL __declspec(thread)
+#else
+#define READER_THREAD_LOCAL _Thread_local
+#endif
+
+// smallest scratch buffer allocated, so small files do not grow it one step at a time
+#define READER_SCRATCH_MIN 4096
+
+// scratch buffer of reader_text_scratch, one per thread so readers on different threads never share it
+static READER_THREAD_LOCAL str reader_scratch = NULL;
+static READER_THREAD_LOCAL u64 reader_scratch_capacity = 0;
+
+err_t reader_string(cstr path, str* content)
+{
+	return reader_string_ex(path, content, NULL);
+}
+
+err_t reader_binary(cstr path, byte** buffer)
+{
+	return reader_binary_ex(path, buffer, NULL);
+}
+
+err_t reader_string_ex(cstr path, str* content, const allocator_t* allocator)
 {
 	if (path == NULL) return error_param_null("path", __FILE__, __LINE__);
 	if (content == NULL) return error_param_null("content", __FILE__, __LINE__);
@@ -19,31 +56,23 @@ int reader_string(cstr path, str* content)
 	u64 str_size = (u64)ftell(ptr);
 	rewind(ptr);
 
-	*content = (str)malloc(str_size);
+	// text mode can only shrink what is read, so one allocation with room for the terminator is enough
+	err_t err = allocator_alloc(allocator, (mem*)content, str_size + 1, 1);
 
-	if (*content == NULL) return error_alloc_fail("str", str_size, __FILE__, __LINE__);
-
-	memset(*content, '\0', str_size);
-
-	u64 read_size = fread(*content, sizeof(char), str_size, ptr);
-
-	if (str_size != read_size)
+	if (err != ERROR_NONE)
 	{
-		void* trunc = realloc(*content, read_size + 1);
+		fclose(ptr);
 
-		if (trunc == NULL)
-		{
-			free(*content);
+		return err;
+	}
 
-			return error_alloc_fail("str", read_size + 1, __FILE__, __LINE__);
-		}
+	u64 read_size = fread(*content, sizeof(char), str_size, ptr);
 
-		*content = (str)trunc;
-	}
+	(*content)[read_size] = '\0';
 
 	if (fclose(ptr) < 0)
 	{
-		free(*content);
+		allocator_free(allocator, (mem*)content);
 
 		return error_uncloseable_file(path, __FILE__, __LINE__);
 	}
@@ -51,10 +80,18 @@ int reader_string(cstr path, str* content)
 	return ERROR_NONE;
 }
 
-int reader_binary(cstr path, byte** buffer)
+err_t reader_binary_ex(cstr path, byte** buffer, const allocator_t* allocator)
+{
+	u64 size = 0;
+
+	return reader_binary_sized_ex(path, buffer, &size, allocator);
+}
+
+err_t reader_binary_sized_ex(cstr path, byte** buffer, u64* size, const allocator_t* allocator)
 {
 	if (path == NULL) return error_param_null("path", __FILE__, __LINE__);
 	if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
+	if (size == NULL) return error_param_null("size", __FILE__, __LINE__);
 
 	if (*buffer != NULL) return error_param_notnull("*buffer", __FILE__, __LINE__);
 
@@ -66,15 +103,315 @@ int reader_binary(cstr path, byte** buffer)
 	u64 byte_size = (u64)ftell(ptr);
 	rewind(ptr);
 
-	*buffer = malloc(byte_size);
+	// align the buffer like the serializer does so container payloads stay aligned once loaded
+	err_t err = allocator_alloc(allocator, (mem*)buffer, byte_size, MEMORY_ALIGNMENT);
+
+	if (err != ERROR_NONE)
+	{
+		fclose(ptr);
+
+		return err;
+	}
+
+	u64 read_size = fread(*buffer, sizeof(byte), byte_size, ptr);
+
+	if (byte_size != read_size)
+	{
+		fclose(ptr);
+		allocator_free(allocator, (mem*)buffer);
+
+		return error_size_mismatch(byte_size, read_size, __FILE__, __LINE__);
+	}
+
+	if (fclose(ptr) < 0)
+	{
+		allocator_free(allocator, (mem*)buffer);
+
+		return error_uncloseable_file(path, __FILE__, __LINE__);
+	}
+
+	*size = byte_size;
+
+	return ERROR_NONE;
+}
+
+/// <summary>
+/// grows the scratch buffer of the calling thread to hold at least a number of bytes, discarding its contents
+/// </summary>
+/// <param name="size">- number of bytes needed</param>
+/// <returns>ERROR_NONE on success, ERROR_ALLOC_FAIL on failure</returns>
+static err_t reader_scratch_reserve(u64 size)
+{
+	if (size <= reader_scratch_capacity) return ERROR_NONE;
+
+	u64 capacity = reader_scratch_capacity > READER_SCRATCH_MIN ? reader_scratch_capacity : READER_SCRATCH_MIN;
+
+	while (capacity < size) capacity *= 2;
+
+	reader_scratch_release();
+
+	err_t err = allocator_alloc(NULL, (mem*)&reader_scratch, capacity, 1);
+
+	if (err != ERROR_NONE) return err;
+
+	reader_scratch_capacity = capacity;
+
+	return ERROR_NONE;
+}
+
+err_t reader_text_scratch(cstr path, reader_view_t* view)
+{
+	if (path == NULL) return error_param_null("path", __FILE__, __LINE__);
+	if (view == NULL) return error_param_null("view", __FILE__, __LINE__);
+
+	view->data = NULL;
+	view->size = 0;
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+
+	if (file == INVALID_HANDLE_VALUE) return error_unopenable_file(path, __FILE__, __LINE__);
+
+	LARGE_INTEGER file_size;
+
+	// the whole file is read with one ReadFile, which takes a 32-bit length
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart >= MAXDWORD)
+	{
+		CloseHandle(file);
+
+		return error_unopenable_file(path, __FILE__, __LINE__);
+	}
+
+	u64 byte_size = (u64)file_size.QuadPart;
+
+	err_t err = reader_scratch_reserve(byte_size + 1);
+
+	if (err != ERROR_NONE)
+	{
+		CloseHandle(file);
+
+		return err;
+	}
+
+	DWORD read_size = 0;
+
+	if (!ReadFile(file, reader_scratch, (DWORD)byte_size, &read_size, NULL) || read_size != byte_size)
+	{
+		CloseHandle(file);
+
+		return error_size_mismatch(byte_size, read_size, __FILE__, __LINE__);
+	}
+
+	if (!CloseHandle(file)) return error_uncloseable_file(path, __FILE__, __LINE__);
+#else
+	int file = open(path, O_RDONLY | O_CLOEXEC);
+
+	if (file < 0) return error_unopenable_file(path, __FILE__, __LINE__);
+
+	struct stat file_stat;
+
+	if (fstat(file, &file_stat) != 0)
+	{
+		close(file);
+
+		return error_unopenable_file(path, __FILE__, __LINE__);
+	}
+
+	u64 byte_size = (u64)file_stat.st_size;
+
+	err_t err = reader_scratch_reserve(byte_size + 1);
+
+	if (err != ERROR_NONE)
+	{
+		close(file);
+
+		return err;
+	}
+
+	// a regular file is read in one call; the loop only resumes after a signal or a short read
+	u64 read_size = 0;
+
+	while (read_size < byte_size)
+	{
+		ssize_t count = read(file, reader_scratch + read_size, (size_t)(byte_size - read_size));
+
+		if (count < 0 && errno == EINTR) continue;
+
+		if (count <= 0) break;
+
+		read_size += (u64)count;
+	}
+
+	if (read_size != byte_size)
+	{
+		close(file);
+
+		return error_size_mismatch(byte_size, read_size, __FILE__, __LINE__);
+	}
+
+	if (close(file) != 0) return error_uncloseable_file(path, __FILE__, __LINE__);
+#endif
+
+	reader_scratch[byte_size] = '\0';
+
+	view->data = reader_scratch;
+	view->size = byte_size;
+
+	return ERROR_NONE;
+}
+
+void reader_scratch_release()
+{
+	if (reader_scratch != NULL) allocator_free(NULL, (mem*)&reader_scratch);
+
+	reader_scratch = NULL;
+	reader_scratch_capacity = 0;
+}
+
+err_t reader_map(cstr path, reader_map_t* map)
+{
+	if (path == NULL) return error_param_null("path", __FILE__, __LINE__);
+	if (map == NULL) return error_param_null("map", __FILE__, __LINE__);
+
+	if (map->data != NULL) return error_param_notnull("map->data", __FILE__, __LINE__);
+
+	map->size = 0;
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if (file == INVALID_HANDLE_VALUE) return error_unopenable_file(path, __FILE__, __LINE__);
+
+	LARGE_INTEGER file_size;
+
+	if (!GetFileSizeEx(file, &file_size))
+	{
+		CloseHandle(file);
+
+		return error_unmappable_file(path, __FILE__, __LINE__);
+	}
+
+	// an empty file cannot be mapped, but it is still a valid (empty) mapping
+	if (file_size.QuadPart == 0)
+	{
+		CloseHandle(file);
+
+		return ERROR_NONE;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+	// the view keeps the mapping and file alive, so neither handle is needed past this point
+	CloseHandle(file);
+
+	if (mapping == NULL) return error_unmappable_file(path, __FILE__, __LINE__);
 
-	if (*buffer == NULL) return error_alloc_fail("byte", byte_size, __FILE__, __LINE__);
+	map->data = (const byte*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
 
-	u64 read_size = fread(*buffer, BYTE_SIZE, byte_size / BYTE_SIZE, ptr);
+	CloseHandle(mapping);
 
-	if (byte_size / BYTE_SIZE != read_size) return error_size_mismatch(byte_size, read_size, __FILE__, __LINE__);
+	if (map->data == NULL) return error_unmappable_file(path, __FILE__, __LINE__);
 
-	if (fclose(ptr) < 0) return error_uncloseable_file(path, __FILE__, __LINE__);
+	map->size = (u64)file_size.QuadPart;
+#else
+	int file = open(path, O_RDONLY | O_CLOEXEC);
 
-	return 0;
+	if (file < 0) return error_unopenable_file(path, __FILE__, __LINE__);
+
+	struct stat file_stat;
+
+	if (fstat(file, &file_stat) != 0)
+	{
+		close(file);
+
+		return error_unmappable_file(path, __FILE__, __LINE__);
+	}
+
+	// an empty file cannot be mapped, but it is still a valid (empty) mapping
+	if (file_stat.st_size == 0)
+	{
+		close(file);
+
+		return ERROR_NONE;
+	}
+
+	void* data = mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+	// the mapping keeps the file alive, so the descriptor is not needed past this point
+	close(file);
+
+	if (data == MAP_FAILED) return error_unmappable_file(path, __FILE__, __LINE__);
+
+	map->data = (const byte*)data;
+	map->size = (u64)file_stat.st_size;
+#endif
+
+	return ERROR_NONE;
+}
+
+err_t reader_map_advise(const reader_map_t* map, reader_advice_t advice)
+{
+	if (map == NULL) return error_param_null("map", __FILE__, __LINE__);
+
+	if (map->data == NULL) return ERROR_NONE;
+
+#ifdef _WIN32
+	switch (advice)
+	{
+		case READER_ADVICE_NORMAL:
+		case READER_ADVICE_SEQUENTIAL:
+		case READER_ADVICE_RANDOM:
+			// windows reads mapped views ahead on its own and has no per-view access hints
+			break;
+		case READER_ADVICE_WILLNEED:
+		{
+			WIN32_MEMORY_RANGE_ENTRY range;
+
+			range.VirtualAddress = (PVOID)map->data;
+			range.NumberOfBytes = (SIZE_T)map->size;
+
+			// a failed prefetch only loses the hint, so its result is ignored
+			PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+			break;
+		}
+
+		default: return error_unknown_enum("reader_advice_t", (i32)advice, __FILE__, __LINE__);
+	}
+#else
+	int hint = MADV_NORMAL;
+
+	switch (advice)
+	{
+		case READER_ADVICE_NORMAL: hint = MADV_NORMAL; break;
+		case READER_ADVICE_SEQUENTIAL: hint = MADV_SEQUENTIAL; break;
+		case READER_ADVICE_RANDOM: hint = MADV_RANDOM; break;
+		case READER_ADVICE_WILLNEED: hint = MADV_WILLNEED; break;
+
+		default: return error_unknown_enum("reader_advice_t", (i32)advice, __FILE__, __LINE__);
+	}
+
+	// a rejected hint only loses the hint, so its result is ignored
+	madvise((void*)map->data, (size_t)map->size, hint);
+#endif
+
+	return ERROR_NONE;
+}
+
+err_t reader_unmap(reader_map_t* map)
+{
+	if (map == NULL) return error_param_null("map", __FILE__, __LINE__);
+
+	if (map->data != NULL)
+	{
+#ifdef _WIN32
+		if (!UnmapViewOfFile(map->data)) return error_unmappable_file("view", __FILE__, __LINE__);
+#else
+		if (munmap((void*)map->data, (size_t)map->size) != 0) return error_unmappable_file("view", __FILE__, __LINE__);
+#endif
+	}
+
+	map->data = NULL;
+	map->size = 0;
+
+	return ERROR_NONE;
 }
@@ -1,5 +1,11 @@
 #include "serializer.h"
 
+#include "allocator.h"
+#include "compress.h"
+#include "endian.h"
+#include "layout.h"
+#include "workers.h"
+
 #include "vec2.h"
 #include "vec3.h"
 #include "vec4.h"
@@ -8,196 +14,540 @@
 #include <string.h>
 #include <stdio.h>
 
-#define SERIALIZE_TYPE u64
+// pool that large payloads are converted and compressed on, or null for the calling thread alone
+static struct workers_t* serializer_workers = NULL;
+
+void serializer_workers_set(struct workers_t* workers)
+{
+    serializer_workers = workers;
+}
 
-err_t serialize_size(byte** buffer, u64 arr_size, u64 elem_size)
+err_t serialize_header(byte** buffer, container_type_t type, u32 components, u64 count)
 {
     if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
     if (*buffer != NULL) return error_param_notnull("*buffer", __FILE__, __LINE__);
 
-    err_t err = buffer_create(buffer, arr_size * elem_size);
+    container_t header;
 
-    if (err > 0) return err;
+    err_t err = container_init(&header, type, components, count);
 
-    union { SERIALIZE_TYPE element; byte bytes[sizeof(SERIALIZE_TYPE)]; } translator;
+    if (err != ERROR_NONE) return err;
 
-    memcpy(&translator.element, &arr_size, sizeof(SERIALIZE_TYPE));
-    memcpy(*buffer, translator.bytes, sizeof(SERIALIZE_TYPE));
+    err = buffer_create(buffer, header.offset + header.length);
 
-    return ERROR_NONE;
+    if (err != ERROR_NONE) return err;
+
+    // zero the padding between the header and the payload so the output is deterministic
+    memset(*buffer + sizeof(container_t), 0, header.offset - sizeof(container_t));
+
+    return container_write(*buffer, &header);
 }
 
 err_t buffer_create(byte** buffer, u64 mem_size)
 {
-    if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
-    if (*buffer != NULL) return error_param_notnull("*buffer", __FILE__, __LINE__);
-
-    u64 buff_size = (sizeof(u64) + mem_size) * sizeof(byte);
+    return buffer_create_ex(buffer, mem_size, NULL);
+}
 
-    *buffer = (byte*)malloc(buff_size);
+err_t buffer_destroy(byte** buffer)
+{
+    return buffer_destroy_ex(buffer, NULL);
+}
 
-    if (*buffer == NULL) return error_alloc_fail("byte", buff_size, __FILE__, __LINE__);
+err_t buffer_create_ex(byte** buffer, u64 mem_size, const allocator_t* allocator)
+{
+    if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
+    if (*buffer != NULL) return error_param_notnull("*buffer", __FILE__, __LINE__);
 
-    return ERROR_NONE;
+    return allocator_alloc(allocator, (mem*)buffer, mem_size * sizeof(byte), CONTAINER_ALIGNMENT);
 }
 
-err_t buffer_destroy(byte** buffer)
+err_t buffer_destroy_ex(byte** buffer, const allocator_t* allocator)
 {
     if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
     if (*buffer == NULL) return error_param_null("*buffer", __FILE__, __LINE__);
 
-    free(*buffer);
-    *buffer = NULL;
-
-    return ERROR_NONE;
+    return allocator_free(allocator, (mem*)buffer);
 }
 
-#undef SERIALIZE_TYPE
-#define SERIALIZE_TYPE f32
-
-err_t serialize_floats(byte** buffer, const f32* array, u64 size)
+err_t serialize_array(byte** buffer, container_type_t type, u32 components, cmem array, u64 size)
 {
     if (array == NULL) return error_param_null("array", __FILE__, __LINE__);
 
     if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
     if (*buffer != NULL) return error_param_notnull("*buffer", __FILE__, __LINE__);
 
-    err_t err = serialize_size(buffer, size, sizeof(SERIALIZE_TYPE));
+    err_t err = serialize_header(buffer, type, components, size);
 
-    if (err > 0) return err;
+    if (err != ERROR_NONE) return err;
 
-    union { SERIALIZE_TYPE element; byte bytes[sizeof(SERIALIZE_TYPE)]; } translator;
+    u64 type_size = container_type_size(type);
 
     // offset pointer to the beginning of the array bytes portion of the buffer
-    byte* array_base_ptr = *buffer + sizeof(u64);
+    byte* array_base_ptr = *buffer + CONTAINER_OFFSET;
 
-    for (u64 i = 0; i < size; ++i)
+    // the serialized format is little-endian, so a bigly system swaps the array as it is copied
+    err = workers_convert_array(serializer_workers, array_base_ptr, array, type_size, size * components, endianness_detect() == ENDIAN_BIGLY);
+
+    if (err != ERROR_NONE)
     {
-        // copy the i-th element from the array into the element of the union
-        memcpy(&translator.element, array + i, sizeof(SERIALIZE_TYPE));
-        // copy the bytes of the union into the byte buffer
-        memcpy(array_base_ptr + i * sizeof(SERIALIZE_TYPE), translator.bytes, sizeof(SERIALIZE_TYPE));
+        buffer_destroy(buffer);
+
+        return err;
     }
 
     return ERROR_NONE;
 }
 
-#undef SERIALIZE_TYPE
-#define SERIALIZE_TYPE u32
+err_t serialize_floats(byte** buffer, const f32* array, u64 size)
+{
+    return serialize_array(buffer, CONTAINER_TYPE_F32, 1, array, size);
+}
 
 err_t serialize_u32s(byte** buffer, const u32* array, u64 size)
+{
+    return serialize_array(buffer, CONTAINER_TYPE_U32, 1, array, size);
+}
+
+err_t serialize_vec2s(byte** buffer, const vec2_t* array, u64 size)
+{
+    return serialize_array(buffer, CONTAINER_TYPE_F32, 2, array, size);
+}
+
+err_t serialize_vec3s(byte** buffer, const vec3_t* array, u64 size)
+{
+    return serialize_array(buffer, CONTAINER_TYPE_F32, 3, array, size);
+}
+
+err_t serialize_vec4s(byte** buffer, const vec4_t* array, u64 size)
+{
+    return serialize_array(buffer, CONTAINER_TYPE_F32, 4, array, size);
+}
+
+err_t serialize_indices(byte** buffer, const u32* array, u64 size, indices_encoding_t encoding)
 {
     if (array == NULL) return error_param_null("array", __FILE__, __LINE__);
 
     if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
     if (*buffer != NULL) return error_param_notnull("*buffer", __FILE__, __LINE__);
 
-    err_t err = serialize_size(buffer, size, sizeof(SERIALIZE_TYPE));
+    if (encoding != INDICES_ENCODING_NARROW && encoding != INDICES_ENCODING_DELTA) return error_unknown_enum("indices_encoding_t", (i32)encoding, __FILE__, __LINE__);
 
-    if (err > 0) return err;
+    container_type_t type = indices_narrowest(array, size);
 
-    union { SERIALIZE_TYPE element; byte bytes[sizeof(SERIALIZE_TYPE)]; } translator;
+    container_t header;
 
-    // offset pointer to the beginning of the array bytes portion of the buffer
-    byte* array_base_ptr = *buffer + sizeof(u64);
+    err_t err = container_init(&header, type, 1, size);
+
+    if (err != ERROR_NONE) return err;
+
+    byte* encoded = NULL;
 
-    for (u64 i = 0; i < size; ++i)
+    if (encoding == INDICES_ENCODING_DELTA)
     {
-        // copy the i-th element from the array into the element of the union
-        memcpy(&translator.element, array + i, sizeof(SERIALIZE_TYPE));
-        // copy the bytes of the union into the byte buffer
-        memcpy(array_base_ptr + i * sizeof(SERIALIZE_TYPE), translator.bytes, sizeof(SERIALIZE_TYPE));
+        encoded = (byte*)malloc(size > 0 ? size * INDICES_VARINT_MAX : 1);
+
+        if (encoded == NULL) return error_alloc_fail("byte", size * INDICES_VARINT_MAX, __FILE__, __LINE__);
+
+        err = indices_encode(encoded, &header.stored, array, size);
+
+        if (err != ERROR_NONE)
+        {
+            free(encoded);
+
+            return err;
+        }
+
+        header.flags |= CONTAINER_FLAG_DELTA;
+    }
+
+    err = buffer_create(buffer, header.offset + header.stored);
+
+    if (err != ERROR_NONE)
+    {
+        free(encoded);
+
+        return err;
+    }
+
+    memset(*buffer + sizeof(container_t), 0, header.offset - sizeof(container_t));
+
+    container_write(*buffer, &header);
+
+    byte* array_base_ptr = *buffer + header.offset;
+
+    if (encoded != NULL)
+    {
+        // varints are a byte stream, so they need no swapping
+        memcpy(array_base_ptr, encoded, header.stored);
+        free(encoded);
+
+        return ERROR_NONE;
+    }
+
+    err = indices_narrow(array_base_ptr, array, size, type);
+
+    if (err == ERROR_NONE && endianness_detect() == ENDIAN_BIGLY) err = workers_convert_array(serializer_workers, array_base_ptr, array_base_ptr, container_type_size(type), size, true);
+
+    if (err != ERROR_NONE)
+    {
+        buffer_destroy(buffer);
+
+        return err;
     }
 
     return ERROR_NONE;
 }
 
-#undef SERIALIZE_TYPE
-#define SERIALIZE_TYPE vec2_t
-
-err_t serialize_vec2s(byte** buffer, const vec2_t* array, u64 size)
+err_t serialize_quantized(byte** buffer, quantize_format_t format, u32 components, const f32* array, u64 size, quantize_error_t* error)
 {
     if (array == NULL) return error_param_null("array", __FILE__, __LINE__);
 
     if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
     if (*buffer != NULL) return error_param_notnull("*buffer", __FILE__, __LINE__);
 
-    err_t err = serialize_size(buffer, size, sizeof(SERIALIZE_TYPE));
+    container_type_t type;
+    i32 normalized;
 
-    if (err > 0) return err;
+    err_t err = quantize_format_type(format, &type, &normalized);
 
-    union { SERIALIZE_TYPE element; byte bytes[sizeof(SERIALIZE_TYPE)]; } translator;
+    if (err != ERROR_NONE) return err;
 
-    // offset pointer to the beginning of the array bytes portion of the buffer
-    byte* array_base_ptr = *buffer + sizeof(u64);
+    container_t header;
+
+    err = container_init(&header, type, components, size);
+
+    if (err != ERROR_NONE) return err;
+
+    if (normalized) header.flags |= CONTAINER_FLAG_NORMALIZED;
+
+    err = buffer_create(buffer, header.offset + header.length);
+
+    if (err != ERROR_NONE) return err;
+
+    memset(*buffer + sizeof(container_t), 0, header.offset - sizeof(container_t));
+
+    container_write(*buffer, &header);
+
+    byte* array_base_ptr = *buffer + header.offset;
+
+    // components are quantized straight into the payload, then swapped in place on a bigly system
+    err = quantize_floats(array_base_ptr, array, size * components, format, error);
 
-    for (u64 i = 0; i < size; ++i)
+    if (err == ERROR_NONE && endianness_detect() == ENDIAN_BIGLY) err = workers_convert_array(serializer_workers, array_base_ptr, array_base_ptr, container_type_size(type), size * components, true);
+
+    if (err != ERROR_NONE)
     {
-        // copy the i-th element from the array into the element of the union
-        memcpy(&translator.element, array + i, sizeof(SERIALIZE_TYPE));
-        // copy the bytes of the union into the byte buffer
-        memcpy(array_base_ptr + i * sizeof(SERIALIZE_TYPE), translator.bytes, sizeof(SERIALIZE_TYPE));
+        buffer_destroy(buffer);
+
+        return err;
     }
 
     return ERROR_NONE;
 }
 
-#undef SERIALIZE_TYPE
-#define SERIALIZE_TYPE vec3_t
+err_t serialize_vec2s_quantized(byte** buffer, quantize_format_t format, const vec2_t* array, u64 size, quantize_error_t* error)
+{
+    return serialize_quantized(buffer, format, 2, (const f32*)array, size, error);
+}
 
-err_t serialize_vec3s(byte** buffer, const vec3_t* array, u64 size)
+err_t serialize_vec3s_quantized(byte** buffer, quantize_format_t format, const vec3_t* array, u64 size, quantize_error_t* error)
 {
-    if (array == NULL) return error_param_null("array", __FILE__, __LINE__);
+    return serialize_quantized(buffer, format, 3, (const f32*)array, size, error);
+}
+
+err_t serialize_vec4s_quantized(byte** buffer, quantize_format_t format, const vec4_t* array, u64 size, quantize_error_t* error)
+{
+    return serialize_quantized(buffer, format, 4, (const f32*)array, size, error);
+}
+
+err_t serialize_interleaved(byte** buffer, const layout_t* layout, const cmem* arrays, u64 size)
+{
+    if (layout == NULL) return error_param_null("layout", __FILE__, __LINE__);
+    if (arrays == NULL) return error_param_null("arrays", __FILE__, __LINE__);
 
     if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
     if (*buffer != NULL) return error_param_notnull("*buffer", __FILE__, __LINE__);
 
-    err_t err = serialize_size(buffer, size, sizeof(SERIALIZE_TYPE));
+    err_t err = layout_validate(layout);
 
-    if (err > 0) return err;
+    if (err != ERROR_NONE) return err;
 
-    union { SERIALIZE_TYPE element; byte bytes[sizeof(SERIALIZE_TYPE)]; } translator;
+    container_t header;
 
-    // offset pointer to the beginning of the array bytes portion of the buffer
-    byte* array_base_ptr = *buffer + sizeof(u64);
+    // each vertex is stored as stride opaque bytes, the layout table says how to read them
+    err = container_init(&header, CONTAINER_TYPE_U8, layout->stride, size);
+
+    if (err != ERROR_NONE) return err;
+
+    u64 table_size = LAYOUT_TABLE_SIZE(layout->count);
+
+    header.flags |= CONTAINER_FLAG_INTERLEAVED;
+    header.offset = CONTAINER_OFFSET + (table_size + CONTAINER_ALIGNMENT - 1) / CONTAINER_ALIGNMENT * CONTAINER_ALIGNMENT;
+
+    err = buffer_create(buffer, header.offset + header.length);
+
+    if (err != ERROR_NONE) return err;
+
+    memset(*buffer + sizeof(container_t), 0, header.offset - sizeof(container_t));
+
+    container_write(*buffer, &header);
+
+    err = layout_write(*buffer + CONTAINER_OFFSET, layout, header.endianness);
+
+    byte* array_base_ptr = *buffer + header.offset;
+
+    if (err == ERROR_NONE) err = layout_interleave(array_base_ptr, layout, arrays, size);
+
+    // the serialized format is little-endian, so a bigly system swaps each attribute where it landed
+    if (err == ERROR_NONE && endianness_detect() == ENDIAN_BIGLY) err = layout_swap(array_base_ptr, layout, size);
+
+    if (err != ERROR_NONE) buffer_destroy(buffer);
+
+    return err;
+}
+
+err_t serialize_compress(byte** compressed, const byte* buffer, u32 block_size)
+{
+    if (compressed == NULL) return error_param_null("compressed", __FILE__, __LINE__);
+    if (*compressed != NULL) return error_param_notnull("*compressed", __FILE__, __LINE__);
+
+    if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
+
+    container_t header;
+
+    err_t err = container_read(&header, buffer);
+
+    if (err != ERROR_NONE) return err;
 
-    for (u64 i = 0; i < size; ++i)
+    if (header.flags & CONTAINER_FLAG_COMPRESSED) return error_invalid_container("already compressed", __FILE__, __LINE__);
+    if (header.flags & CONTAINER_FLAG_DELTA) return error_invalid_container("delta payload", __FILE__, __LINE__);
+
+    u64 bound = compress_blocks_bound(header.length, block_size);
+
+    // the payload is compressed into a worst-case staging buffer first so the result can be allocated at its exact size
+    byte* staging = (byte*)malloc(bound > 0 ? bound : 1);
+
+    if (staging == NULL) return error_alloc_fail("byte", bound, __FILE__, __LINE__);
+
+    u64 stored = 0;
+
+    // the payload is compressed in the byte order it was written in, so it is swapped after decompression as before
+    err = compress_blocks(staging, &stored, buffer + header.offset, header.length, block_size, serializer_workers);
+
+    if (err == ERROR_NONE)
     {
-        // copy the i-th element from the array into the element of the union
-        memcpy(&translator.element, array + i, sizeof(SERIALIZE_TYPE));
-        // copy the bytes of the union into the byte buffer
-        memcpy(array_base_ptr + i * sizeof(SERIALIZE_TYPE), translator.bytes, sizeof(SERIALIZE_TYPE));
+        header.flags |= CONTAINER_FLAG_COMPRESSED;
+        header.block_size = block_size;
+        header.stored = stored;
+
+        err = buffer_create(compressed, header.offset + header.stored);
     }
 
-    return ERROR_NONE;
+    if (err == ERROR_NONE)
+    {
+        // whatever sits between the header and the payload, such as a layout table, is carried over as it is
+        memcpy(*compressed + sizeof(container_t), buffer + sizeof(container_t), header.offset - sizeof(container_t));
+        memcpy(*compressed + header.offset, staging, stored);
+
+        err = container_write(*compressed, &header);
+    }
+
+    free(staging);
+
+    return err;
 }
 
-#undef SERIALIZE_TYPE
-#define SERIALIZE_TYPE vec4_t
+typedef struct serializer_stream_t
+{
+    FILE* file;
+    container_t header;
+    u64 type_size;
+    // staging buffer holding the little-endian bytes not yet written to the file
+    byte* chunk;
+    u64 chunk_size;
+    u64 chunk_fill;
+    // sticky error from the first failed write, reported again on close
+    err_t err;
+} serializer_stream_t;
+
+/// <summary>
+/// writes bytes to the file of a stream, recording the first failure
+/// </summary>
+/// <param name="stream">- address of the stream</param>
+/// <param name="bytes">- bytes to write</param>
+/// <param name="size">- number of bytes</param>
+/// <returns>ERROR_NONE on success, ERROR_SIZE_MISMATCH on failure</returns>
+static err_t serializer_stream_emit(serializer_stream_t* stream, const byte* bytes, u64 size)
+{
+    if (stream->err != ERROR_NONE) return stream->err;
+
+    u64 written = fwrite(bytes, sizeof(byte), size, stream->file);
 
-err_t serialize_vec4s(byte** buffer, const vec4_t* array, u64 size)
+    if (written != size) stream->err = error_size_mismatch(size, written, __FILE__, __LINE__);
+
+    return stream->err;
+}
+
+err_t serializer_stream_open(serializer_stream_t** stream, cstr path, container_type_t type, u32 components, u64 chunk_size)
 {
-    if (array == NULL) return error_param_null("array", __FILE__, __LINE__);
+    if (stream == NULL) return error_param_null("stream", __FILE__, __LINE__);
+    if (*stream != NULL) return error_param_notnull("*stream", __FILE__, __LINE__);
 
-    if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
-    if (*buffer != NULL) return error_param_notnull("*buffer", __FILE__, __LINE__);
+    if (path == NULL) return error_param_null("path", __FILE__, __LINE__);
 
-    err_t err = serialize_size(buffer, size, sizeof(SERIALIZE_TYPE));
+    container_t header;
 
-    if (err > 0) return err;
+    err_t err = container_init(&header, type, components, 0);
 
-    union { SERIALIZE_TYPE element; byte bytes[sizeof(SERIALIZE_TYPE)]; } translator;
+    if (err != ERROR_NONE) return err;
 
-    // offset pointer to the beginning of the array bytes portion of the buffer
-    byte* array_base_ptr = *buffer + sizeof(u64);
+    if (chunk_size == 0) chunk_size = SERIALIZER_STREAM_CHUNK_SIZE;
+
+    // whole elements per chunk keeps every flush a multiple of the component size for swapping
+    chunk_size -= chunk_size % header.stride;
+
+    if (chunk_size == 0) chunk_size = header.stride;
+
+    *stream = (serializer_stream_t*)malloc(sizeof(serializer_stream_t));
+
+    if (*stream == NULL) return error_alloc_fail("serializer_stream_t", sizeof(serializer_stream_t), __FILE__, __LINE__);
+
+    (*stream)->file = NULL;
+    (*stream)->header = header;
+    (*stream)->type_size = container_type_size(type);
+    (*stream)->chunk = NULL;
+    (*stream)->chunk_size = chunk_size;
+    (*stream)->chunk_fill = 0;
+    (*stream)->err = ERROR_NONE;
+
+    err = buffer_create(&(*stream)->chunk, chunk_size);
+
+    if (err != ERROR_NONE)
+    {
+        free(*stream);
+        *stream = NULL;
+
+        return err;
+    }
+
+    if (fopen_s(&(*stream)->file, path, "wb") != 0)
+    {
+        buffer_destroy(&(*stream)->chunk);
+        free(*stream);
+        *stream = NULL;
+
+        return error_unopenable_file(path, __FILE__, __LINE__);
+    }
+
+    // the staging buffer is the only buffer, so the c runtime should not copy every chunk a second time
+    setvbuf((*stream)->file, NULL, _IONBF, 0);
+
+    // reserve the header and padding up front; the real count is patched in on close
+    byte prefix[CONTAINER_OFFSET];
+
+    memset(prefix, 0, sizeof(prefix));
+    container_write(prefix, &header);
+
+    err = serializer_stream_emit(*stream, prefix, sizeof(prefix));
+
+    if (err != ERROR_NONE)
+    {
+        fclose((*stream)->file);
+        buffer_destroy(&(*stream)->chunk);
+        free(*stream);
+        *stream = NULL;
+
+        return err;
+    }
 
-    for (u64 i = 0; i < size; ++i)
+    return ERROR_NONE;
+}
+
+err_t serializer_stream_write(serializer_stream_t* stream, cmem array, u64 count)
+{
+    if (stream == NULL) return error_param_null("stream", __FILE__, __LINE__);
+    if (array == NULL && count > 0) return error_param_null("array", __FILE__, __LINE__);
+
+    if (stream->err != ERROR_NONE) return stream->err;
+
+    const byte* source = (const byte*)array;
+    u64 remaining = count * stream->header.stride;
+    endian_t endianness = endianness_detect();
+
+    stream->header.count += count;
+    stream->header.length += remaining;
+    stream->header.stored += remaining;
+
+    while (remaining > 0)
     {
-        // copy the i-th element from the array into the element of the union
-        memcpy(&translator.element, array + i, sizeof(SERIALIZE_TYPE));
-        // copy the bytes of the union into the byte buffer
-        memcpy(array_base_ptr + i * sizeof(SERIALIZE_TYPE), translator.bytes, sizeof(SERIALIZE_TYPE));
+        // whole chunks of an already little-endian array skip the staging buffer entirely
+        if (stream->chunk_fill == 0 && endianness == ENDIAN_LITTLE && remaining >= stream->chunk_size)
+        {
+            u64 direct = remaining - remaining % stream->chunk_size;
+
+            if (serializer_stream_emit(stream, source, direct) != ERROR_NONE) return stream->err;
+
+            source += direct;
+            remaining -= direct;
+
+            continue;
+        }
+
+        u64 space = stream->chunk_size - stream->chunk_fill;
+        u64 take = remaining < space ? remaining : space;
+
+        switch (endianness)
+        {
+            case ENDIAN_LITTLE:
+                memcpy(stream->chunk + stream->chunk_fill, source, take);
+                break;
+            case ENDIAN_BIGLY:
+                endian_swap_array(stream->chunk + stream->chunk_fill, source, stream->type_size, take / stream->type_size);
+                break;
+        }
+
+        source += take;
+        remaining -= take;
+        stream->chunk_fill += take;
+
+        if (stream->chunk_fill == stream->chunk_size)
+        {
+            if (serializer_stream_emit(stream, stream->chunk, stream->chunk_fill) != ERROR_NONE) return stream->err;
+
+            stream->chunk_fill = 0;
+        }
     }
 
     return ERROR_NONE;
 }
+
+err_t serializer_stream_close(serializer_stream_t** stream)
+{
+    if (stream == NULL) return error_param_null("stream", __FILE__, __LINE__);
+    if (*stream == NULL) return error_param_null("*stream", __FILE__, __LINE__);
+
+    serializer_stream_t* closing = *stream;
+    *stream = NULL;
+
+    if (closing->chunk_fill > 0) serializer_stream_emit(closing, closing->chunk, closing->chunk_fill);
+
+    if (closing->err == ERROR_NONE)
+    {
+        byte header[sizeof(container_t)];
+
+        container_write(header, &closing->header);
+
+        rewind(closing->file);
+
+        serializer_stream_emit(closing, header, sizeof(header));
+    }
+
+    err_t err = closing->err;
+
+    if (fclose(closing->file) != 0 && err == ERROR_NONE) err = error_uncloseable_file("stream", __FILE__, __LINE__);
+
+    buffer_destroy(&closing->chunk);
+    free(closing);
+
+    return err;
+}
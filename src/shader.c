@@ -7,6 +7,7 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
+#include "allocator.h"
 #include "reader.h"
 
 cstr shader_fetch_name(shader_t type)
@@ -40,6 +41,21 @@ cstr shader_fetch_ext(shader_t type)
 }
 
 err_t path_create(str* path, cstr base, cstr name)
+{
+	return path_create_ex(path, base, name, NULL);
+}
+
+err_t path_append_ext(str* path, cstr base, cstr ext)
+{
+	return path_append_ext_ex(path, base, ext, NULL);
+}
+
+err_t path_destroy(str* path)
+{
+	return path_destroy_ex(path, NULL);
+}
+
+err_t path_create_ex(str* path, cstr base, cstr name, const allocator_t* allocator)
 {
 	if (path == NULL) return error_param_null("path", __FILE__, __LINE__);
 	if (*path != NULL) return error_param_notnull("*path", __FILE__, __LINE__);
@@ -52,9 +68,9 @@ err_t path_create(str* path, cstr base, cstr name)
 
 	u64 full_len = path_len + name_len + 2;
 
-	*path = (str)malloc(full_len);
+	err_t err = allocator_alloc(allocator, (mem*)path, full_len, 1);
 
-	if (*path == NULL) return error_alloc_fail("str", full_len, __FILE__, __LINE__);
+	if (err != ERROR_NONE) return err;
 
 	strcpy_s(*path, full_len, base);
 	strcat_s(*path, full_len, "/");
@@ -63,7 +79,7 @@ err_t path_create(str* path, cstr base, cstr name)
 	return ERROR_NONE;
 }
 
-err_t path_append_ext(str* path, cstr base, cstr ext)
+err_t path_append_ext_ex(str* path, cstr base, cstr ext, const allocator_t* allocator)
 {
 	if (path == NULL) return error_param_null("path", __FILE__, __LINE__);
 	if (*path != NULL) return error_param_notnull("*path", __FILE__, __LINE__);
@@ -76,9 +92,9 @@ err_t path_append_ext(str* path, cstr base, cstr ext)
 
 	u64 path_len = base_len + ext_len + 1;
 
-	*path = (str)malloc(path_len);
+	err_t err = allocator_alloc(allocator, (mem*)path, path_len, 1);
 
-	if (*path == NULL) return error_alloc_fail("str", path_len, __FILE__, __LINE__);
+	if (err != ERROR_NONE) return err;
 
 	strcpy_s(*path, path_len, base);
 	strcat_s(*path, path_len, ext);
@@ -86,15 +102,12 @@ err_t path_append_ext(str* path, cstr base, cstr ext)
 	return ERROR_NONE;
 }
 
-err_t path_destroy(str* path)
+err_t path_destroy_ex(str* path, const allocator_t* allocator)
 {
 	if (path == NULL) return error_param_null("path", __FILE__, __LINE__);
 	if (*path == NULL) return error_param_null("*path", __FILE__, __LINE__);
 
-	free(*path);
-	*path = NULL;
-
-	return ERROR_NONE;
+	return allocator_free(allocator, (mem*)path);
 }
 
 err_t program_load(cstr path, cstr name, u32* program, shader_t type)
@@ -122,13 +135,11 @@ err_t program_load(cstr path, cstr name, u32* program, shader_t type)
 
 		shader_create(&shaders[i], current);
 
-		if (err = shader_load(partial_path, &shaders[i], current) != ERROR_NONE)
+		if ((err = shader_load(partial_path, &shaders[i], current)) != ERROR_NONE)
 		{
-			for (; i > 0; --i)
+			for (; i >= 0; --i)
 			{
-				shader_t current = (shader_t)1 << i;
-
-				if ((type & current) == 0) continue;
+				if (shaders[i] == 0) continue;
 
 				glDeleteShader(shaders[i]);
 				shaders[i] = 0;
@@ -137,6 +148,9 @@ err_t program_load(cstr path, cstr name, u32* program, shader_t type)
 			path_destroy(&partial_path);
 			glDeleteProgram(*program);
 
+			// the handle is cleared so the caller never holds a deleted program
+			*program = 0;
+
 			return err;
 		}
 
@@ -164,12 +178,34 @@ err_t program_load(cstr path, cstr name, u32* program, shader_t type)
 	if (!success)
 	{
 		glGetProgramInfoLog(*program, LOG_SIZE, NULL, infoLog);
+
+		glDeleteProgram(*program);
+		*program = 0;
+
 		return error_shader_link_fail(infoLog, __FILE__, __LINE__);
 	}
 
 	return 0;
 }
 
+err_t program_reload(cstr path, cstr name, u32* program, shader_t type)
+{
+	if (program == NULL) return error_param_null("program", __FILE__, __LINE__);
+
+	// the new program is built beside the old one, which stays bound and usable if it fails to compile or link
+	u32 reloaded = 0;
+
+	err_t err = program_load(path, name, &reloaded, type);
+
+	if (err != ERROR_NONE) return err;
+
+	if (*program != 0) glDeleteProgram(*program);
+
+	*program = reloaded;
+
+	return ERROR_NONE;
+}
+
 void program_delete(u32 program)
 {
 	glDeleteProgram(program);
@@ -199,9 +235,10 @@ err_t shader_load(cstr path, u32* shader, shader_t type)
 
 	if (err = path_append_ext(&full_path, path, shader_fetch_ext(type)) != ERROR_NONE) return err;
 
-	char* contents = NULL;
+	// the source is read into the scratch buffer of this thread, which outlives the call to glShaderSource
+	reader_view_t contents;
 
-	if (err = reader_string(full_path, &contents) != ERROR_NONE)
+	if ((err = reader_text_scratch(full_path, &contents)) != ERROR_NONE)
 	{
 		path_destroy(&full_path);
 
@@ -210,11 +247,10 @@ err_t shader_load(cstr path, u32* shader, shader_t type)
 
 	path_destroy(&full_path);
 
-	glShaderSource(*shader, 1, &contents, NULL);
-	glCompileShader(*shader);
+	GLint length = (GLint)contents.size;
 
-	free(contents);
-	contents = NULL;
+	glShaderSource(*shader, 1, &contents.data, &length);
+	glCompileShader(*shader);
 
 	int success;
 	char infoLog[LOG_SIZE];
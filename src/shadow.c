@@ -0,0 +1,198 @@
+#include "shadow.h"
+
+#include <GL/glew.h>
+
+#include "buffer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/// <summary>bytes from start up to but not including end that differ from the buffer object</summary>
+typedef struct shadow_range_t
+{
+	u64 start;
+	u64 end;
+} shadow_range_t;
+
+typedef struct shadow_t
+{
+	u32 buffer;
+	u32 target;
+	byte* data;
+	u64 count;
+	u64 stride;
+	// sorted and apart from each other, with room for one more before the closest two are merged
+	shadow_range_t ranges[SHADOW_RANGES + 1];
+	u32 range_count;
+} shadow_t;
+
+/// <summary>
+/// adds a changed byte range, merging it with every range it overlaps or touches
+/// </summary>
+/// <param name="shadow">- address of the shadow</param>
+/// <param name="start">- first changed byte</param>
+/// <param name="end">- byte past the last changed one</param>
+static void shadow_range_add(shadow_t* shadow, u64 start, u64 end)
+{
+	shadow_range_t* ranges = shadow->ranges;
+
+	u32 first = 0;
+
+	while (first < shadow->range_count && ranges[first].end < start) ++first;
+
+	u32 last = first;
+
+	while (last < shadow->range_count && ranges[last].start <= end)
+	{
+		if (ranges[last].start < start) start = ranges[last].start;
+		if (ranges[last].end > end) end = ranges[last].end;
+
+		++last;
+	}
+
+	// the merged ranges from first up to last are replaced by the one range covering them
+	memmove(&ranges[first + 1], &ranges[last], (shadow->range_count - last) * sizeof(shadow_range_t));
+
+	shadow->range_count = shadow->range_count + 1 - (last - first);
+
+	ranges[first].start = start;
+	ranges[first].end = end;
+
+	if (shadow->range_count <= SHADOW_RANGES) return;
+
+	// too many scattered edits, so the two closest are sent together with the clean bytes between them
+	u32 closest = 0;
+
+	for (u32 i = 1; i + 1 < shadow->range_count; ++i)
+	{
+		if (ranges[i + 1].start - ranges[i].end < ranges[closest + 1].start - ranges[closest].end) closest = i;
+	}
+
+	ranges[closest].end = ranges[closest + 1].end;
+
+	memmove(&ranges[closest + 1], &ranges[closest + 2], (shadow->range_count - closest - 2) * sizeof(shadow_range_t));
+
+	--shadow->range_count;
+}
+
+err_t shadow_create(shadow_t** shadow, u32 target, cmem data, u64 count, u64 stride, u32 mode)
+{
+	if (shadow == NULL) return error_param_null("shadow", __FILE__, __LINE__);
+	if (*shadow != NULL) return error_param_notnull("*shadow", __FILE__, __LINE__);
+
+	if (stride == 0) return error_param_null("stride", __FILE__, __LINE__);
+
+	if (buffer_draw_mode_valid(mode) != DRAW_MODE_VALID) return error_invalid_enum("mode", mode, __FILE__, __LINE__);
+
+	shadow_t* creating = (shadow_t*)calloc(1, sizeof(shadow_t));
+
+	if (creating == NULL) return error_alloc_fail("shadow_t", sizeof(shadow_t), __FILE__, __LINE__);
+
+	u64 size = count * stride;
+
+	creating->data = (byte*)malloc(size > 0 ? size : 1);
+
+	if (creating->data == NULL)
+	{
+		free(creating);
+
+		return error_alloc_fail("byte", size, __FILE__, __LINE__);
+	}
+
+	if (data != NULL) memcpy(creating->data, data, size);
+	else memset(creating->data, 0, size);
+
+	creating->target = target;
+	creating->count = count;
+	creating->stride = stride;
+
+	glGenBuffers(1, &creating->buffer);
+
+	glBindBuffer(target, creating->buffer);
+	glBufferData(target, size, creating->data, mode);
+
+	*shadow = creating;
+
+	return ERROR_NONE;
+}
+
+mem shadow_data(shadow_t* shadow)
+{
+	if (shadow == NULL) return NULL;
+
+	return shadow->data;
+}
+
+err_t shadow_mark(shadow_t* shadow, u64 first, u64 count)
+{
+	if (shadow == NULL) return error_param_null("shadow", __FILE__, __LINE__);
+
+	if (first > shadow->count || count > shadow->count - first) return error_size_mismatch(first + count, shadow->count, __FILE__, __LINE__);
+
+	if (count == 0) return ERROR_NONE;
+
+	shadow_range_add(shadow, first * shadow->stride, (first + count) * shadow->stride);
+
+	return ERROR_NONE;
+}
+
+err_t shadow_write(shadow_t* shadow, u64 first, cmem data, u64 count)
+{
+	if (shadow == NULL) return error_param_null("shadow", __FILE__, __LINE__);
+	if (data == NULL) return error_param_null("data", __FILE__, __LINE__);
+
+	if (first > shadow->count || count > shadow->count - first) return error_size_mismatch(first + count, shadow->count, __FILE__, __LINE__);
+
+	memcpy(shadow->data + first * shadow->stride, data, count * shadow->stride);
+
+	return shadow_mark(shadow, first, count);
+}
+
+err_t shadow_flush(shadow_t* shadow, u64* uploaded)
+{
+	if (shadow == NULL) return error_param_null("shadow", __FILE__, __LINE__);
+
+	u64 total = 0;
+
+	if (shadow->range_count > 0) glBindBuffer(shadow->target, shadow->buffer);
+
+	for (u32 i = 0; i < shadow->range_count;)
+	{
+		u64 start = shadow->ranges[i].start;
+		u64 end = shadow->ranges[i].end;
+
+		for (++i; i < shadow->range_count && shadow->ranges[i].start - end < SHADOW_GAP; ++i) end = shadow->ranges[i].end;
+
+		glBufferSubData(shadow->target, start, end - start, shadow->data + start);
+
+		total += end - start;
+	}
+
+	shadow->range_count = 0;
+
+	if (uploaded != NULL) *uploaded = total;
+
+	return ERROR_NONE;
+}
+
+u32 shadow_buffer(shadow_t* shadow)
+{
+	if (shadow == NULL) return 0;
+
+	return shadow->buffer;
+}
+
+err_t shadow_destroy(shadow_t** shadow)
+{
+	if (shadow == NULL) return error_param_null("shadow", __FILE__, __LINE__);
+	if (*shadow == NULL) return error_param_null("*shadow", __FILE__, __LINE__);
+
+	glDeleteBuffers(1, &(*shadow)->buffer);
+
+	free((*shadow)->data);
+	free(*shadow);
+
+	*shadow = NULL;
+
+	return ERROR_NONE;
+}
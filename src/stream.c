@@ -0,0 +1,203 @@
+#include "stream.h"
+
+#include <GL/glew.h>
+
+#include <stdlib.h>
+
+typedef struct stream_t
+{
+	u32 buffer;
+	u32 target;
+	// bytes of each region
+	u64 size;
+	// region of the current frame, and bytes allocated out of it
+	u32 region;
+	u64 offset;
+	// bytes of the current frame already handed to the gpu
+	u64 flushed;
+	// the whole mapped buffer when persistent, or a staging copy of one region otherwise
+	byte* mapped;
+	i32 persistent;
+	// fence of each region, set once its frame is ended and deleted once waited on
+	GLsync fences[STREAM_REGIONS];
+} stream_t;
+
+/// <summary>
+/// waits for the gpu to pass the fence of a region, then deletes it
+/// </summary>
+/// <param name="stream">- address of the stream</param>
+/// <param name="region">- index of the region</param>
+static void stream_wait(stream_t* stream, u32 region)
+{
+	if (stream->fences[region] == NULL) return;
+
+	// the first wait does not flush, as the fence was usually passed long ago
+	GLbitfield flags = 0;
+
+	forever
+	{
+		GLenum status = glClientWaitSync(stream->fences[region], flags, STREAM_TIMEOUT);
+
+		if (status != GL_TIMEOUT_EXPIRED) break;
+
+		flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+	}
+
+	glDeleteSync(stream->fences[region]);
+
+	stream->fences[region] = NULL;
+}
+
+err_t stream_create(stream_t** stream, u32 target, u64 size)
+{
+	if (stream == NULL) return error_param_null("stream", __FILE__, __LINE__);
+	if (*stream != NULL) return error_param_notnull("*stream", __FILE__, __LINE__);
+
+	if (size == 0) return error_param_null("size", __FILE__, __LINE__);
+
+	stream_t* creating = (stream_t*)calloc(1, sizeof(stream_t));
+
+	if (creating == NULL) return error_alloc_fail("stream_t", sizeof(stream_t), __FILE__, __LINE__);
+
+	creating->target = target;
+	creating->size = size;
+
+	// the first frame begins by moving to the first region
+	creating->region = STREAM_REGIONS - 1;
+
+	glGenBuffers(1, &creating->buffer);
+	glBindBuffer(target, creating->buffer);
+
+	if (GLEW_ARB_buffer_storage)
+	{
+		// the mapping stays valid while the gpu draws from it, and coherent writes need no flush; the fences alone keep both sides apart
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		glBufferStorage(target, size * STREAM_REGIONS, NULL, flags);
+
+		creating->mapped = (byte*)glMapBufferRange(target, 0, size * STREAM_REGIONS, flags);
+		creating->persistent = true;
+
+		if (creating->mapped == NULL)
+		{
+			glDeleteBuffers(1, &creating->buffer);
+			free(creating);
+
+			return error_unmappable_buffer("stream", __FILE__, __LINE__);
+		}
+	}
+	else
+	{
+		// without buffer storage, each frame is written to memory and copied into its region when flushed
+		glBufferData(target, size * STREAM_REGIONS, NULL, GL_STREAM_DRAW);
+
+		creating->mapped = (byte*)malloc(size);
+
+		if (creating->mapped == NULL)
+		{
+			glDeleteBuffers(1, &creating->buffer);
+			free(creating);
+
+			return error_alloc_fail("byte", size, __FILE__, __LINE__);
+		}
+	}
+
+	*stream = creating;
+
+	return ERROR_NONE;
+}
+
+err_t stream_begin(stream_t* stream)
+{
+	if (stream == NULL) return error_param_null("stream", __FILE__, __LINE__);
+
+	stream->region = (stream->region + 1) % STREAM_REGIONS;
+	stream->offset = 0;
+	stream->flushed = 0;
+
+	// with three regions this only blocks when the gpu is more than two frames behind
+	stream_wait(stream, stream->region);
+
+	return ERROR_NONE;
+}
+
+err_t stream_alloc(stream_t* stream, u64 size, u64 alignment, mem* pointer, u64* offset)
+{
+	if (stream == NULL) return error_param_null("stream", __FILE__, __LINE__);
+	if (pointer == NULL) return error_param_null("pointer", __FILE__, __LINE__);
+	if (offset == NULL) return error_param_null("offset", __FILE__, __LINE__);
+
+	u64 start = stream->offset;
+
+	if (alignment > 1) start = (start + alignment - 1) / alignment * alignment;
+
+	if (start > stream->size || size > stream->size - start) return error_queue_full("stream", __FILE__, __LINE__);
+
+	u64 base = (u64)stream->region * stream->size;
+
+	*pointer = stream->persistent ? stream->mapped + base + start : stream->mapped + start;
+	*offset = base + start;
+
+	stream->offset = start + size;
+
+	return ERROR_NONE;
+}
+
+err_t stream_flush(stream_t* stream)
+{
+	if (stream == NULL) return error_param_null("stream", __FILE__, __LINE__);
+
+	if (stream->persistent || stream->flushed == stream->offset) return ERROR_NONE;
+
+	u64 base = (u64)stream->region * stream->size;
+
+	glBindBuffer(stream->target, stream->buffer);
+	glBufferSubData(stream->target, base + stream->flushed, stream->offset - stream->flushed, stream->mapped + stream->flushed);
+
+	stream->flushed = stream->offset;
+
+	return ERROR_NONE;
+}
+
+err_t stream_end(stream_t* stream)
+{
+	if (stream == NULL) return error_param_null("stream", __FILE__, __LINE__);
+
+	stream_flush(stream);
+
+	stream->fences[stream->region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	return ERROR_NONE;
+}
+
+u32 stream_buffer(stream_t* stream)
+{
+	if (stream == NULL) return 0;
+
+	return stream->buffer;
+}
+
+err_t stream_destroy(stream_t** stream)
+{
+	if (stream == NULL) return error_param_null("stream", __FILE__, __LINE__);
+	if (*stream == NULL) return error_param_null("*stream", __FILE__, __LINE__);
+
+	stream_t* destroying = *stream;
+
+	for (u32 i = 0; i < STREAM_REGIONS; ++i) stream_wait(destroying, i);
+
+	if (destroying->persistent)
+	{
+		glBindBuffer(destroying->target, destroying->buffer);
+		glUnmapBuffer(destroying->target);
+	}
+	else free(destroying->mapped);
+
+	glDeleteBuffers(1, &destroying->buffer);
+
+	free(destroying);
+
+	*stream = NULL;
+
+	return ERROR_NONE;
+}
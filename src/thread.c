@@ -0,0 +1,260 @@
+#include "thread.h"
+
+#include <stdlib.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+typedef struct thread_t
+{
+#ifdef _WIN32
+	HANDLE handle;
+#else
+	pthread_t handle;
+#endif
+	thread_proc_t proc;
+	ptr user;
+	err_t result;
+} thread_t;
+
+typedef struct mutex_t
+{
+#ifdef _WIN32
+	SRWLOCK lock;
+#else
+	pthread_mutex_t lock;
+#endif
+} mutex_t;
+
+typedef struct condition_t
+{
+#ifdef _WIN32
+	CONDITION_VARIABLE variable;
+#else
+	pthread_cond_t variable;
+#endif
+} condition_t;
+
+#ifdef _WIN32
+static DWORD WINAPI thread_entry(LPVOID parameter)
+#else
+static void* thread_entry(void* parameter)
+#endif
+{
+	thread_t* thread = (thread_t*)parameter;
+
+	thread->result = thread->proc(thread->user);
+
+#ifdef _WIN32
+	return 0;
+#else
+	return NULL;
+#endif
+}
+
+err_t thread_create(thread_t** thread, thread_proc_t proc, ptr user)
+{
+	if (thread == NULL) return error_param_null("thread", __FILE__, __LINE__);
+	if (*thread != NULL) return error_param_notnull("*thread", __FILE__, __LINE__);
+
+	if (proc == NULL) return error_param_null("proc", __FILE__, __LINE__);
+
+	thread_t* starting = (thread_t*)malloc(sizeof(thread_t));
+
+	if (starting == NULL) return error_alloc_fail("thread_t", sizeof(thread_t), __FILE__, __LINE__);
+
+	starting->proc = proc;
+	starting->user = user;
+	starting->result = ERROR_NONE;
+
+#ifdef _WIN32
+	starting->handle = CreateThread(NULL, 0, thread_entry, starting, 0, NULL);
+
+	if (starting->handle == NULL)
+#else
+	if (pthread_create(&starting->handle, NULL, thread_entry, starting) != 0)
+#endif
+	{
+		free(starting);
+
+		return error_thread_fail("create a thread", __FILE__, __LINE__);
+	}
+
+	*thread = starting;
+
+	return ERROR_NONE;
+}
+
+err_t thread_join(thread_t** thread, err_t* result)
+{
+	if (thread == NULL) return error_param_null("thread", __FILE__, __LINE__);
+	if (*thread == NULL) return error_param_null("*thread", __FILE__, __LINE__);
+
+#ifdef _WIN32
+	i32 joined = WaitForSingleObject((*thread)->handle, INFINITE) == WAIT_OBJECT_0;
+
+	CloseHandle((*thread)->handle);
+#else
+	i32 joined = pthread_join((*thread)->handle, NULL) == 0;
+#endif
+
+	if (result != NULL) *result = (*thread)->result;
+
+	free(*thread);
+	*thread = NULL;
+
+	return joined ? ERROR_NONE : error_thread_fail("join a thread", __FILE__, __LINE__);
+}
+
+err_t mutex_create(mutex_t** mutex)
+{
+	if (mutex == NULL) return error_param_null("mutex", __FILE__, __LINE__);
+	if (*mutex != NULL) return error_param_notnull("*mutex", __FILE__, __LINE__);
+
+	mutex_t* creating = (mutex_t*)malloc(sizeof(mutex_t));
+
+	if (creating == NULL) return error_alloc_fail("mutex_t", sizeof(mutex_t), __FILE__, __LINE__);
+
+#ifdef _WIN32
+	InitializeSRWLock(&creating->lock);
+#else
+	if (pthread_mutex_init(&creating->lock, NULL) != 0)
+	{
+		free(creating);
+
+		return error_thread_fail("create a mutex", __FILE__, __LINE__);
+	}
+#endif
+
+	*mutex = creating;
+
+	return ERROR_NONE;
+}
+
+err_t mutex_destroy(mutex_t** mutex)
+{
+	if (mutex == NULL) return error_param_null("mutex", __FILE__, __LINE__);
+	if (*mutex == NULL) return error_param_null("*mutex", __FILE__, __LINE__);
+
+#ifndef _WIN32
+	pthread_mutex_destroy(&(*mutex)->lock);
+#endif
+
+	free(*mutex);
+	*mutex = NULL;
+
+	return ERROR_NONE;
+}
+
+void mutex_lock(mutex_t* mutex)
+{
+#ifdef _WIN32
+	AcquireSRWLockExclusive(&mutex->lock);
+#else
+	pthread_mutex_lock(&mutex->lock);
+#endif
+}
+
+void mutex_unlock(mutex_t* mutex)
+{
+#ifdef _WIN32
+	ReleaseSRWLockExclusive(&mutex->lock);
+#else
+	pthread_mutex_unlock(&mutex->lock);
+#endif
+}
+
+err_t condition_create(condition_t** condition)
+{
+	if (condition == NULL) return error_param_null("condition", __FILE__, __LINE__);
+	if (*condition != NULL) return error_param_notnull("*condition", __FILE__, __LINE__);
+
+	condition_t* creating = (condition_t*)malloc(sizeof(condition_t));
+
+	if (creating == NULL) return error_alloc_fail("condition_t", sizeof(condition_t), __FILE__, __LINE__);
+
+#ifdef _WIN32
+	InitializeConditionVariable(&creating->variable);
+#else
+	if (pthread_cond_init(&creating->variable, NULL) != 0)
+	{
+		free(creating);
+
+		return error_thread_fail("create a condition", __FILE__, __LINE__);
+	}
+#endif
+
+	*condition = creating;
+
+	return ERROR_NONE;
+}
+
+err_t condition_destroy(condition_t** condition)
+{
+	if (condition == NULL) return error_param_null("condition", __FILE__, __LINE__);
+	if (*condition == NULL) return error_param_null("*condition", __FILE__, __LINE__);
+
+#ifndef _WIN32
+	pthread_cond_destroy(&(*condition)->variable);
+#endif
+
+	free(*condition);
+	*condition = NULL;
+
+	return ERROR_NONE;
+}
+
+void condition_wait(condition_t* condition, mutex_t* mutex)
+{
+#ifdef _WIN32
+	SleepConditionVariableSRW(&condition->variable, &mutex->lock, INFINITE, 0);
+#else
+	pthread_cond_wait(&condition->variable, &mutex->lock);
+#endif
+}
+
+void condition_signal(condition_t* condition)
+{
+#ifdef _WIN32
+	WakeConditionVariable(&condition->variable);
+#else
+	pthread_cond_signal(&condition->variable);
+#endif
+}
+
+void condition_broadcast(condition_t* condition)
+{
+#ifdef _WIN32
+	WakeAllConditionVariable(&condition->variable);
+#else
+	pthread_cond_broadcast(&condition->variable);
+#endif
+}
+
+u32 thread_concurrency()
+{
+	static u32 concurrency = 0;
+
+	if (concurrency != 0) return concurrency;
+
+#ifdef _WIN32
+	SYSTEM_INFO info;
+
+	GetSystemInfo(&info);
+
+	concurrency = info.dwNumberOfProcessors;
+#else
+	long processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+	concurrency = processors > 0 ? (u32)processors : 1;
+#endif
+
+	if (concurrency == 0) concurrency = 1;
+
+	return concurrency;
+}
@@ -0,0 +1,292 @@
+#include "vao.h"
+
+#include <GL/glew.h>
+
+#include "layout.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define VAO_FNV_OFFSET 14695981039346656037ull
+#define VAO_FNV_PRIME 1099511628211ull
+
+/// <summary>what a vertex array was built from, zeroed past the bindings in use so keys compare bytewise</summary>
+typedef struct vao_key_t
+{
+	u64 layouts[VAO_BINDINGS_MAX];
+	u64 offsets[VAO_BINDINGS_MAX];
+	u32 buffers[VAO_BINDINGS_MAX];
+	u32 count;
+	u32 elements;
+} vao_key_t;
+
+typedef struct vao_entry_t
+{
+	vao_key_t key;
+	u64 hash;
+	u32 vao;
+} vao_entry_t;
+
+typedef struct vao_cache_t
+{
+	vao_entry_t* entries;
+	u32 count;
+	u32 capacity;
+
+	// open addressed table of entry indices plus one, 0 for an empty slot, a power of two at least twice the count
+	u32* table;
+	u32 table_size;
+} vao_cache_t;
+
+/// <summary>
+/// folds the bytes of a value into an fnv-1a hash
+/// </summary>
+/// <param name="hash">- hash so far</param>
+/// <param name="value">- value to fold in</param>
+/// <returns>the updated hash</returns>
+static u64 vao_hash_u64(u64 hash, u64 value)
+{
+	for (u32 i = 0; i < 8; ++i)
+	{
+		hash ^= (value >> (i * 8)) & 0xFF;
+		hash *= VAO_FNV_PRIME;
+	}
+
+	return hash;
+}
+
+/// <summary>
+/// builds the key of a set of bindings and hashes it
+/// </summary>
+/// <param name="key">- address of the key</param>
+/// <param name="bindings">- vertex buffers and their layouts</param>
+/// <param name="count">- number of bindings</param>
+/// <param name="elements">- element buffer, or 0 for none</param>
+/// <param name="hash">- address of the hash of the key</param>
+/// <returns>ERROR_NONE on success, ERROR_PARAM_NULL or ERROR_SIZE_MISMATCH on failure</returns>
+static err_t vao_key_build(vao_key_t* key, const vao_binding_t* bindings, u32 count, u32 elements, u64* hash)
+{
+	if (bindings == NULL) return error_param_null("bindings", __FILE__, __LINE__);
+
+	if (count == 0 || count > VAO_BINDINGS_MAX) return error_size_mismatch(count, VAO_BINDINGS_MAX, __FILE__, __LINE__);
+
+	memset(key, 0, sizeof(vao_key_t));
+
+	key->count = count;
+	key->elements = elements;
+
+	*hash = vao_hash_u64(VAO_FNV_OFFSET, ((u64)count << 32) | elements);
+
+	for (u32 i = 0; i < count; ++i)
+	{
+		if (bindings[i].layout == NULL) return error_param_null("layout", __FILE__, __LINE__);
+
+		// layouts are keyed by their contents, so equal layouts stored apart share vertex arrays
+		key->layouts[i] = layout_hash(bindings[i].layout);
+		key->offsets[i] = bindings[i].offset;
+		key->buffers[i] = bindings[i].buffer;
+
+		*hash = vao_hash_u64(*hash, key->layouts[i]);
+		*hash = vao_hash_u64(*hash, key->offsets[i]);
+		*hash = vao_hash_u64(*hash, key->buffers[i]);
+	}
+
+	return ERROR_NONE;
+}
+
+/// <summary>
+/// rebuilds the table from the entries, sized for one more entry than there are
+/// </summary>
+/// <param name="cache">- address of the cache</param>
+/// <returns>ERROR_NONE on success, ERROR_ALLOC_FAIL on failure</returns>
+static err_t vao_table_build(vao_cache_t* cache)
+{
+	u32 size = cache->table_size > 0 ? cache->table_size : 16;
+
+	while (size < (cache->count + 1) * 2) size *= 2;
+
+	if (size != cache->table_size)
+	{
+		u32* table = (u32*)realloc(cache->table, size * sizeof(u32));
+
+		if (table == NULL) return error_alloc_fail("u32", size * sizeof(u32), __FILE__, __LINE__);
+
+		cache->table = table;
+		cache->table_size = size;
+	}
+
+	memset(cache->table, 0, cache->table_size * sizeof(u32));
+
+	for (u32 i = 0; i < cache->count; ++i)
+	{
+		u32 slot = (u32)cache->entries[i].hash & (cache->table_size - 1);
+
+		while (cache->table[slot] != 0) slot = (slot + 1) & (cache->table_size - 1);
+
+		cache->table[slot] = i + 1;
+	}
+
+	return ERROR_NONE;
+}
+
+err_t vao_cache_create(vao_cache_t** cache)
+{
+	if (cache == NULL) return error_param_null("cache", __FILE__, __LINE__);
+	if (*cache != NULL) return error_param_notnull("*cache", __FILE__, __LINE__);
+
+	vao_cache_t* creating = (vao_cache_t*)calloc(1, sizeof(vao_cache_t));
+
+	if (creating == NULL) return error_alloc_fail("vao_cache_t", sizeof(vao_cache_t), __FILE__, __LINE__);
+
+	err_t err = vao_table_build(creating);
+
+	if (err != ERROR_NONE)
+	{
+		free(creating);
+
+		return err;
+	}
+
+	*cache = creating;
+
+	return ERROR_NONE;
+}
+
+err_t vao_fetch(vao_cache_t* cache, const vao_binding_t* bindings, u32 count, u32 elements, u32* vao)
+{
+	if (cache == NULL) return error_param_null("cache", __FILE__, __LINE__);
+	if (vao == NULL) return error_param_null("vao", __FILE__, __LINE__);
+
+	vao_key_t key;
+	u64 hash;
+
+	err_t err = vao_key_build(&key, bindings, count, elements, &hash);
+
+	if (err != ERROR_NONE) return err;
+
+	u32 slot = (u32)hash & (cache->table_size - 1);
+
+	for (; cache->table[slot] != 0; slot = (slot + 1) & (cache->table_size - 1))
+	{
+		const vao_entry_t* entry = &cache->entries[cache->table[slot] - 1];
+
+		if (entry->hash != hash || memcmp(&entry->key, &key, sizeof(vao_key_t)) != 0) continue;
+
+		*vao = entry->vao;
+
+		return ERROR_NONE;
+	}
+
+	// room is made before the vertex array exists, so a failed allocation leaves nothing to delete
+	if (cache->count == cache->capacity)
+	{
+		u32 capacity = cache->capacity > 0 ? cache->capacity * 2 : 16;
+
+		vao_entry_t* entries = (vao_entry_t*)realloc(cache->entries, capacity * sizeof(vao_entry_t));
+
+		if (entries == NULL) return error_alloc_fail("vao_entry_t", capacity * sizeof(vao_entry_t), __FILE__, __LINE__);
+
+		cache->entries = entries;
+		cache->capacity = capacity;
+	}
+
+	if ((cache->count + 1) * 2 > cache->table_size)
+	{
+		if ((err = vao_table_build(cache)) != ERROR_NONE) return err;
+
+		for (slot = (u32)hash & (cache->table_size - 1); cache->table[slot] != 0;) slot = (slot + 1) & (cache->table_size - 1);
+	}
+
+	u32 building = 0;
+
+	glGenVertexArrays(1, &building);
+	glBindVertexArray(building);
+
+	for (u32 i = 0; i < count && err == ERROR_NONE; ++i)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, bindings[i].buffer);
+
+		err = layout_apply(bindings[i].layout, bindings[i].offset);
+	}
+
+	// the element buffer binding is part of the vertex array state, unlike the array buffer binding
+	if (err == ERROR_NONE) glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elements);
+
+	glBindVertexArray(0);
+
+	if (err != ERROR_NONE)
+	{
+		glDeleteVertexArrays(1, &building);
+
+		return err;
+	}
+
+	vao_entry_t* entry = &cache->entries[cache->count];
+
+	entry->key = key;
+	entry->hash = hash;
+	entry->vao = building;
+
+	cache->table[slot] = ++cache->count;
+
+	*vao = building;
+
+	return ERROR_NONE;
+}
+
+err_t vao_bind(vao_cache_t* cache, const vao_binding_t* bindings, u32 count, u32 elements)
+{
+	u32 vao = 0;
+
+	err_t err = vao_fetch(cache, bindings, count, elements, &vao);
+
+	if (err != ERROR_NONE) return err;
+
+	glBindVertexArray(vao);
+
+	return ERROR_NONE;
+}
+
+err_t vao_forget(vao_cache_t* cache, u32 buffer)
+{
+	if (cache == NULL) return error_param_null("cache", __FILE__, __LINE__);
+
+	u32 kept = 0;
+
+	for (u32 i = 0; i < cache->count; ++i)
+	{
+		vao_entry_t* entry = &cache->entries[i];
+
+		i32 reads = entry->key.elements == buffer;
+
+		for (u32 j = 0; j < entry->key.count && !reads; ++j) reads = entry->key.buffers[j] == buffer;
+
+		if (reads) glDeleteVertexArrays(1, &entry->vao);
+		else cache->entries[kept++] = *entry;
+	}
+
+	if (kept == cache->count) return ERROR_NONE;
+
+	cache->count = kept;
+
+	// the table only shrinks in use, so rebuilding it in place never allocates
+	return vao_table_build(cache);
+}
+
+err_t vao_cache_destroy(vao_cache_t** cache)
+{
+	if (cache == NULL) return error_param_null("cache", __FILE__, __LINE__);
+	if (*cache == NULL) return error_param_null("*cache", __FILE__, __LINE__);
+
+	vao_cache_t* destroying = *cache;
+
+	for (u32 i = 0; i < destroying->count; ++i) glDeleteVertexArrays(1, &destroying->entries[i].vao);
+
+	free(destroying->entries);
+	free(destroying->table);
+	free(destroying);
+
+	*cache = NULL;
+
+	return ERROR_NONE;
+}
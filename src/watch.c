@@ -0,0 +1,316 @@
+#include "watch.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+/// <summary>one watched file and when it last changed</summary>
+typedef struct watch_entry_t
+{
+	str path;
+	// name of the file inside its directory, pointing into the path
+	cstr name;
+	watch_callback_t callback;
+	ptr user;
+	// inotify descriptor of the directory, or -1 when the file is polled
+	i32 descriptor;
+	// modification time and size seen by the last poll
+	i64 modified;
+	i64 size;
+	// clock reading of the last change not yet reported, or 0
+	u64 changed;
+} watch_entry_t;
+
+typedef struct watch_t
+{
+	watch_entry_t* entries;
+	u32 count;
+	u32 capacity;
+
+	u32 debounce;
+	// clock reading of the last modification time poll
+	u64 scanned;
+	// inotify instance, or -1 when every file is polled
+	i32 notify;
+} watch_t;
+
+/// <summary>
+/// fetches a monotonic clock in milliseconds
+/// </summary>
+/// <returns>milliseconds since an arbitrary point, never 0</returns>
+static u64 watch_clock()
+{
+#ifdef _WIN32
+	return (u64)GetTickCount64() + 1;
+#else
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (u64)now.tv_sec * 1000 + (u64)now.tv_nsec / 1000000 + 1;
+#endif
+}
+
+/// <summary>
+/// fetches the modification time and size of a file
+/// </summary>
+/// <param name="path">- path of the file</param>
+/// <param name="modified">- address of the modification time, 0 if the file is missing</param>
+/// <param name="size">- address of the size, -1 if the file is missing</param>
+static void watch_stamp(cstr path, i64* modified, i64* size)
+{
+#ifdef _WIN32
+	// the write time is kept in 100 nanosecond steps, so two saves within a second still differ
+	WIN32_FILE_ATTRIBUTE_DATA info;
+
+	if (GetFileAttributesExA(path, GetFileExInfoStandard, &info))
+	{
+		*modified = (i64)(((u64)info.ftLastWriteTime.dwHighDateTime << 32) | info.ftLastWriteTime.dwLowDateTime);
+		*size = (i64)(((u64)info.nFileSizeHigh << 32) | info.nFileSizeLow);
+
+		return;
+	}
+#else
+	struct stat info;
+
+	if (stat(path, &info) == 0)
+	{
+		*modified = (i64)info.st_mtime;
+		*size = (i64)info.st_size;
+
+		return;
+	}
+#endif
+
+	// a file being replaced is briefly missing, which counts as a change once it is back
+	*modified = 0;
+	*size = -1;
+}
+
+err_t watch_create(watch_t** watch, u32 debounce)
+{
+	if (watch == NULL) return error_param_null("watch", __FILE__, __LINE__);
+	if (*watch != NULL) return error_param_notnull("*watch", __FILE__, __LINE__);
+
+	watch_t* creating = (watch_t*)calloc(1, sizeof(watch_t));
+
+	if (creating == NULL) return error_alloc_fail("watch_t", sizeof(watch_t), __FILE__, __LINE__);
+
+	creating->debounce = debounce != 0 ? debounce : WATCH_DEBOUNCE;
+	creating->notify = -1;
+
+#ifdef __linux__
+	// without inotify, such as when the instance limit is reached, files are polled instead
+	creating->notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+
+	*watch = creating;
+
+	return ERROR_NONE;
+}
+
+err_t watch_add(watch_t* watch, cstr path, watch_callback_t callback, ptr user)
+{
+	if (watch == NULL) return error_param_null("watch", __FILE__, __LINE__);
+	if (path == NULL) return error_param_null("path", __FILE__, __LINE__);
+	if (callback == NULL) return error_param_null("callback", __FILE__, __LINE__);
+
+	if (watch->count == watch->capacity)
+	{
+		u32 capacity = watch->capacity > 0 ? watch->capacity * 2 : 8;
+
+		watch_entry_t* entries = (watch_entry_t*)realloc(watch->entries, capacity * sizeof(watch_entry_t));
+
+		if (entries == NULL) return error_alloc_fail("watch_entry_t", capacity * sizeof(watch_entry_t), __FILE__, __LINE__);
+
+		watch->entries = entries;
+		watch->capacity = capacity;
+	}
+
+	u64 length = strlen(path);
+
+	watch_entry_t entry = { NULL, NULL, callback, user, -1, 0, 0, 0 };
+
+	// the directory is copied in front of the path, so both share one allocation
+	entry.path = (str)malloc(2 * length + 3);
+
+	if (entry.path == NULL) return error_alloc_fail("str", 2 * length + 3, __FILE__, __LINE__);
+
+	memcpy(entry.path, path, length + 1);
+
+	cstr separator = strrchr(entry.path, '/');
+
+#ifdef _WIN32
+	cstr backslash = strrchr(entry.path, '\\');
+
+	if (backslash != NULL && (separator == NULL || backslash > separator)) separator = backslash;
+#endif
+
+	entry.name = separator != NULL ? separator + 1 : entry.path;
+
+	watch_stamp(entry.path, &entry.modified, &entry.size);
+
+#ifdef __linux__
+	if (watch->notify >= 0)
+	{
+		str directory = entry.path + length + 1;
+
+		if (separator == NULL) memcpy(directory, ".", 2);
+		else
+		{
+			u64 directory_length = separator == entry.path ? 1 : (u64)(separator - entry.path);
+
+			memcpy(directory, entry.path, directory_length);
+			directory[directory_length] = '\0';
+		}
+
+		// editors save by writing in place or by renaming a new file over the old one, so both are watched; the directory is watched once however many files it holds
+		entry.descriptor = inotify_add_watch(watch->notify, directory, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+
+		if (entry.descriptor < 0)
+		{
+			err_t err = error_unopenable_file(directory, __FILE__, __LINE__);
+
+			free(entry.path);
+
+			return err;
+		}
+	}
+#endif
+
+	watch->entries[watch->count++] = entry;
+
+	return ERROR_NONE;
+}
+
+#ifdef __linux__
+/// <summary>
+/// reads every pending inotify event without blocking and marks the files they name as changed
+/// </summary>
+/// <param name="watch">- address of the watch</param>
+/// <param name="now">- clock reading to mark the files with</param>
+static void watch_read_events(watch_t* watch, u64 now)
+{
+	// aligned for inotify_event, and large enough for many events per read
+	u64 events[512];
+
+	forever
+	{
+		ssize_t length = read(watch->notify, events, sizeof(events));
+
+		if (length < 0 && errno == EINTR) continue;
+
+		if (length <= 0) break;
+
+		for (const byte* it = (const byte*)events; it < (const byte*)events + length;)
+		{
+			const struct inotify_event* event = (const struct inotify_event*)it;
+
+			for (u32 i = 0; i < watch->count; ++i)
+			{
+				watch_entry_t* entry = &watch->entries[i];
+
+				// an overflowed queue lost events, so every file is assumed changed
+				if (event->mask & IN_Q_OVERFLOW) entry->changed = now;
+				else if (event->len > 0 && entry->descriptor == event->wd && strcmp(entry->name, event->name) == 0) entry->changed = now;
+			}
+
+			it += sizeof(struct inotify_event) + event->len;
+		}
+	}
+}
+#endif
+
+/// <summary>
+/// compares the modification time and size of every polled file with the last poll and marks the ones that differ as changed
+/// </summary>
+/// <param name="watch">- address of the watch</param>
+/// <param name="now">- clock reading to mark the files with</param>
+static void watch_scan(watch_t* watch, u64 now)
+{
+	for (u32 i = 0; i < watch->count; ++i)
+	{
+		watch_entry_t* entry = &watch->entries[i];
+
+		if (entry->descriptor >= 0) continue;
+
+		i64 modified, size;
+
+		watch_stamp(entry->path, &modified, &size);
+
+		if (modified == entry->modified && size == entry->size) continue;
+
+		entry->modified = modified;
+		entry->size = size;
+		entry->changed = now;
+	}
+
+	watch->scanned = now;
+}
+
+err_t watch_poll(watch_t* watch)
+{
+	if (watch == NULL) return error_param_null("watch", __FILE__, __LINE__);
+
+	u64 now = watch_clock();
+
+#ifdef __linux__
+	if (watch->notify >= 0) watch_read_events(watch, now);
+#endif
+
+	if (now - watch->scanned >= WATCH_INTERVAL) watch_scan(watch, now);
+
+	err_t err = ERROR_NONE;
+
+	for (u32 i = 0; i < watch->count; ++i)
+	{
+		watch_entry_t* entry = &watch->entries[i];
+
+		// each change pushes the report back, so a file is reported once its writer has finished
+		if (entry->changed == 0 || now - entry->changed < watch->debounce) continue;
+
+		entry->changed = 0;
+
+		err_t callback_err = entry->callback(entry->path, entry->user);
+
+		if (err == ERROR_NONE) err = callback_err;
+	}
+
+	return err;
+}
+
+err_t watch_destroy(watch_t** watch)
+{
+	if (watch == NULL) return error_param_null("watch", __FILE__, __LINE__);
+	if (*watch == NULL) return error_param_null("*watch", __FILE__, __LINE__);
+
+	watch_t* destroying = *watch;
+
+	for (u32 i = 0; i < destroying->count; ++i) free(destroying->entries[i].path);
+
+#ifdef __linux__
+	// closing the instance removes every watch it holds
+	if (destroying->notify >= 0) close(destroying->notify);
+#endif
+
+	free(destroying->entries);
+	free(destroying);
+
+	*watch = NULL;
+
+	return ERROR_NONE;
+}
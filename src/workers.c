@@ -0,0 +1,259 @@
+#include "workers.h"
+
+#include "endian.h"
+#include "thread.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct workers_t
+{
+	struct thread_t** threads;
+	u32 count;
+
+	struct mutex_t* mutex;
+	// signalled when a loop is posted or the pool is stopping
+	struct condition_t* wake;
+	// signalled when a participant finishes a loop or the pool becomes free
+	struct condition_t* done;
+
+	// the loop being run, valid while busy
+	workers_task_t task;
+	ptr user;
+	u64 total;
+	u64 grain;
+	u64 next;
+	err_t err;
+
+	// participants, the caller included, that have not yet finished the current loop
+	u32 active;
+	// bumped for every loop so sleeping threads can tell a new one from a spurious wakeup
+	u64 generation;
+	i32 busy;
+	i32 stopping;
+} workers_t;
+
+/// <summary>
+/// claims and runs ranges of the current loop until none are left; called and returns with the mutex held
+/// </summary>
+/// <param name="workers">- address of the pool</param>
+static void workers_drain(workers_t* workers)
+{
+	while (workers->next < workers->total)
+	{
+		u64 begin = workers->next;
+		u64 end = workers->total - begin > workers->grain ? begin + workers->grain : workers->total;
+
+		workers->next = end;
+
+		mutex_unlock(workers->mutex);
+
+		err_t err = workers->task(begin, end, workers->user);
+
+		mutex_lock(workers->mutex);
+
+		if (err != ERROR_NONE && workers->err == ERROR_NONE)
+		{
+			// the first failure cancels every range not yet claimed
+			workers->err = err;
+			workers->next = workers->total;
+		}
+	}
+
+	if (--workers->active == 0) condition_broadcast(workers->done);
+}
+
+static err_t workers_entry(ptr user)
+{
+	workers_t* workers = (workers_t*)user;
+
+	// the pool is created at generation 0, so a loop posted before this thread first takes the mutex is still seen as new
+	u64 seen = 0;
+
+	mutex_lock(workers->mutex);
+
+	forever
+	{
+		while (!workers->stopping && workers->generation == seen) condition_wait(workers->wake, workers->mutex);
+
+		if (workers->stopping) break;
+
+		seen = workers->generation;
+
+		workers_drain(workers);
+	}
+
+	mutex_unlock(workers->mutex);
+
+	return ERROR_NONE;
+}
+
+err_t workers_create(workers_t** workers, u32 count)
+{
+	if (workers == NULL) return error_param_null("workers", __FILE__, __LINE__);
+	if (*workers != NULL) return error_param_notnull("*workers", __FILE__, __LINE__);
+
+	// the calling thread always takes part, so it counts towards the hardware threads
+	if (count == 0) count = thread_concurrency() > 1 ? thread_concurrency() - 1 : 1;
+
+	workers_t* creating = (workers_t*)calloc(1, sizeof(workers_t));
+
+	if (creating == NULL) return error_alloc_fail("workers_t", sizeof(workers_t), __FILE__, __LINE__);
+
+	creating->threads = (struct thread_t**)calloc(count, sizeof(struct thread_t*));
+
+	err_t err = creating->threads != NULL ? ERROR_NONE : error_alloc_fail("thread_t", count * sizeof(struct thread_t*), __FILE__, __LINE__);
+
+	if (err == ERROR_NONE) err = mutex_create(&creating->mutex);
+	if (err == ERROR_NONE) err = condition_create(&creating->wake);
+	if (err == ERROR_NONE) err = condition_create(&creating->done);
+
+	for (u32 i = 0; i < count && err == ERROR_NONE; ++i)
+	{
+		err = thread_create(&creating->threads[i], workers_entry, creating);
+
+		if (err == ERROR_NONE) ++creating->count;
+	}
+
+	if (err != ERROR_NONE)
+	{
+		// the threads that did start are stopped through the normal teardown
+		workers_destroy(&creating);
+
+		return err;
+	}
+
+	*workers = creating;
+
+	return ERROR_NONE;
+}
+
+err_t workers_parallel_for(workers_t* workers, u64 count, u64 grain, workers_task_t task, ptr user)
+{
+	if (task == NULL) return error_param_null("task", __FILE__, __LINE__);
+
+	if (grain == 0) grain = 1;
+
+	if (count == 0) return ERROR_NONE;
+
+	if (workers == NULL || workers->count == 0 || count <= grain)
+	{
+		for (u64 begin = 0; begin < count; begin += grain)
+		{
+			err_t err = task(begin, count - begin > grain ? begin + grain : count, user);
+
+			if (err != ERROR_NONE) return err;
+		}
+
+		return ERROR_NONE;
+	}
+
+	mutex_lock(workers->mutex);
+
+	while (workers->busy) condition_wait(workers->done, workers->mutex);
+
+	workers->busy = true;
+	workers->task = task;
+	workers->user = user;
+	workers->total = count;
+	workers->grain = grain;
+	workers->next = 0;
+	workers->err = ERROR_NONE;
+	workers->active = workers->count + 1;
+
+	++workers->generation;
+
+	condition_broadcast(workers->wake);
+
+	workers_drain(workers);
+
+	// every thread must check in before the loop's user data can go out of scope
+	while (workers->active > 0) condition_wait(workers->done, workers->mutex);
+
+	err_t err = workers->err;
+
+	workers->busy = false;
+
+	condition_broadcast(workers->done);
+
+	mutex_unlock(workers->mutex);
+
+	return err;
+}
+
+typedef struct workers_convert_t
+{
+	byte* dest;
+	const byte* src;
+	u64 width;
+	i32 swap;
+} workers_convert_t;
+
+static err_t workers_convert_range(u64 begin, u64 end, ptr user)
+{
+	const workers_convert_t* convert = (const workers_convert_t*)user;
+
+	byte* dest = convert->dest + begin * convert->width;
+	const byte* src = convert->src + begin * convert->width;
+
+	if (convert->swap) endian_swap_array(dest, src, convert->width, end - begin);
+	else if (dest != src) memcpy(dest, src, (end - begin) * convert->width);
+
+	return ERROR_NONE;
+}
+
+err_t workers_convert_array(workers_t* workers, mem dest, cmem src, u64 width, u64 count, i32 swap)
+{
+	if (dest == NULL) return error_param_null("dest", __FILE__, __LINE__);
+	if (src == NULL) return error_param_null("src", __FILE__, __LINE__);
+
+	workers_convert_t convert;
+
+	convert.dest = (byte*)dest;
+	convert.src = (const byte*)src;
+	convert.width = width > 0 ? width : 1;
+	convert.swap = swap;
+
+	// small arrays are not worth waking the pool for
+	if (convert.width * count < WORKERS_THRESHOLD_BYTES) return workers_convert_range(0, count, &convert);
+
+	return workers_parallel_for(workers, count, WORKERS_GRAIN_BYTES / convert.width, workers_convert_range, &convert);
+}
+
+err_t workers_destroy(workers_t** workers)
+{
+	if (workers == NULL) return error_param_null("workers", __FILE__, __LINE__);
+	if (*workers == NULL) return error_param_null("*workers", __FILE__, __LINE__);
+
+	workers_t* destroying = *workers;
+
+	err_t err = ERROR_NONE;
+
+	if (destroying->mutex != NULL)
+	{
+		mutex_lock(destroying->mutex);
+
+		destroying->stopping = true;
+
+		if (destroying->wake != NULL) condition_broadcast(destroying->wake);
+
+		mutex_unlock(destroying->mutex);
+	}
+
+	for (u32 i = 0; i < destroying->count; ++i)
+	{
+		err_t joined = thread_join(&destroying->threads[i], NULL);
+
+		if (err == ERROR_NONE) err = joined;
+	}
+
+	if (destroying->done != NULL) condition_destroy(&destroying->done);
+	if (destroying->wake != NULL) condition_destroy(&destroying->wake);
+	if (destroying->mutex != NULL) mutex_destroy(&destroying->mutex);
+
+	free(destroying->threads);
+	free(destroying);
+	*workers = NULL;
+
+	return err;
+}
@@ -0,0 +1,342 @@
+#include "writeback.h"
+
+#include "allocator.h"
+#include "thread.h"
+#include "writer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// <summary>one queued write, owning its buffer and both of its paths</summary>
+typedef struct writeback_job_t
+{
+	// path of the target, followed in the same allocation by the temporary path
+	str path;
+	str temporary;
+	mem buffer;
+	u64 length;
+	const struct allocator_t* allocator;
+	// set on a write overtaken by a later one to the same path in its batch, which is dropped unwritten
+	i32 superseded;
+	err_t err;
+} writeback_job_t;
+
+typedef struct writeback_t
+{
+	struct thread_t* thread;
+
+	struct mutex_t* mutex;
+	// signalled when a write is submitted or the queue is stopping
+	struct condition_t* wake;
+	// signalled when the thread finishes a batch
+	struct condition_t* idle;
+
+	// ring of queued writes not yet taken by the thread
+	writeback_job_t* jobs;
+	u32 capacity;
+	u32 head;
+	u32 count;
+
+	// writes taken by the thread and not yet finished
+	u32 writing;
+	// first failure since the last flush
+	err_t err;
+	i32 stopping;
+} writeback_t;
+
+/// <summary>
+/// fetches the length of the directory part of a path, separators of either kind included
+/// </summary>
+/// <param name="path">- path of a file</param>
+/// <returns>number of bytes up to and including the last separator, or 0 for a file in the working directory</returns>
+static u64 writeback_directory_length(cstr path)
+{
+	u64 length = 0;
+
+	for (u64 i = 0; path[i] != '\0'; ++i)
+	{
+		if (path[i] == '/' || path[i] == '\\') length = i + 1;
+	}
+
+	return length;
+}
+
+/// <summary>
+/// releases the buffer and paths of a write
+/// </summary>
+/// <param name="job">- address of the write</param>
+static void writeback_job_release(writeback_job_t* job)
+{
+	allocator_free(job->allocator, &job->buffer);
+
+	free(job->path);
+
+	job->path = NULL;
+	job->temporary = NULL;
+}
+
+/// <summary>
+/// carries out a batch of writes: every file is written under its temporary name first, then all are synced, renamed into place, and their directories synced once each, so the disk is waited on once per batch rather than once per write
+/// </summary>
+/// <param name="jobs">- writes of the batch in submission order</param>
+/// <param name="count">- number of writes</param>
+/// <returns>ERROR_NONE on success, or the first error a write met on failure</returns>
+static err_t writeback_batch(writeback_job_t* jobs, u32 count)
+{
+	for (u32 i = 0; i < count; ++i)
+	{
+		// the temporary name of a path is shared, so only the newest write to it may touch the disk
+		for (u32 j = i + 1; j < count && !jobs[i].superseded; ++j)
+		{
+			if (strcmp(jobs[i].path, jobs[j].path) == 0) jobs[i].superseded = true;
+		}
+
+		if (!jobs[i].superseded) jobs[i].err = writer_binary(jobs[i].temporary, (const byte*)jobs[i].buffer, jobs[i].length);
+
+		// the bytes are in the system cache once written, so the buffer is returned before the slow part
+		allocator_free(jobs[i].allocator, &jobs[i].buffer);
+	}
+
+	for (u32 i = 0; i < count; ++i)
+	{
+		if (!jobs[i].superseded && jobs[i].err == ERROR_NONE) jobs[i].err = writer_sync(jobs[i].temporary);
+	}
+
+	for (u32 i = 0; i < count; ++i)
+	{
+		if (jobs[i].superseded) continue;
+
+		if (jobs[i].err == ERROR_NONE) jobs[i].err = writer_replace(jobs[i].temporary, jobs[i].path);
+
+		// a failed write never replaces its target, and leaves no partial file behind
+		if (jobs[i].err != ERROR_NONE) remove(jobs[i].temporary);
+	}
+
+	for (u32 i = 0; i < count; ++i)
+	{
+		if (jobs[i].superseded || jobs[i].err != ERROR_NONE) continue;
+
+		u64 length = writeback_directory_length(jobs[i].path);
+
+		i32 synced = false;
+
+		for (u32 j = 0; j < i && !synced; ++j)
+		{
+			if (jobs[j].superseded || jobs[j].err != ERROR_NONE) continue;
+
+			synced = writeback_directory_length(jobs[j].path) == length && strncmp(jobs[i].path, jobs[j].path, length) == 0;
+		}
+
+		if (!synced) jobs[i].err = writer_sync_directory(jobs[i].path);
+	}
+
+	err_t err = ERROR_NONE;
+
+	for (u32 i = 0; i < count; ++i)
+	{
+		if (err == ERROR_NONE) err = jobs[i].err;
+
+		writeback_job_release(&jobs[i]);
+	}
+
+	return err;
+}
+
+static err_t writeback_entry(ptr user)
+{
+	writeback_t* writeback = (writeback_t*)user;
+
+	writeback_job_t batch[WRITEBACK_BATCH];
+
+	mutex_lock(writeback->mutex);
+
+	forever
+	{
+		while (!writeback->stopping && writeback->count == 0) condition_wait(writeback->wake, writeback->mutex);
+
+		// a stopping queue still finishes every write it accepted
+		if (writeback->count == 0) break;
+
+		u32 count = writeback->count < WRITEBACK_BATCH ? writeback->count : WRITEBACK_BATCH;
+
+		for (u32 i = 0; i < count; ++i)
+		{
+			batch[i] = writeback->jobs[(writeback->head + i) % writeback->capacity];
+		}
+
+		// the slots are handed back at once, so submitters are never held up by the disk
+		writeback->head = (writeback->head + count) % writeback->capacity;
+		writeback->count -= count;
+		writeback->writing = count;
+
+		mutex_unlock(writeback->mutex);
+
+		err_t err = writeback_batch(batch, count);
+
+		mutex_lock(writeback->mutex);
+
+		if (writeback->err == ERROR_NONE) writeback->err = err;
+
+		writeback->writing = 0;
+
+		condition_broadcast(writeback->idle);
+	}
+
+	mutex_unlock(writeback->mutex);
+
+	return ERROR_NONE;
+}
+
+err_t writeback_create(writeback_t** writeback, u32 capacity)
+{
+	if (writeback == NULL) return error_param_null("writeback", __FILE__, __LINE__);
+	if (*writeback != NULL) return error_param_notnull("*writeback", __FILE__, __LINE__);
+
+	if (capacity == 0) capacity = WRITEBACK_CAPACITY;
+
+	writeback_t* creating = (writeback_t*)calloc(1, sizeof(writeback_t));
+
+	if (creating == NULL) return error_alloc_fail("writeback_t", sizeof(writeback_t), __FILE__, __LINE__);
+
+	creating->capacity = capacity;
+	creating->jobs = (writeback_job_t*)calloc(capacity, sizeof(writeback_job_t));
+
+	err_t err = creating->jobs != NULL ? ERROR_NONE : error_alloc_fail("writeback_job_t", capacity * sizeof(writeback_job_t), __FILE__, __LINE__);
+
+	if (err == ERROR_NONE) err = mutex_create(&creating->mutex);
+	if (err == ERROR_NONE) err = condition_create(&creating->wake);
+	if (err == ERROR_NONE) err = condition_create(&creating->idle);
+	if (err == ERROR_NONE) err = thread_create(&creating->thread, writeback_entry, creating);
+
+	if (err != ERROR_NONE)
+	{
+		writeback_destroy(&creating);
+
+		return err;
+	}
+
+	*writeback = creating;
+
+	return ERROR_NONE;
+}
+
+err_t writeback_submit(writeback_t* writeback, cstr path, mem buffer, u64 length, const struct allocator_t* allocator)
+{
+	if (writeback == NULL) return error_param_null("writeback", __FILE__, __LINE__);
+	if (path == NULL) return error_param_null("path", __FILE__, __LINE__);
+	if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
+
+	u64 path_length = strlen(path);
+	u64 size = 2 * path_length + sizeof(WRITEBACK_SUFFIX) + 1;
+
+	// both paths are built before taking the lock, which is then held only to claim a slot
+	str paths = (str)malloc(size);
+
+	if (paths == NULL) return error_alloc_fail("str", size, __FILE__, __LINE__);
+
+	memcpy(paths, path, path_length + 1);
+	memcpy(paths + path_length + 1, path, path_length);
+	memcpy(paths + 2 * path_length + 1, WRITEBACK_SUFFIX, sizeof(WRITEBACK_SUFFIX));
+
+	mutex_lock(writeback->mutex);
+
+	if (writeback->count == writeback->capacity)
+	{
+		mutex_unlock(writeback->mutex);
+
+		free(paths);
+
+		return error_queue_full("writeback", __FILE__, __LINE__);
+	}
+
+	writeback_job_t* job = &writeback->jobs[(writeback->head + writeback->count) % writeback->capacity];
+
+	job->path = paths;
+	job->temporary = paths + path_length + 1;
+	job->buffer = buffer;
+	job->length = length;
+	job->allocator = allocator;
+	job->superseded = false;
+	job->err = ERROR_NONE;
+
+	++writeback->count;
+
+	condition_signal(writeback->wake);
+
+	mutex_unlock(writeback->mutex);
+
+	return ERROR_NONE;
+}
+
+u32 writeback_pending(writeback_t* writeback)
+{
+	if (writeback == NULL) return 0;
+
+	mutex_lock(writeback->mutex);
+
+	u32 pending = writeback->count + writeback->writing;
+
+	mutex_unlock(writeback->mutex);
+
+	return pending;
+}
+
+err_t writeback_flush(writeback_t* writeback)
+{
+	if (writeback == NULL) return error_param_null("writeback", __FILE__, __LINE__);
+
+	mutex_lock(writeback->mutex);
+
+	while (writeback->count > 0 || writeback->writing > 0) condition_wait(writeback->idle, writeback->mutex);
+
+	err_t err = writeback->err;
+
+	writeback->err = ERROR_NONE;
+
+	mutex_unlock(writeback->mutex);
+
+	return err;
+}
+
+err_t writeback_destroy(writeback_t** writeback)
+{
+	if (writeback == NULL) return error_param_null("writeback", __FILE__, __LINE__);
+	if (*writeback == NULL) return error_param_null("*writeback", __FILE__, __LINE__);
+
+	writeback_t* destroying = *writeback;
+
+	err_t err = ERROR_NONE;
+
+	if (destroying->thread != NULL)
+	{
+		mutex_lock(destroying->mutex);
+
+		destroying->stopping = true;
+
+		condition_signal(destroying->wake);
+
+		mutex_unlock(destroying->mutex);
+
+		err = thread_join(&destroying->thread, NULL);
+	}
+
+	if (err == ERROR_NONE) err = destroying->err;
+
+	// only a queue whose thread never started can still hold writes
+	for (u32 i = 0; i < destroying->count; ++i)
+	{
+		writeback_job_release(&destroying->jobs[(destroying->head + i) % destroying->capacity]);
+	}
+
+	if (destroying->idle != NULL) condition_destroy(&destroying->idle);
+	if (destroying->wake != NULL) condition_destroy(&destroying->wake);
+	if (destroying->mutex != NULL) mutex_destroy(&destroying->mutex);
+
+	free(destroying->jobs);
+	free(destroying);
+
+	*writeback = NULL;
+
+	return err;
+}
@@ -4,6 +4,29 @@
 #include <stdio.h>
 #include <string.h>
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#endif
+
+// largest number of bytes handed to the system in one call, well under the 32-bit and ssize_t limits
+#define WRITER_CHUNK_MAX ((u64)1 << 30)
+
+#ifndef _WIN32
+// number of segments gathered by each writev, capped by the system limit
+#if defined(IOV_MAX) && IOV_MAX < 64
+#define WRITER_VECTORS IOV_MAX
+#else
+#define WRITER_VECTORS 64
+#endif
+#endif
+
 err_t writer_string(cstr path, cstr content)
 {
 	FILE* ptr = NULL;
@@ -19,17 +42,201 @@ err_t writer_string(cstr path, cstr content)
 	return 0;
 }
 
-err_t writer_binary(cstr path, const byte* buffer)
+err_t writer_binary(cstr path, const byte* buffer, u64 length)
 {
-	FILE* ptr = NULL;
-
 	if (buffer == NULL) return error_param_null("buffer", __FILE__, __LINE__);
 
-	if (fopen_s(&ptr, path, "wb") != 0) return error_unopenable_file(path, __FILE__, __LINE__);
+	writer_segment_t segment = { buffer, length };
 
-	fwrite(buffer, BYTE_SIZE, sizeof(buffer) * BYTE_SIZE, ptr);
+	return writer_segments(path, &segment, 1);
+}
 
-	if (fclose(ptr) < 0) return error_uncloseable_file(path, __FILE__, __LINE__);
+err_t writer_segments(cstr path, const writer_segment_t* segments, u64 count)
+{
+	if (path == NULL) return error_param_null("path", __FILE__, __LINE__);
+	if (segments == NULL && count > 0) return error_param_null("segments", __FILE__, __LINE__);
 
-	return 0;
+	for (u64 i = 0; i < count; ++i)
+	{
+		if (segments[i].data == NULL && segments[i].size > 0) return error_param_null("segments[i].data", __FILE__, __LINE__);
+	}
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+
+	if (file == INVALID_HANDLE_VALUE) return error_unopenable_file(path, __FILE__, __LINE__);
+
+	// WriteFileGather needs unbuffered page-sized segments, so each segment is written from where it lies instead
+	for (u64 i = 0; i < count; ++i)
+	{
+		const byte* data = (const byte*)segments[i].data;
+		u64 remaining = segments[i].size;
+
+		while (remaining > 0)
+		{
+			DWORD chunk = (DWORD)(remaining < WRITER_CHUNK_MAX ? remaining : WRITER_CHUNK_MAX);
+			DWORD written = 0;
+
+			if (!WriteFile(file, data, chunk, &written, NULL) || written == 0)
+			{
+				CloseHandle(file);
+
+				return error_unwritable_file(path, __FILE__, __LINE__);
+			}
+
+			data += written;
+			remaining -= written;
+		}
+	}
+
+	if (!CloseHandle(file)) return error_uncloseable_file(path, __FILE__, __LINE__);
+#else
+	int file = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+	if (file < 0) return error_unopenable_file(path, __FILE__, __LINE__);
+
+	struct iovec vectors[WRITER_VECTORS];
+
+	// index of the first segment not yet fully written, and how much of it already was
+	u64 index = 0;
+	u64 done = 0;
+
+	forever
+	{
+		while (index < count && segments[index].size == done)
+		{
+			++index;
+			done = 0;
+		}
+
+		if (index == count) break;
+
+		int vector_count = 0;
+
+		for (u64 i = index; i < count && vector_count < WRITER_VECTORS; ++i)
+		{
+			u64 skip = i == index ? done : 0;
+			u64 size = segments[i].size - skip;
+
+			if (size == 0) continue;
+
+			vectors[vector_count].iov_base = (void*)((const byte*)segments[i].data + skip);
+			vectors[vector_count].iov_len = (size_t)(size < WRITER_CHUNK_MAX ? size : WRITER_CHUNK_MAX);
+
+			++vector_count;
+
+			// a clamped segment must finish before the next one may follow it
+			if (size > WRITER_CHUNK_MAX) break;
+		}
+
+		ssize_t written = writev(file, vectors, vector_count);
+
+		if (written < 0 && errno == EINTR) continue;
+
+		if (written <= 0)
+		{
+			close(file);
+
+			return error_unwritable_file(path, __FILE__, __LINE__);
+		}
+
+		// a short write resumes partway through whichever segment it stopped in
+		u64 remaining = (u64)written;
+
+		while (remaining > 0)
+		{
+			u64 left = segments[index].size - done;
+
+			if (remaining < left)
+			{
+				done += remaining;
+				remaining = 0;
+			}
+			else
+			{
+				remaining -= left;
+				++index;
+				done = 0;
+			}
+		}
+	}
+
+	if (close(file) != 0) return error_uncloseable_file(path, __FILE__, __LINE__);
+#endif
+
+	return ERROR_NONE;
+}
+
+err_t writer_sync(cstr path)
+{
+	if (path == NULL) return error_param_null("path", __FILE__, __LINE__);
+
+#ifdef _WIN32
+	// FlushFileBuffers needs write access, although nothing is written through the handle
+	HANDLE file = CreateFileA(path, GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if (file == INVALID_HANDLE_VALUE) return error_unopenable_file(path, __FILE__, __LINE__);
+
+	BOOL synced = FlushFileBuffers(file);
+
+	if (!CloseHandle(file)) return error_uncloseable_file(path, __FILE__, __LINE__);
+
+	if (!synced) return error_unwritable_file(path, __FILE__, __LINE__);
+#else
+	int file = open(path, O_RDONLY | O_CLOEXEC);
+
+	if (file < 0) return error_unopenable_file(path, __FILE__, __LINE__);
+
+	int synced = fsync(file);
+
+	if (close(file) != 0) return error_uncloseable_file(path, __FILE__, __LINE__);
+
+	if (synced != 0) return error_unwritable_file(path, __FILE__, __LINE__);
+#endif
+
+	return ERROR_NONE;
+}
+
+err_t writer_sync_directory(cstr path)
+{
+	if (path == NULL) return error_param_null("path", __FILE__, __LINE__);
+
+#ifdef _WIN32
+	// MoveFileExA is asked to write renames through, and windows cannot open a directory to flush it
+	return ERROR_NONE;
+#else
+	cstr separator = strrchr(path, '/');
+
+	if (separator == NULL) return writer_sync(".");
+
+	// the root directory is the only one whose path ends at its separator
+	u64 length = separator == path ? 1 : (u64)(separator - path);
+
+	str directory = (str)malloc(length + 1);
+
+	if (directory == NULL) return error_alloc_fail("str", length + 1, __FILE__, __LINE__);
+
+	memcpy(directory, path, length);
+	directory[length] = '\0';
+
+	err_t err = writer_sync(directory);
+
+	free(directory);
+
+	return err;
+#endif
+}
+
+err_t writer_replace(cstr from, cstr to)
+{
+	if (from == NULL) return error_param_null("from", __FILE__, __LINE__);
+	if (to == NULL) return error_param_null("to", __FILE__, __LINE__);
+
+#ifdef _WIN32
+	if (!MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) return error_unwritable_file(to, __FILE__, __LINE__);
+#else
+	if (rename(from, to) != 0) return error_unwritable_file(to, __FILE__, __LINE__);
+#endif
+
+	return ERROR_NONE;
 }